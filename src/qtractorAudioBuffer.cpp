@@ -24,6 +24,8 @@
 #include "qtractorAudioPeak.h"
 
 #include "qtractorTimeStretcher.h"
+#include "qtractorAudioStretchCache.h"
+#include "qtractorEpoch.h"
 
 #include "qtractorSession.h"
 #include "qtractorAudioEngine.h"
@@ -35,6 +37,245 @@
 #define QTRACTOR_RAMP_LENGTH	32
 
 
+#if defined(__SSE__)
+
+#include <xmmintrin.h>
+
+// SSE detection.
+static inline bool sse_enabled (void)
+{
+#if defined(__GNUC__)
+	unsigned int eax, ebx, ecx, edx;
+#if defined(__x86_64__) || (!defined(PIC) && !defined(__PIC__))
+	__asm__ __volatile__ (
+		"cpuid\n\t" \
+		: "=a" (eax), "=b" (ebx), "=c" (ecx), "=d" (edx) \
+		: "a" (1) : "cc");
+#else
+	__asm__ __volatile__ (
+		"push %%ebx\n\t" \
+		"cpuid\n\t" \
+		"movl %%ebx,%1\n\t" \
+		"pop %%ebx\n\t" \
+		: "=a" (eax), "=r" (ebx), "=c" (ecx), "=d" (edx) \
+		: "a" (1) : "cc");
+#endif
+	return (edx & (1 << 25));
+#else
+	return false;
+#endif
+}
+
+// SSE enabled mix-with-gain-ramp processor version.
+static inline void sse_mix_ramp ( float *pFrames, float *pBuffer,
+	unsigned int iFrames, float fGainIter, float fGainStep )
+{
+	for (; (long(pFrames) & 15) && (iFrames > 0); --iFrames) {
+		*pFrames++ += fGainIter * *pBuffer++;
+		fGainIter += fGainStep;
+	}
+
+	if (iFrames >= 4) {
+		__m128 v0 = _mm_setr_ps(fGainIter,
+			fGainIter + fGainStep,
+			fGainIter + 2.0f * fGainStep,
+			fGainIter + 3.0f * fGainStep);
+		const __m128 v1 = _mm_set1_ps(4.0f * fGainStep);
+		for (; iFrames >= 4; iFrames -= 4) {
+			_mm_store_ps(pFrames, _mm_add_ps(_mm_load_ps(pFrames),
+				_mm_mul_ps(_mm_loadu_ps(pBuffer), v0)));
+			v0 = _mm_add_ps(v0, v1);
+			pFrames += 4;
+			pBuffer += 4;
+		}
+		_mm_store_ss(&fGainIter, v0);
+	}
+
+	for (; iFrames > 0; --iFrames) {
+		*pFrames++ += fGainIter * *pBuffer++;
+		fGainIter += fGainStep;
+	}
+}
+
+// SSE enabled in-place gain-ramp processor version.
+static inline void sse_ramp ( float *pBuffer,
+	unsigned int iFrames, float fGainIter, float fGainStep )
+{
+	for (; (long(pBuffer) & 15) && (iFrames > 0); --iFrames) {
+		*pBuffer++ *= fGainIter;
+		fGainIter += fGainStep;
+	}
+
+	if (iFrames >= 4) {
+		__m128 v0 = _mm_setr_ps(fGainIter,
+			fGainIter + fGainStep,
+			fGainIter + 2.0f * fGainStep,
+			fGainIter + 3.0f * fGainStep);
+		const __m128 v1 = _mm_set1_ps(4.0f * fGainStep);
+		for (; iFrames >= 4; iFrames -= 4) {
+			_mm_store_ps(pBuffer, _mm_mul_ps(_mm_load_ps(pBuffer), v0));
+			v0 = _mm_add_ps(v0, v1);
+			pBuffer += 4;
+		}
+		_mm_store_ss(&fGainIter, v0);
+	}
+
+	for (; iFrames > 0; --iFrames) {
+		*pBuffer++ *= fGainIter;
+		fGainIter += fGainStep;
+	}
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#if (__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)
+#define CONFIG_AVX_MIX_RAMP 1
+#endif
+#endif
+
+#ifdef CONFIG_AVX_MIX_RAMP
+
+#include <immintrin.h>
+
+// AVX detection (runtime, as the build only assumes SSE).
+static inline bool avx_enabled (void)
+{
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx");
+}
+
+// AVX enabled mix-with-gain-ramp processor version.
+__attribute__((target("avx")))
+static void avx_mix_ramp ( float *pFrames, float *pBuffer,
+	unsigned int iFrames, float fGainIter, float fGainStep )
+{
+	for (; (long(pFrames) & 31) && (iFrames > 0); --iFrames) {
+		*pFrames++ += fGainIter * *pBuffer++;
+		fGainIter += fGainStep;
+	}
+
+	if (iFrames >= 8) {
+		__m256 v0 = _mm256_setr_ps(fGainIter,
+			fGainIter + fGainStep,
+			fGainIter + 2.0f * fGainStep,
+			fGainIter + 3.0f * fGainStep,
+			fGainIter + 4.0f * fGainStep,
+			fGainIter + 5.0f * fGainStep,
+			fGainIter + 6.0f * fGainStep,
+			fGainIter + 7.0f * fGainStep);
+		const __m256 v1 = _mm256_set1_ps(8.0f * fGainStep);
+		for (; iFrames >= 8; iFrames -= 8) {
+			_mm256_store_ps(pFrames, _mm256_add_ps(_mm256_load_ps(pFrames),
+				_mm256_mul_ps(_mm256_loadu_ps(pBuffer), v0)));
+			v0 = _mm256_add_ps(v0, v1);
+			pFrames += 8;
+			pBuffer += 8;
+		}
+		fGainIter = _mm_cvtss_f32(_mm256_castps256_ps128(v0));
+	}
+
+	for (; iFrames > 0; --iFrames) {
+		*pFrames++ += fGainIter * *pBuffer++;
+		fGainIter += fGainStep;
+	}
+}
+
+#endif // CONFIG_AVX_MIX_RAMP
+
+#endif // __SSE__
+
+
+#if defined(__ARM_NEON__)
+
+#include "arm_neon.h"
+
+// NEON enabled mix-with-gain-ramp processor version.
+static inline void neon_mix_ramp ( float *pFrames, float *pBuffer,
+	unsigned int iFrames, float fGainIter, float fGainStep )
+{
+	for (; (long(pFrames) & 15) && (iFrames > 0); --iFrames) {
+		*pFrames++ += fGainIter * *pBuffer++;
+		fGainIter += fGainStep;
+	}
+
+	if (iFrames >= 4) {
+		const float afGains[4] = {
+			fGainIter,
+			fGainIter + fGainStep,
+			fGainIter + 2.0f * fGainStep,
+			fGainIter + 3.0f * fGainStep };
+		float32x4_t v0 = vld1q_f32(afGains);
+		const float32x4_t v1 = vdupq_n_f32(4.0f * fGainStep);
+		for (; iFrames >= 4; iFrames -= 4) {
+			vst1q_f32(pFrames,
+				vmlaq_f32(vld1q_f32(pFrames), vld1q_f32(pBuffer), v0));
+			v0 = vaddq_f32(v0, v1);
+			pFrames += 4;
+			pBuffer += 4;
+		}
+		fGainIter = vgetq_lane_f32(v0, 0);
+	}
+
+	for (; iFrames > 0; --iFrames) {
+		*pFrames++ += fGainIter * *pBuffer++;
+		fGainIter += fGainStep;
+	}
+}
+
+// NEON enabled in-place gain-ramp processor version.
+static inline void neon_ramp ( float *pBuffer,
+	unsigned int iFrames, float fGainIter, float fGainStep )
+{
+	for (; (long(pBuffer) & 15) && (iFrames > 0); --iFrames) {
+		*pBuffer++ *= fGainIter;
+		fGainIter += fGainStep;
+	}
+
+	if (iFrames >= 4) {
+		const float afGains[4] = {
+			fGainIter,
+			fGainIter + fGainStep,
+			fGainIter + 2.0f * fGainStep,
+			fGainIter + 3.0f * fGainStep };
+		float32x4_t v0 = vld1q_f32(afGains);
+		const float32x4_t v1 = vdupq_n_f32(4.0f * fGainStep);
+		for (; iFrames >= 4; iFrames -= 4) {
+			vst1q_f32(pBuffer, vmulq_f32(vld1q_f32(pBuffer), v0));
+			v0 = vaddq_f32(v0, v1);
+			pBuffer += 4;
+		}
+		fGainIter = vgetq_lane_f32(v0, 0);
+	}
+
+	for (; iFrames > 0; --iFrames) {
+		*pBuffer++ *= fGainIter;
+		fGainIter += fGainStep;
+	}
+}
+
+#endif // __ARM_NEON__
+
+
+// Standard mix-with-gain-ramp processor version.
+static inline void std_mix_ramp ( float *pFrames, float *pBuffer,
+	unsigned int iFrames, float fGainIter, float fGainStep )
+{
+	for (; iFrames > 0; --iFrames) {
+		*pFrames++ += fGainIter * *pBuffer++;
+		fGainIter += fGainStep;
+	}
+}
+
+// Standard in-place gain-ramp processor version.
+static inline void std_ramp ( float *pBuffer,
+	unsigned int iFrames, float fGainIter, float fGainStep )
+{
+	for (; iFrames > 0; --iFrames) {
+		*pBuffer++ *= fGainIter;
+		fGainIter += fGainStep;
+	}
+}
+
+
 //----------------------------------------------------------------------
 // class qtractorAudioBufferThread -- Ring-cache manager thread.
 //
@@ -47,9 +288,14 @@ qtractorAudioBufferThread::qtractorAudioBufferThread (
 	while (m_iSyncSize < iSyncSize)
 		m_iSyncSize <<= 1;
 	m_iSyncMask = (m_iSyncSize - 1);
-	m_ppSyncItems = new qtractorAudioBuffer * [m_iSyncSize];
+	m_ppSyncItems = new QAtomicPointer<qtractorAudioBuffer> [m_iSyncSize];
 	m_iSyncRead   = 0;
-	m_iSyncWrite  = 0;
+	ATOMIC_SET(&m_iSyncWrite, 0);
+
+	m_ppSyncBatch = new qtractorAudioBuffer * [m_iSyncSize];
+	m_piSyncHeadroom = new unsigned int [m_iSyncSize];
+
+	m_iSyncRefs = 0;
 
 	m_bRunState = false;
 }
@@ -63,6 +309,8 @@ qtractorAudioBufferThread::~qtractorAudioBufferThread (void)
 		sync();
 	} while (!wait(100));
 
+	delete [] m_piSyncHeadroom;
+	delete [] m_ppSyncBatch;
 	delete [] m_ppSyncItems;
 }
 
@@ -85,30 +333,31 @@ void qtractorAudioBufferThread::sync ( qtractorAudioBuffer *pAudioBuffer )
 {
 	if (pAudioBuffer == NULL) {
 		unsigned int r = m_iSyncRead;
-		unsigned int w = m_iSyncWrite;
+		unsigned int w = ATOMIC_GET(&m_iSyncWrite);
 		while (r != w) {
-			m_ppSyncItems[r]->setSyncFlag(qtractorAudioBuffer::WaitSync, false);
+			// Stop short on a slot claimed but not filled in yet...
+			qtractorAudioBuffer *pSyncItem = qtractorEpoch::fetch(m_ppSyncItems[r]);
+			if (pSyncItem == NULL)
+				break;
+			pSyncItem->setSyncFlag(qtractorAudioBuffer::WaitSync, false);
+			m_ppSyncItems[r].fetchAndStoreRelaxed(NULL);
 			++r &= m_iSyncMask;
-			w = m_iSyncWrite;
+			w = ATOMIC_GET(&m_iSyncWrite);
 		}
 		m_iSyncRead = r;
 	} else {
 		// !pAudioBuffer->isSyncFlag(qtractorAudioBuffer::WaitSync)
-		unsigned int n;
-		unsigned int r = m_iSyncRead;
-		unsigned int w = m_iSyncWrite;
-		if (w > r) {
-			n = ((r - w + m_iSyncSize) & m_iSyncMask) - 1;
-		} else if (r > w) {
-			n = (r - w) - 1;
-		} else {
-			n = m_iSyncSize - 1;
-		}
-		if (n > 0) {
-			pAudioBuffer->setSyncFlag(qtractorAudioBuffer::WaitSync);
-			m_ppSyncItems[w] = pAudioBuffer;
-			m_iSyncWrite = (w + 1) & m_iSyncMask;
-		}
+		// Several graph workers may get here concurrently:
+		// claim a free slot first, then fill it in.
+		unsigned int w;
+		do {
+			const unsigned int r = m_iSyncRead;
+			w = ATOMIC_GET(&m_iSyncWrite);
+			if (((w + 1) & m_iSyncMask) == r)
+				return; // Full.
+		} while (!ATOMIC_CAS(&m_iSyncWrite, w, (w + 1) & m_iSyncMask));
+		pAudioBuffer->setSyncFlag(qtractorAudioBuffer::WaitSync);
+		m_ppSyncItems[w].fetchAndStoreRelease(pAudioBuffer);
 	}
 
 	if (m_mutex.tryLock()) {
@@ -160,36 +409,142 @@ void qtractorAudioBufferThread::run (void)
 void qtractorAudioBufferThread::process (void)
 {
 	unsigned int r = m_iSyncRead;
-	unsigned int w = m_iSyncWrite;
+	unsigned int w = ATOMIC_GET(&m_iSyncWrite);
 
 	while (r != w) {
-		m_ppSyncItems[r]->sync();
-		++r &= m_iSyncMask;
-		w = m_iSyncWrite;
+		// Take current batch, sorted by distance-to-underrun...
+		unsigned int n = 0;
+		while (r != w) {
+			// Stop short on a slot claimed but not filled in yet...
+			qtractorAudioBuffer *pAudioBuffer = qtractorEpoch::fetch(m_ppSyncItems[r]);
+			if (pAudioBuffer == NULL)
+				break;
+			m_ppSyncItems[r].fetchAndStoreRelaxed(NULL);
+			const unsigned int iHeadroom = pAudioBuffer->syncHeadroom();
+			unsigned int i = n++;
+			for ( ; i > 0 && m_piSyncHeadroom[i - 1] > iHeadroom; --i) {
+				m_ppSyncBatch[i] = m_ppSyncBatch[i - 1];
+				m_piSyncHeadroom[i] = m_piSyncHeadroom[i - 1];
+			}
+			m_ppSyncBatch[i] = pAudioBuffer;
+			m_piSyncHeadroom[i] = iHeadroom;
+			++r &= m_iSyncMask;
+		}
+		// Most urgent first...
+		for (unsigned int i = 0; i < n; ++i)
+			m_ppSyncBatch[i]->sync();
+		m_iSyncRead = r;
+		if (n < 1)
+			break;
+		w = ATOMIC_GET(&m_iSyncWrite);
 	}
-
-	m_iSyncRead = r;
 }
 
 
 // Conditional resize check.
 void qtractorAudioBufferThread::checkSyncSize ( unsigned int iSyncSize )
 {
+	// Shared threads serve as many clients...
+	if (m_iSyncRefs > 1)
+		iSyncSize *= m_iSyncRefs;
+
 	if (iSyncSize > (m_iSyncSize - 4)) {
 		QMutexLocker locker(&m_mutex);
 		unsigned int iNewSyncSize = (m_iSyncSize << 1);
 		while (iNewSyncSize < iSyncSize)
 			iNewSyncSize <<= 1;
-		qtractorAudioBuffer **ppNewSyncItems
-			= new qtractorAudioBuffer * [iNewSyncSize];
-		qtractorAudioBuffer **ppOldSyncItems = m_ppSyncItems;
-		::memcpy(ppNewSyncItems, ppOldSyncItems,
-			m_iSyncSize * sizeof(qtractorAudioBuffer *));
+		QAtomicPointer<qtractorAudioBuffer> *ppNewSyncItems
+			= new QAtomicPointer<qtractorAudioBuffer> [iNewSyncSize];
+		QAtomicPointer<qtractorAudioBuffer> *ppOldSyncItems = m_ppSyncItems;
+		// Pending requests move to the front of the new ring...
+		unsigned int r = m_iSyncRead;
+		const unsigned int w = ATOMIC_GET(&m_iSyncWrite);
+		unsigned int n = 0;
+		while (r != w) {
+			ppNewSyncItems[n++].fetchAndStoreRelaxed(qtractorEpoch::fetch(ppOldSyncItems[r]));
+			++r &= m_iSyncMask;
+		}
 		m_iSyncSize = iNewSyncSize;
 		m_iSyncMask = (iNewSyncSize - 1);
 		m_ppSyncItems = ppNewSyncItems;
+		m_iSyncRead = 0;
+		ATOMIC_SET(&m_iSyncWrite, n);
 		delete [] ppOldSyncItems;
+		delete [] m_ppSyncBatch;
+		m_ppSyncBatch = new qtractorAudioBuffer * [iNewSyncSize];
+		delete [] m_piSyncHeadroom;
+		m_piSyncHeadroom = new unsigned int [iNewSyncSize];
+	}
+}
+
+
+// Shared thread pool.
+unsigned int qtractorAudioBufferThread::g_iDefaultSyncThreads = 0;
+
+QList<qtractorAudioBufferThread *> qtractorAudioBufferThread::g_syncThreads;
+
+
+// Shared thread pool reference management (non RT-safe).
+qtractorAudioBufferThread *qtractorAudioBufferThread::acquireSyncThread (void)
+{
+	qtractorAudioBufferThread *pSyncThread = NULL;
+
+	if (g_iDefaultSyncThreads > 0) {
+		// Pick the least shared one, unless the pool isn't full yet...
+		if (g_syncThreads.count() >= int(g_iDefaultSyncThreads)) {
+			QListIterator<qtractorAudioBufferThread *> iter(g_syncThreads);
+			while (iter.hasNext()) {
+				qtractorAudioBufferThread *pThread = iter.next();
+				if (pSyncThread == NULL
+					|| pSyncThread->m_iSyncRefs > pThread->m_iSyncRefs)
+					pSyncThread = pThread;
+			}
+		}
+		if (pSyncThread == NULL) {
+			pSyncThread = new qtractorAudioBufferThread();
+			pSyncThread->start(QThread::HighPriority);
+			g_syncThreads.append(pSyncThread);
+		}
+	} else {
+		// One dedicated thread...
+		pSyncThread = new qtractorAudioBufferThread();
+		pSyncThread->start(QThread::HighPriority);
 	}
+
+	++(pSyncThread->m_iSyncRefs);
+
+	return pSyncThread;
+}
+
+
+void qtractorAudioBufferThread::releaseSyncThread (
+	qtractorAudioBufferThread *pSyncThread )
+{
+	if (pSyncThread->m_iSyncRefs > 0
+		&& --(pSyncThread->m_iSyncRefs) > 0)
+		return;
+
+	g_syncThreads.removeAll(pSyncThread);
+
+	if (pSyncThread->isRunning()) do {
+		pSyncThread->setRunState(false);
+	//	pSyncThread->terminate();
+		pSyncThread->sync();
+	} while (!pSyncThread->wait(100));
+
+	delete pSyncThread;
+}
+
+
+// Shared thread pool size (0=one dedicated thread per client).
+void qtractorAudioBufferThread::setDefaultSyncThreads ( unsigned int iSyncThreads )
+{
+	g_iDefaultSyncThreads = iSyncThreads;
+}
+
+unsigned int qtractorAudioBufferThread::defaultSyncThreads (void)
+{
+	return g_iDefaultSyncThreads;
 }
 
 
@@ -248,6 +603,29 @@ qtractorAudioBuffer::qtractorAudioBuffer (
 	m_fNextGain      = 0.0f;
 	m_iRampGain      = 0;
 
+	// Mix-with-gain-ramp kernels, fastest available first.
+#if defined(__SSE__)
+	if (sse_enabled()) {
+	#ifdef CONFIG_AVX_MIX_RAMP
+		if (avx_enabled())
+			m_pfnMixRamp = avx_mix_ramp;
+		else
+	#endif
+		m_pfnMixRamp = sse_mix_ramp;
+		m_pfnRamp = sse_ramp;
+	}
+	else
+#endif
+#if defined(__ARM_NEON__)
+	m_pfnMixRamp = neon_mix_ramp;
+	m_pfnRamp = neon_ramp;
+	if (false)
+#endif
+	{
+		m_pfnMixRamp = std_mix_ramp;
+		m_pfnRamp = std_ramp;
+	}
+
 #ifdef CONFIG_LIBSAMPLERATE
 	m_bResample      = false;
 	m_fResampleRatio = 1.0f;
@@ -259,9 +637,23 @@ qtractorAudioBuffer::qtractorAudioBuffer (
 
 	m_pPeakFile      = NULL;
 
+	m_iMinHeadroom   = 0;
+	m_iUnderruns     = 0;
+	m_iDroppedFrames = 0;
+
+	m_iPageFileId    = 0;
+	m_iPageOffset    = 0;
+	m_iPageFilePos   = 0;
+	m_pPage          = NULL;
+
+	m_bStretchCache  = true;
+	m_iStretchId     = 0;
+	m_pStretchFile   = NULL;
+
 	// Time-stretch mode local options.
 	m_bWsolaTimeStretch = g_bDefaultWsolaTimeStretch;
 	m_bWsolaQuickSeek   = g_bDefaultWsolaQuickSeek;
+	m_bWsolaFastSeek    = g_bDefaultWsolaFastSeek;
 
 }
 
@@ -347,6 +739,15 @@ bool qtractorAudioBuffer::open ( const QString& sFilename, int iMode )
 		return false;
 	}
 
+	// Read-only files may go through the shared page cache...
+	qtractorAudioPageCache *pPageCache = qtractorAudioPageCache::getInstance();
+	if (pPageCache->maxSize() > 0 && m_pFile->mode() == qtractorAudioFile::Read) {
+		m_iPageFileId = pPageCache->fileId(sFilename,
+			iBuffers, m_pFile->sampleRate());
+		m_iPageOffset = 0;
+		m_iPageFilePos = 0;
+	}
+
 #ifdef CONFIG_LIBSAMPLERATE
 	// Compute sample rate converter stuff.
 	m_iInputPending  = 0;
@@ -369,8 +770,15 @@ bool qtractorAudioBuffer::open ( const QString& sFilename, int iMode )
 			m_iOffset = 0;
 	}
 
+	// Capture files get a larger ring-buffer and write
+	// out whole sync thresholds at once (coalesced writes)...
+	const bool bWrite = (m_pFile->mode() & qtractorAudioFile::Write);
+
 	// Allocate ring-buffer now.
 	unsigned int iBufferSize = m_iLength;
+	if (bWrite)
+		iBufferSize = (iSampleRate << 1);
+	else
 	if (iBufferSize == 0)
 		iBufferSize = (iSampleRate >> 1);
 	else
@@ -379,7 +787,9 @@ bool qtractorAudioBuffer::open ( const QString& sFilename, int iMode )
 
 	m_pRingBuffer = new qtractorRingBuffer<float> (iBuffers, iBufferSize);
 	m_iThreshold  = (m_pRingBuffer->bufferSize() >> 2);
-	m_iBufferSize = (m_iThreshold >> 2);
+	m_iBufferSize = (bWrite ? m_iThreshold : (m_iThreshold >> 2));
+
+	resetSyncStats();
 
 #ifdef CONFIG_LIBSAMPLERATE
 	if (m_bResample && m_fResampleRatio < 1.0f) {
@@ -403,8 +813,16 @@ bool qtractorAudioBuffer::open ( const QString& sFilename, int iMode )
 			iFlags |= qtractorTimeStretcher::WsolaTimeStretch;
 		if (m_bWsolaQuickSeek)
 			iFlags |= qtractorTimeStretcher::WsolaQuickSeek;
+		if (m_bWsolaFastSeek)
+			iFlags |= qtractorTimeStretcher::WsolaFastSeek;
 		m_pTimeStretcher = new qtractorTimeStretcher(iBuffers, iSampleRate,
 			m_fTimeStretch, m_fPitchShift, iFlags, m_iBufferSize);
+		// Have it pre-rendered in the background, if applicable...
+		if (m_bStretchCache && m_pFile->mode() == qtractorAudioFile::Read) {
+			m_iStretchId = qtractorAudioStretchCache::getInstance()->request(
+				sFilename, m_iChannels, iSampleRate,
+				m_fTimeStretch, m_fPitchShift, iFlags);
+		}
 	}
 
 #ifdef CONFIG_LIBSAMPLERATE
@@ -420,7 +838,7 @@ bool qtractorAudioBuffer::open ( const QString& sFilename, int iMode )
 #endif
 
 	// Consider it done when recording...
-	if (m_pFile->mode() & qtractorAudioFile::Write) {
+	if (bWrite) {
 		setSyncFlag(InitSync);
 	} else {
 		// Get a reasonablebuffer size for readMix()...
@@ -514,6 +932,27 @@ void qtractorAudioBuffer::close (void)
 		m_pRingBuffer = NULL;
 	}
 
+	// Release any shared cache page (and file).
+	releasePage();
+
+	if (m_iPageFileId)
+		qtractorAudioPageCache::getInstance()->releaseFileId(m_iPageFileId);
+
+	m_iPageFileId = 0;
+	m_iPageOffset = 0;
+	m_iPageFilePos = 0;
+
+	// Release any pre-rendered time-stretch file.
+	if (m_pStretchFile) {
+		delete m_pStretchFile;
+		m_pStretchFile = NULL;
+	}
+
+	if (m_iStretchId) {
+		qtractorAudioStretchCache::getInstance()->release(m_iStretchId);
+		m_iStretchId = 0;
+	}
+
 	// Finally delete what we still own.
 	if (m_pFile) {
 		delete m_pFile;
@@ -688,6 +1127,15 @@ int qtractorAudioBuffer::write ( float **ppFrames, unsigned int iFrames,
 	// Make it statiscally correct...
 	m_iWriteOffset += nwrite;
 
+	// Starvation statistics (overruns, as we're capturing)...
+	if (nwrite < iFrames) {
+		m_iDroppedFrames += (iFrames - nwrite);
+		++m_iUnderruns;
+	}
+	const unsigned int ws = m_pRingBuffer->writable();
+	if (m_iMinHeadroom > ws)
+		m_iMinHeadroom = ws;
+
 	// Time to sync()?
 	if (m_pSyncThread && m_pRingBuffer->readable() > m_iThreshold)
 		m_pSyncThread->sync(this);
@@ -767,6 +1215,15 @@ int qtractorAudioBuffer::readMix ( float **ppFrames, unsigned int iFrames,
 	// Mix the (remaining) data around...
 	nread = readMixFrames(ppFrames, iFrames, iChannels, iOffset, fGain);
 	m_iReadOffset = (ro + nread);
+
+	// Starvation statistics...
+	if (!m_bIntegral) {
+		if (nread < int(iFrames) && ro + iFrames < re)
+			++m_iUnderruns;
+		const unsigned int rs = m_pRingBuffer->readable();
+		if (m_iMinHeadroom > rs)
+			m_iMinHeadroom = rs;
+	}
 	if (m_iReadOffset >= re) {
 		// Force out-of-sync...
 		setSyncFlag(ReadSync, false);
@@ -961,6 +1418,8 @@ void qtractorAudioBuffer::sync (void)
 		if (mode & qtractorAudioFile::Write)
 			writeSync();
 		if (isSyncFlag(CloseSync)) {
+			if (m_pStretchFile)
+				m_pStretchFile->close();
 			m_pFile->close();
 			setSyncFlag(CloseSync, false);
 		}
@@ -1140,7 +1599,66 @@ bool qtractorAudioBuffer::seekSync ( unsigned long iFrame )
 	if (m_pTimeStretcher)
 		m_pTimeStretcher->reset();
 
-	return m_pFile->seek(framesOut(iFrame));
+	// Time to switch over to pre-rendered time-stretch?
+	if (m_iStretchId && m_pStretchFile == NULL)
+		openStretchFile();
+
+	// Pre-rendered frames are already on the output timeline...
+	const unsigned long iOffset
+		= (m_pStretchFile ? iFrame : framesOut(iFrame));
+
+	// Page cached reads just need to know where...
+	if (m_iPageFileId) {
+		m_iPageOffset = iOffset;
+		return true;
+	}
+
+	return (m_pStretchFile ? m_pStretchFile : m_pFile)->seek(iOffset);
+}
+
+
+// Switch over to the pre-rendered time-stretch cache, if ready.
+bool qtractorAudioBuffer::openStretchFile (void)
+{
+	qtractorAudioStretchCache *pStretchCache
+		= qtractorAudioStretchCache::getInstance();
+	const QString& sStretchFile = pStretchCache->readyFile(m_iStretchId);
+	if (sStretchFile.isEmpty())
+		return false;
+
+	const unsigned short iBuffers = m_pRingBuffer->channels();
+	const unsigned int iSampleRate = m_pFile->sampleRate();
+
+	qtractorAudioFile *pStretchFile
+		= qtractorAudioFileFactory::createAudioFile(
+			sStretchFile, iBuffers, iSampleRate);
+	if (pStretchFile == NULL) {
+		pStretchCache->release(m_iStretchId);
+		m_iStretchId = 0;
+		return false;
+	}
+
+	if (!pStretchFile->open(sStretchFile)
+		|| pStretchFile->channels() != iBuffers) {
+		delete pStretchFile;
+		pStretchCache->release(m_iStretchId);
+		m_iStretchId = 0;
+		return false;
+	}
+
+	// Pre-rendered files may go through the shared page cache too...
+	if (m_iPageFileId) {
+		releasePage();
+		qtractorAudioPageCache *pPageCache
+			= qtractorAudioPageCache::getInstance();
+		pPageCache->releaseFileId(m_iPageFileId);
+		m_iPageFileId = pPageCache->fileId(
+			sStretchFile, iBuffers, pStretchFile->sampleRate());
+		m_iPageFilePos = 0;
+	}
+
+	m_pStretchFile = pStretchFile;
+	return true;
 }
 
 
@@ -1148,8 +1666,8 @@ bool qtractorAudioBuffer::seekSync ( unsigned long iFrame )
 int qtractorAudioBuffer::writeFrames (
 	float **ppFrames, unsigned int iFrames )
 {
-	// Time-stretch processing...
-	if (m_pTimeStretcher) {
+	// Time-stretch processing (unless pre-rendered)...
+	if (m_pTimeStretcher && m_pStretchFile == NULL) {
 		int nread = 0;
 		m_pTimeStretcher->process(ppFrames, iFrames);
 		unsigned int nwrite = m_pRingBuffer->writable();
@@ -1181,8 +1699,8 @@ int qtractorAudioBuffer::flushFrames ( float **ppFrames, unsigned int iFrames )
 {
 	int nread = 0;
 
-	// Flush time-stretch processing...
-	if (m_pTimeStretcher) {
+	// Flush time-stretch processing (unless pre-rendered)...
+	if (m_pTimeStretcher && m_pStretchFile == NULL) {
 		m_pTimeStretcher->flush();
 		unsigned int nwrite = m_pRingBuffer->writable();
 		unsigned int nahead = m_pTimeStretcher->available();
@@ -1224,10 +1742,10 @@ int qtractorAudioBuffer::readBuffer ( unsigned int iFrames )
 	int nread = 0;
 
 #ifdef CONFIG_LIBSAMPLERATE
-	if (m_bResample) {
+	if (m_bResample && m_pStretchFile == NULL) {
 
 		if (iFrames > m_iInputPending)
-			nread = m_pFile->read(m_ppInBuffer, iFrames - m_iInputPending);
+			nread = readFile(m_ppInBuffer, iFrames - m_iInputPending);
 
 		nread += m_iInputPending;
 
@@ -1270,7 +1788,7 @@ int qtractorAudioBuffer::readBuffer ( unsigned int iFrames )
 	} else {
 #endif   // CONFIG_LIBSAMPLERATE
 
-		nread = m_pFile->read(m_ppFrames, iFrames);
+		nread = readFile(m_ppFrames, iFrames);
 		if (nread > 0)
 			nread = writeFrames(m_ppFrames, nread);
 		else
@@ -1302,6 +1820,133 @@ int qtractorAudioBuffer::writeBuffer ( unsigned int iFrames )
 }
 
 
+// Frames left before starving (sync priority).
+unsigned int qtractorAudioBuffer::syncHeadroom (void) const
+{
+	if (m_pRingBuffer == NULL || m_pFile == NULL)
+		return 0;
+
+	if (!isSyncFlag(InitSync))
+		return 0;
+
+	if (m_pFile->mode() & qtractorAudioFile::Write)
+		return m_pRingBuffer->writable();
+
+	if (m_bIntegral)
+		return m_pRingBuffer->bufferSize();
+
+	return m_pRingBuffer->readable();
+}
+
+
+// Starvation statistics.
+unsigned int qtractorAudioBuffer::minHeadroom (void) const
+{
+	return m_iMinHeadroom;
+}
+
+unsigned int qtractorAudioBuffer::underruns (void) const
+{
+	return m_iUnderruns;
+}
+
+// Capture statistics (write-mode fill-level telemetry).
+unsigned long qtractorAudioBuffer::droppedFrames (void) const
+{
+	return m_iDroppedFrames;
+}
+
+unsigned int qtractorAudioBuffer::fillLevel (void) const
+{
+	if (m_pRingBuffer == NULL)
+		return 0;
+
+	return (100 * m_pRingBuffer->readable()) / m_pRingBuffer->bufferSize();
+}
+
+unsigned int qtractorAudioBuffer::maxFillLevel (void) const
+{
+	if (m_pRingBuffer == NULL)
+		return 0;
+
+	const unsigned int iBufferSize = m_pRingBuffer->bufferSize();
+	if (m_iMinHeadroom > iBufferSize)
+		return 0;
+
+	return (100 * (iBufferSize - m_iMinHeadroom)) / iBufferSize;
+}
+
+void qtractorAudioBuffer::resetSyncStats (void)
+{
+	m_iMinHeadroom = (m_pRingBuffer ? m_pRingBuffer->bufferSize() : 0);
+	m_iUnderruns = 0;
+	m_iDroppedFrames = 0;
+}
+
+
+// File read through the shared decoded page cache, if any.
+int qtractorAudioBuffer::readFile ( float **ppFrames, unsigned int iFrames )
+{
+	qtractorAudioFile *pFile = (m_pStretchFile ? m_pStretchFile : m_pFile);
+
+	qtractorAudioPageCache *pPageCache = qtractorAudioPageCache::getInstance();
+
+	// Page cache disabled meanwhile? go straight from now on...
+	if (m_iPageFileId && pPageCache->maxSize() < 1) {
+		releasePage();
+		pPageCache->releaseFileId(m_iPageFileId);
+		m_iPageFileId = 0;
+		if (m_iPageFilePos != m_iPageOffset && !pFile->seek(m_iPageOffset))
+			return 0;
+	}
+
+	if (m_iPageFileId == 0)
+		return pFile->read(ppFrames, iFrames);
+
+	const unsigned int iPageFrames = pPageCache->pageFrames();
+	const unsigned short iBuffers = m_pRingBuffer->channels();
+
+	unsigned int nread = 0;
+
+	while (nread < iFrames) {
+		// Make sure we're on the right page...
+		const unsigned long iPage = m_iPageOffset / iPageFrames;
+		if (m_pPage == NULL || m_pPage->index != iPage) {
+			releasePage();
+			m_pPage = pPageCache->acquirePage(
+				pFile, m_iPageFileId, iPage, m_iPageFilePos);
+			if (m_pPage == NULL)
+				break;
+		}
+		// Past end-of-file?
+		const unsigned int iOffset = m_iPageOffset - iPage * iPageFrames;
+		if (iOffset >= m_pPage->frames)
+			break;
+		unsigned int nahead = m_pPage->frames - iOffset;
+		if (nahead > iFrames - nread)
+			nahead = iFrames - nread;
+		for (unsigned short i = 0; i < iBuffers; ++i) {
+			::memcpy(ppFrames[i] + nread,
+				m_pPage->buffers[i] + iOffset, nahead * sizeof(float));
+		}
+		m_iPageOffset += nahead;
+		nread += nahead;
+	}
+
+	return nread;
+}
+
+
+// Release current shared cache page, if any.
+void qtractorAudioBuffer::releasePage (void)
+{
+	if (m_pPage) {
+		qtractorAudioPageCache::getInstance()->releasePage(m_pPage);
+		m_pPage = NULL;
+	}
+}
+
+
 // Special kind of super-read/channel-mix buffer helper.
 int qtractorAudioBuffer::readMixFrames (
 	float **ppFrames, unsigned int iFrames, unsigned short iChannels,
@@ -1316,7 +1961,7 @@ int qtractorAudioBuffer::readMixFrames (
 
 	const unsigned short iBuffers = m_pRingBuffer->channels();
 
-	unsigned short i, j; int n;
+	unsigned short i, j;
 	float fGainIter, fGainStep1, fGainStep2;
 	float *pFrames, *pBuffer;
 
@@ -1330,9 +1975,7 @@ int qtractorAudioBuffer::readMixFrames (
 		fGainStep1 = float(m_iRampGain) / float(nramp);
 		for (i = 0; i < iBuffers; ++i) {
 			fGainIter = (m_iRampGain < 0 ? 1.0f : 0.0f);
-			pBuffer = m_ppBuffer[i] + n1;
-			for (n = n1; n < n2; ++n, fGainIter += fGainStep1)
-				*pBuffer++ *= fGainIter;
+			(*m_pfnRamp)(m_ppBuffer[i] + n1, n2 - n1, fGainIter, fGainStep1);
 		}
 		m_iRampGain = (m_iRampGain < 0 ? 1 : 0);
 	//	fPrevGain = fGain;
@@ -1350,8 +1993,7 @@ int qtractorAudioBuffer::readMixFrames (
 			pBuffer = m_ppBuffer[i];
 			fGainIter = fPrevGain * m_pfGains[i];
 			fGainStep2 = fGainStep1 * m_pfGains[i];
-			for (n = 0; n < nread; ++n, fGainIter += fGainStep2)
-				*pFrames++ += fGainIter * *pBuffer++;
+			(*m_pfnMixRamp)(pFrames, pBuffer, nread, fGainIter, fGainStep2);
 		}
 	}
 	else if (iChannels > iBuffers) {
@@ -1361,8 +2003,7 @@ int qtractorAudioBuffer::readMixFrames (
 			pBuffer = m_ppBuffer[j];
 			fGainIter = fPrevGain * m_pfGains[j];
 			fGainStep2 = fGainStep1 * m_pfGains[j];
-			for (n = 0; n < nread; ++n, fGainIter += fGainStep2)
-				*pFrames++ += fGainIter * *pBuffer++;
+			(*m_pfnMixRamp)(pFrames, pBuffer, nread, fGainIter, fGainStep2);
 			if (++j >= iBuffers)
 				j = 0;
 		}
@@ -1374,8 +2015,7 @@ int qtractorAudioBuffer::readMixFrames (
 			pBuffer = m_ppBuffer[j];
 			fGainIter = fPrevGain * m_pfGains[j];
 			fGainStep2 = fGainStep1 * m_pfGains[j];
-			for (n = 0; n < nread; ++n, fGainIter += fGainStep2)
-				*pFrames++ += fGainIter * *pBuffer++;
+			(*m_pfnMixRamp)(pFrames, pBuffer, nread, fGainIter, fGainStep2);
 			if (++i >= iChannels)
 				i = 0;
 		}
@@ -1636,6 +2276,25 @@ qtractorAudioPeakFile *qtractorAudioBuffer::peakFile (void) const
 }
 
 
+// Pre-rendered time-stretch cache mode (local option).
+void qtractorAudioBuffer::setStretchCache ( bool bStretchCache )
+{
+	m_bStretchCache = bStretchCache;
+}
+
+bool qtractorAudioBuffer::isStretchCache (void) const
+{
+	return m_bStretchCache;
+}
+
+
+// Whether the whole clip fits in the ring-buffer.
+bool qtractorAudioBuffer::isIntegral (void) const
+{
+	return m_bIntegral;
+}
+
+
 // WSOLA time-stretch modes (local options).
 void qtractorAudioBuffer::setWsolaTimeStretch ( bool bWsolaTimeStretch )
 {
@@ -1659,6 +2318,17 @@ bool qtractorAudioBuffer::isWsolaQuickSeek (void) const
 }
 
 
+void qtractorAudioBuffer::setWsolaFastSeek ( bool bWsolaFastSeek )
+{
+	m_bWsolaFastSeek = bWsolaFastSeek;
+}
+
+bool qtractorAudioBuffer::isWsolaFastSeek (void) const
+{
+	return m_bWsolaFastSeek;
+}
+
+
 // Sample-rate converter type (global option).
 int qtractorAudioBuffer::g_iDefaultResampleType = 2;	// SRC_SINC_FASTEST;
 
@@ -1676,6 +2346,7 @@ int qtractorAudioBuffer::defaultResampleType (void)
 // WSOLA time-stretch modes (global options).
 bool qtractorAudioBuffer::g_bDefaultWsolaTimeStretch = true;
 bool qtractorAudioBuffer::g_bDefaultWsolaQuickSeek   = false;
+bool qtractorAudioBuffer::g_bDefaultWsolaFastSeek    = false;
 
 void qtractorAudioBuffer::setDefaultWsolaTimeStretch ( bool bWsolaTimeStretch )
 {
@@ -1699,4 +2370,15 @@ bool qtractorAudioBuffer::isDefaultWsolaQuickSeek (void)
 }
 
 
+void qtractorAudioBuffer::setDefaultWsolaFastSeek ( bool bWsolaFastSeek )
+{
+	g_bDefaultWsolaFastSeek = bWsolaFastSeek;
+}
+
+bool qtractorAudioBuffer::isDefaultWsolaFastSeek (void)
+{
+	return g_bDefaultWsolaFastSeek;
+}
+
+
 // end of qtractorAudioBuffer.cpp
@@ -24,7 +24,9 @@
 
 #include "qtractorList.h"
 #include "qtractorAudioFile.h"
+#include "qtractorAudioPageCache.h"
 #include "qtractorRingBuffer.h"
+#include "qtractorAtomic.h"
 
 #ifdef CONFIG_LIBSAMPLERATE
 // libsamplerate API
@@ -34,6 +36,9 @@
 #include <QThread>
 #include <QMutex>
 #include <QWaitCondition>
+#include <QAtomicPointer>
+
+#include <QList>
 
 
 // Forward declarations.
@@ -69,6 +74,14 @@ public:
 	// Conditional resize check.
 	void checkSyncSize(unsigned int iSyncSize);
 
+	// Shared thread pool reference management.
+	static qtractorAudioBufferThread *acquireSyncThread();
+	static void releaseSyncThread(qtractorAudioBufferThread *pSyncThread);
+
+	// Shared thread pool size (0=one dedicated thread per client).
+	static void setDefaultSyncThreads(unsigned int iSyncThreads);
+	static unsigned int defaultSyncThreads();
+
 protected:
 
 	// The main thread executives.
@@ -80,10 +93,21 @@ private:
 	// Instance variables.
 	unsigned int          m_iSyncSize;
 	unsigned int          m_iSyncMask;
-	qtractorAudioBuffer **m_ppSyncItems;
+
+	// Request ring: multiple producers (audio graph workers)
+	// claim slots by CAS on the write index, then fill them in;
+	// a null slot is one claimed but not filled in yet.
+	QAtomicPointer<qtractorAudioBuffer> *m_ppSyncItems;
 
 	volatile unsigned int m_iSyncRead;
-	volatile unsigned int m_iSyncWrite;
+	qtractorAtomic        m_iSyncWrite;
+
+	// Current batch, most urgent first.
+	qtractorAudioBuffer **m_ppSyncBatch;
+	unsigned int         *m_piSyncHeadroom;
+
+	// Number of clients sharing this thread.
+	unsigned int          m_iSyncRefs;
 
 	// Whether the thread is logically running.
 	volatile bool m_bRunState;
@@ -91,6 +115,10 @@ private:
 	// Thread synchronization objects.
 	QMutex m_mutex;
 	QWaitCondition m_cond;
+
+	// Shared thread pool.
+	static unsigned int g_iDefaultSyncThreads;
+	static QList<qtractorAudioBufferThread *> g_syncThreads;
 };
 
 
@@ -200,6 +228,20 @@ public:
 	void setPeakFile(qtractorAudioPeakFile *pPeakFile);
 	qtractorAudioPeakFile *peakFile() const;
 
+	// Frames left before starving (sync priority).
+	unsigned int syncHeadroom() const;
+
+	// Starvation statistics.
+	unsigned int minHeadroom() const;
+	unsigned int underruns() const;
+
+	// Capture statistics (write-mode fill-level telemetry).
+	unsigned long droppedFrames() const;
+	unsigned int fillLevel() const;
+	unsigned int maxFillLevel() const;
+
+	void resetSyncStats();
+
 	// WSOLA time-stretch modes (local options).
 	void setWsolaTimeStretch(bool bWsolaTimeStretch);
 	bool isWsolaTimeStretch() const;
@@ -207,6 +249,16 @@ public:
 	void setWsolaQuickSeek(bool bWsolaQuickSeek);
 	bool isWsolaQuickSeek() const;
 
+	void setWsolaFastSeek(bool bWsolaFastSeek);
+	bool isWsolaFastSeek() const;
+
+	// Pre-rendered time-stretch cache mode (local option).
+	void setStretchCache(bool bStretchCache);
+	bool isStretchCache() const;
+
+	// Whether the whole clip fits in the ring-buffer.
+	bool isIntegral() const;
+
 	// WSOLA time-stretch modes (global options).
 	static void setDefaultWsolaTimeStretch(bool bWsolaTimeStretch);
 	static bool isDefaultWsolaTimeStretch();
@@ -214,6 +266,9 @@ public:
 	static void setDefaultWsolaQuickSeek(bool bWsolaQuickSeek);
 	static bool isDefaultWsolaQuickSeek();
 
+	static void setDefaultWsolaFastSeek(bool bWsolaFastSeek);
+	static bool isDefaultWsolaFastSeek();
+
 	// Sample-rate converter type accessor (global option).
 	static void setDefaultResampleType(int iResampleType);
 	static int defaultResampleType();
@@ -237,6 +292,13 @@ protected:
 	int readBuffer  (unsigned int iFrames);
 	int writeBuffer (unsigned int iFrames);
 
+	// File read through the shared decoded page cache, if any.
+	int readFile(float **ppFrames, unsigned int iFrames);
+	void releasePage();
+
+	// Switch over to the pre-rendered time-stretch cache, if ready.
+	bool openStretchFile();
+
 	// Special kind of super-read/channel-mix buffer helper.
 	int readMixFrames(float **ppFrames, unsigned int iFrames,
 		unsigned short iChannels, unsigned int iOffset, float fGain);
@@ -298,6 +360,10 @@ private:
 	float          m_fNextGain;
 	int            m_iRampGain;
 
+	// Mix-with-gain-ramp and in-place gain-ramp processors.
+	void (*m_pfnMixRamp)(float *, float *, unsigned int, float, float);
+	void (*m_pfnRamp)(float *, unsigned int, float, float);
+
 #ifdef CONFIG_LIBSAMPLERATE
 	bool           m_bResample;
 	float          m_fResampleRatio;
@@ -309,13 +375,31 @@ private:
 
 	qtractorAudioPeakFile *m_pPeakFile;
 
+	// Starvation statistics.
+	volatile unsigned int m_iMinHeadroom;
+	volatile unsigned int m_iUnderruns;
+	volatile unsigned long m_iDroppedFrames;
+
+	// Shared decoded page cache state.
+	unsigned int   m_iPageFileId;
+	unsigned long  m_iPageOffset;
+	unsigned long  m_iPageFilePos;
+	qtractorAudioPageCache::Page *m_pPage;
+
+	// Pre-rendered time-stretch cache state.
+	bool           m_bStretchCache;
+	unsigned int   m_iStretchId;
+	qtractorAudioFile *m_pStretchFile;
+
 	// Time-stretch mode local options.
 	bool           m_bWsolaTimeStretch;
 	bool           m_bWsolaQuickSeek;
+	bool           m_bWsolaFastSeek;
 
 	// Time-stretch mode global options.
 	static bool    g_bDefaultWsolaTimeStretch;
 	static bool    g_bDefaultWsolaQuickSeek;
+	static bool    g_bDefaultWsolaFastSeek;
 
 	// Sample-rate converter type global option.
 	static int     g_iDefaultResampleType;
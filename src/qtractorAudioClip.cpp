@@ -29,6 +29,8 @@
 #include "qtractorSession.h"
 #include "qtractorFileList.h"
 
+#include "qtractorMainForm.h"
+
 #include <QFileInfo>
 #include <QPainter>
 #include <QPolygon>
@@ -359,6 +361,21 @@ void qtractorAudioClip::closeAudioFile (void)
 		m_pData->detach(this);
 		if (m_pData->count() < 1) {
 			removeHashKey();
+			// Report any playback underruns, explicitly...
+			// (capture overruns are reported on record commit)
+			qtractorAudioBuffer *pBuff = m_pData->buffer();
+			if (pBuff && pBuff->underruns() > 0 && pBuff->file()
+				&& (pBuff->file()->mode() & qtractorAudioFile::Read)) {
+				qtractorMainForm *pMainForm = qtractorMainForm::getInstance();
+				if (pMainForm) {
+					pMainForm->appendMessagesColor(
+						QObject::tr("Audio playback underrun on clip \"%1\": "
+							"%2 times (%3 frames min. headroom).")
+							.arg(clipName())
+							.arg(pBuff->underruns())
+							.arg(pBuff->minHeadroom()), "#cc0033");
+				}
+			}
 			delete m_pData;
 		#if 0
 			// ATTN: If proven empty, remove the file...
@@ -607,6 +624,11 @@ void qtractorAudioClip::process (
 	if (pAudioBus == NULL)
 		return;
 
+	// Mix-down into the current track buffer...
+	float **ppBuffer = track()->mixBuffer();
+	if (ppBuffer == NULL)
+		return;
+
 	// Get the next bunch from the clip...
 	const unsigned long iClipStart = clipStart();
 	if (iClipStart > iFrameEnd)
@@ -622,7 +644,7 @@ void qtractorAudioClip::process (
 	if (iClipStart > iFrameStart) {
 		if (pBuff->inSync(0, iOffset)) {
 			pBuff->readMix(
-				pAudioBus->buffer(),
+				ppBuffer,
 				iOffset,
 				pAudioBus->channels(),
 				iClipStart - iFrameStart,
@@ -631,7 +653,7 @@ void qtractorAudioClip::process (
 	} else {
 		if (pBuff->inSync(iFrameStart - iClipStart, iOffset)) {
 			pBuff->readMix(
-				pAudioBus->buffer(),
+				ppBuffer,
 				(iFrameEnd < iClipEnd ? iFrameEnd : iClipEnd) - iFrameStart,
 				pAudioBus->channels(),
 				0,
@@ -24,6 +24,8 @@
 #include "qtractorAudioMonitor.h"
 #include "qtractorAudioBuffer.h"
 #include "qtractorAudioClip.h"
+#include "qtractorAudioGraph.h"
+#include "qtractorEpoch.h"
 
 #include "qtractorSession.h"
 
@@ -54,10 +56,16 @@
 #include <jack/metadata.h>
 #endif
 
+#include "qtractorRingBuffer.h"
+
 #include <QApplication>
 #include <QProgressBar>
 #include <QDomDocument>
 
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+
 #if defined(__SSE__)
 
 #include <xmmintrin.h>
@@ -252,6 +260,107 @@ private:
 };
 
 
+//----------------------------------------------------------------------
+// qtractorAudioExportWriter -- audio export file encoder thread.
+//
+
+class qtractorAudioExportWriter : public QThread
+{
+public:
+
+	// Constructor.
+	qtractorAudioExportWriter(qtractorAudioFile *pExportFile,
+		unsigned short iChannels, unsigned int iBufferSize)
+		: QThread(), m_pExportFile(pExportFile),
+			m_ringBuffer(iChannels, iBufferSize << 6),
+			m_iChunkSize(iBufferSize << 2), m_bRunState(false)
+	{
+		m_ppFrames = new float * [iChannels];
+		for (unsigned short i = 0; i < iChannels; ++i)
+			m_ppFrames[i] = new float [m_iChunkSize];
+	}
+
+	// Destructor (drains all pending frames).
+	~qtractorAudioExportWriter()
+	{
+		if (isRunning()) {
+			m_mutex.lock();
+			m_bRunState = false;
+			m_cond.wakeAll();
+			m_mutex.unlock();
+			wait();
+		}
+
+		for (unsigned short i = 0; i < m_ringBuffer.channels(); ++i)
+			delete [] m_ppFrames[i];
+
+		delete [] m_ppFrames;
+	}
+
+	// Enqueue frames for writing (blocking while full;
+	// freewheeling has no RT requirements anyway).
+	void write(float **ppFrames, unsigned int nframes)
+	{
+		QMutexLocker locker(&m_mutex);
+
+		while (m_ringBuffer.writable() < nframes && m_bRunState)
+			m_cond.wait(&m_mutex);
+
+		m_ringBuffer.write(ppFrames, nframes);
+		m_cond.wakeAll();
+	}
+
+	// Whether the writer is logically running.
+	void setRunState(bool bRunState)
+	{
+		QMutexLocker locker(&m_mutex);
+
+		m_bRunState = bRunState;
+	}
+
+protected:
+
+	// The main thread executive.
+	void run()
+	{
+		m_mutex.lock();
+
+		for (;;) {
+			const int nread = m_ringBuffer.read(m_ppFrames, m_iChunkSize);
+			if (nread > 0) {
+				m_mutex.unlock();
+				m_pExportFile->write(m_ppFrames, nread);
+				m_mutex.lock();
+				m_cond.wakeAll();
+			}
+			else
+			if (m_bRunState)
+				m_cond.wait(&m_mutex);
+			else
+				break;
+		}
+
+		m_mutex.unlock();
+	}
+
+private:
+
+	// Instance variables.
+	qtractorAudioFile *m_pExportFile;
+
+	qtractorRingBuffer<float> m_ringBuffer;
+
+	unsigned int m_iChunkSize;
+	float      **m_ppFrames;
+
+	volatile bool m_bRunState;
+
+	// Thread synchronization objects.
+	QMutex m_mutex;
+	QWaitCondition m_cond;
+};
+
+
 //----------------------------------------------------------------------
 // qtractorAudioEngine_process -- JACK client process callback.
 //
@@ -261,7 +370,11 @@ static int qtractorAudioEngine_process ( jack_nframes_t nframes, void *pvArg )
 	qtractorAudioEngine *pAudioEngine
 		= static_cast<qtractorAudioEngine *> (pvArg);
 
-	return pAudioEngine->process(nframes);
+	qtractorEpoch::enter(qtractorEpoch::Audio);
+	const int iResult = pAudioEngine->process(nframes);
+	qtractorEpoch::leave(qtractorEpoch::Audio);
+
+	return iResult;
 }
 
 
@@ -275,7 +388,9 @@ static void qtractorAudioEngine_timebase ( jack_transport_state_t,
 	qtractorAudioEngine *pAudioEngine
 		= static_cast<qtractorAudioEngine *> (pvArg);
 
+	qtractorEpoch::enter(qtractorEpoch::Audio);
 	pAudioEngine->timebase(pPos, iNewPos);
+	qtractorEpoch::leave(qtractorEpoch::Audio);
 }
 
 
@@ -442,6 +557,13 @@ static int qtractorAudioEngine_sync (
 	if (pAudioEngine->isFreewheel())
 		return 0;
 
+	// Our own loop-wrap relocation is no real seek
+	// (eg. MIDI clips shall not chase state again)...
+	qtractorSession *pSession = pAudioEngine->session();
+	if (pSession && pSession->isLooping() && pAudioEngine->isPlaying()
+		&& pos->frame == pSession->loopStart())
+		return 1;
+
 	const long iDeltaFrames
 		= long(pos->frame) - long(pAudioEngine->sessionCursor()->frame());
 	const unsigned int iBufferSize = pAudioEngine->bufferSize();
@@ -497,11 +619,17 @@ qtractorAudioEngine::qtractorAudioEngine ( qtractorSession *pSession )
 	// Common audio buffer sync thread.
 	m_pSyncThread = NULL;
 
+	// Parallel track processing scheduler.
+	m_iWorkers    = 0;
+	m_pAudioGraph = NULL;
+
 	// Audio-export (in)active state.
 	m_bExporting   = false;
 	m_pExportFile  = NULL;
 	m_pExportBuses = NULL;
 	m_pExportBuffer = NULL;
+	m_pExportWriter = NULL;
+	m_pExportGraph  = NULL;
 	m_iExportStart = 0;
 	m_iExportEnd   = 0;
 	m_bExportDone  = true;
@@ -624,6 +752,26 @@ bool qtractorAudioEngine::isMasterAutoConnect (void) const
 }
 
 
+// Parallel track processing worker threads (0=disabled);
+// takes effect on next engine (re)initialization.
+void qtractorAudioEngine::setWorkers ( unsigned int iWorkers )
+{
+	m_iWorkers = iWorkers;
+}
+
+unsigned int qtractorAudioEngine::workers (void) const
+{
+	return (m_pAudioGraph ? m_pAudioGraph->workers() : m_iWorkers);
+}
+
+
+// Parallel track processing scheduler accessor.
+qtractorAudioGraph *qtractorAudioEngine::audioGraph (void) const
+{
+	return m_pAudioGraph;
+}
+
+
 // Device engine initialization method.
 bool qtractorAudioEngine::init (void)
 {
@@ -673,6 +821,10 @@ bool qtractorAudioEngine::init (void)
 	m_pSyncThread = new qtractorAudioBufferThread();
 	m_pSyncThread->start(QThread::HighPriority);
 
+	// Our parallel track processing workers, if any...
+	if (m_iWorkers > 0)
+		m_pAudioGraph = new qtractorAudioGraph(this, m_iWorkers);
+
 	return true;
 }
 
@@ -854,6 +1006,12 @@ void qtractorAudioEngine::clean (void)
 	deletePlayerBus();
 	deleteMetroBus();
 
+	// Terminate parallel track processing workers...
+	if (m_pAudioGraph) {
+		delete m_pAudioGraph;
+		m_pAudioGraph = NULL;
+	}
+
 	// Terminate common player/metro sync thread...
 	if (m_pSyncThread) {
 		if (m_pSyncThread->isRunning()) do {
@@ -866,6 +1024,16 @@ void qtractorAudioEngine::clean (void)
 	}
 
 	// Audio-export stilll around? weird...
+	if (m_pExportWriter) {
+		delete m_pExportWriter;
+		m_pExportWriter = NULL;
+	}
+
+	if (m_pExportGraph) {
+		delete m_pExportGraph;
+		m_pExportGraph = NULL;
+	}
+
 	if (m_pExportBuffer) {
 		delete m_pExportBuffer;
 		m_pExportBuffer = NULL;
@@ -1048,8 +1216,8 @@ int qtractorAudioEngine::process ( unsigned int nframes )
 
 	// Metronome stuff...
 	if (m_bMetronome && m_pMetroBus && iFrameEnd > m_iMetroBeatStart) {
-		qtractorTimeScale::Cursor& cursor = pSession->timeScale()->cursor();
-		qtractorTimeScale::Node *pNode = cursor.seekFrame(iFrameStart);
+		qtractorTimeScale::SnapshotCursor cursor(pSession->timeScale());
+		const qtractorTimeScale::Node *pNode = cursor.seekFrame(iFrameStart);
 		qtractorAudioBuffer *pMetroBuff = NULL;
 		if (pNode->beatIsBar(m_iMetroBeat))
 			pMetroBuff = m_pMetroBarBuff;
@@ -1143,7 +1311,8 @@ void qtractorAudioEngine::process_export ( unsigned int nframes )
 		return;
 	if (m_pExportBuses  == NULL ||
 		m_pExportFile   == NULL ||
-		m_pExportBuffer == NULL)
+		m_pExportBuffer == NULL ||
+		m_pExportWriter == NULL)
 		return;
 
 	qtractorSession *pSession = session();
@@ -1189,13 +1358,18 @@ void qtractorAudioEngine::process_export ( unsigned int nframes )
 			pMidiManager->process(iFrameStart, iFrameEnd);
 			pMidiManager = pMidiManager->next();
 		}
-		// Perform all tracks processing...
-		int iTrack = 0;
-		for (qtractorTrack *pTrack = pSession->tracks().first();
-				pTrack; pTrack = pTrack->next()) {
-			pTrack->process_export(pAudioCursor->clip(iTrack),
-				iFrameStart, iFrameEnd);
-			++iTrack;
+		// Perform all tracks processing, in parallel if possible...
+		qtractorAudioGraph *pAudioGraph
+			= (m_pAudioGraph ? m_pAudioGraph : m_pExportGraph);
+		if (pAudioGraph == NULL || !pAudioGraph->process(
+				pAudioCursor, iFrameStart, iFrameEnd, true)) {
+			int iTrack = 0;
+			for (qtractorTrack *pTrack = pSession->tracks().first();
+					pTrack; pTrack = pTrack->next()) {
+				pTrack->process_export(pAudioCursor->clip(iTrack),
+					iFrameStart, iFrameEnd);
+				++iTrack;
+			}
 		}
 		// Prepare advance for next cycle...
 		pAudioCursor->seek(iFrameEnd);
@@ -1209,8 +1383,8 @@ void qtractorAudioEngine::process_export ( unsigned int nframes )
 			pExportBus->process_commit(nframes);
 			m_pExportBuffer->process_add(pExportBus, nframes);
 		}
-		// Write to export file...
-		m_pExportFile->write(m_pExportBuffer->buffer(), nframes);
+		// Write to export file (on the encoder thread)...
+		m_pExportWriter->write(m_pExportBuffer->buffer(), nframes);
 		// HACK! Freewheeling observers update (non RT safe!)...
 		qtractorSubject::flushQueue(false);
 	} else {
@@ -1258,8 +1432,8 @@ void qtractorAudioEngine::process_export ( unsigned int nframes )
 void qtractorAudioEngine::timebase ( jack_position_t *pPos, int iNewPos )
 {
 	qtractorSession *pSession = session();
-	qtractorTimeScale::Cursor& cursor = pSession->timeScale()->cursor();
-	qtractorTimeScale::Node *pNode = cursor.seekFrame(pPos->frame);
+	qtractorTimeScale::SnapshotCursor cursor(pSession->timeScale());
+	const qtractorTimeScale::Node *pNode = cursor.seekFrame(pPos->frame);
 	unsigned short bars  = 0;
 	unsigned int   beats = 0;
 	unsigned long  ticks = pNode->tickFromFrame(pPos->frame) - pNode->tick;
@@ -1503,6 +1677,8 @@ bool qtractorAudioEngine::fileExport (
 	m_pExportBuses = new QList<qtractorAudioBus *> (exportBuses);
 	m_pExportFile  = pExportFile;
 	m_pExportBuffer = new qtractorAudioExportBuffer(iChannels, bufferSize());
+	m_pExportWriter = new qtractorAudioExportWriter(
+		pExportFile, iChannels, bufferSize());
 	m_iExportStart = iExportStart;
 	m_iExportEnd   = iExportEnd;
 	m_bExportDone  = false;
@@ -1532,6 +1708,18 @@ bool qtractorAudioEngine::fileExport (
 	// Special initialization.
 	m_iBufferOffset = 0;
 
+	// File encoding goes on its own thread...
+	m_pExportWriter->setRunState(true);
+	m_pExportWriter->start();
+
+	// Render tracks in parallel, using all cores, unless
+	// parallel track processing is already configured...
+	if (m_pAudioGraph == NULL) {
+		const int iWorkers = QThread::idealThreadCount() - 1;
+		if (iWorkers > 0)
+			m_pExportGraph = new qtractorAudioGraph(this, iWorkers, false);
+	}
+
 	// Start export (freewheeling)...
 	jack_set_freewheel(m_pJackClient, 1);
 
@@ -1554,9 +1742,18 @@ bool qtractorAudioEngine::fileExport (
 	// Stop export (freewheeling)...
 	jack_set_freewheel(m_pJackClient, 0);
 
-	// May close the file...
+	// Flush all pending frames, then close the file...
+	m_pExportWriter->setRunState(false);
+	delete m_pExportWriter;
+	m_pExportWriter = NULL;
+
 	m_pExportFile->close();
 
+	if (m_pExportGraph) {
+		delete m_pExportGraph;
+		m_pExportGraph = NULL;
+	}
+
 	// Restore session at ease...
 	pSession->setLoop(iLoopStart, iLoopEnd);
 	pSession->setPlayHead(iPlayHead);
@@ -1876,8 +2073,8 @@ void qtractorAudioEngine::resetMetro (void)
 
 	// Reset to the next beat position...
 	unsigned long iFrame = pAudioCursor->frame();
-	qtractorTimeScale::Cursor& cursor = pSession->timeScale()->cursor();
-	qtractorTimeScale::Node *pNode = cursor.seekFrame(iFrame);
+	qtractorTimeScale::SnapshotCursor cursor(pSession->timeScale());
+	const qtractorTimeScale::Node *pNode = cursor.seekFrame(iFrame);
 
 	// FIXME: Each sample buffer must be bounded properly...
 	unsigned long iMaxLength = 0;
@@ -2674,6 +2871,19 @@ void qtractorAudioBus::process_commit ( unsigned int nframes )
 // Bus-buffering methods.
 void qtractorAudioBus::buffer_prepare (
 	unsigned int nframes, qtractorAudioBus *pInputBus )
+{
+	buffer_prepare(m_ppXBuffer, m_ppYBuffer, nframes, pInputBus);
+}
+
+void qtractorAudioBus::buffer_commit ( unsigned int nframes )
+{
+	buffer_commit(m_ppXBuffer, nframes);
+}
+
+
+// Private bus-buffering methods.
+void qtractorAudioBus::buffer_prepare ( float **ppXBuffer, float **ppYBuffer,
+	unsigned int nframes, qtractorAudioBus *pInputBus )
 {
 	if (!m_bEnabled)
 		return;
@@ -2688,8 +2898,8 @@ void qtractorAudioBus::buffer_prepare (
 
 	if (pInputBus == NULL) {
 		for (unsigned short i = 0; i < m_iChannels; ++i) {
-			m_ppYBuffer[i] = m_ppXBuffer[i] + offset;
-			::memset(m_ppYBuffer[i], 0, nbytes);
+			ppYBuffer[i] = ppXBuffer[i] + offset;
+			::memset(ppYBuffer[i], 0, nbytes);
 		}
 		return;
 	}
@@ -2700,31 +2910,31 @@ void qtractorAudioBus::buffer_prepare (
 	if (m_iChannels == iBuffers) {
 		// Exact buffer copy...
 		for (unsigned short i = 0; i < iBuffers; ++i) {
-			m_ppYBuffer[i] = m_ppXBuffer[i] + offset;
-			::memcpy(m_ppYBuffer[i], ppBuffer[i] + offset, nbytes);
+			ppYBuffer[i] = ppXBuffer[i] + offset;
+			::memcpy(ppYBuffer[i], ppBuffer[i] + offset, nbytes);
 		}
 	} else {
 		// Buffer merge/multiplex...
 		unsigned short i;
 		for (i = 0; i < m_iChannels; ++i) {
-			m_ppYBuffer[i] = m_ppXBuffer[i] + offset;
-			::memset(m_ppYBuffer[i], 0, nbytes);
+			ppYBuffer[i] = ppXBuffer[i] + offset;
+			::memset(ppYBuffer[i], 0, nbytes);
 		}
 		if (m_iChannels > iBuffers) {
 			unsigned short j = 0;
 			for (i = 0; i < m_iChannels; ++i) {
-				::memcpy(m_ppYBuffer[i], ppBuffer[j] + offset, nbytes);
+				::memcpy(ppYBuffer[i], ppBuffer[j] + offset, nbytes);
 				if (++j >= iBuffers)
 					j = 0;
 			}
 		} else { // (m_iChannels < iBuffers)
-			(*m_pfnBufferAdd)(m_ppXBuffer, ppBuffer,
+			(*m_pfnBufferAdd)(ppXBuffer, ppBuffer,
 				nframes, m_iChannels, iBuffers, offset);
 		}
 	}
 }
 
-void qtractorAudioBus::buffer_commit ( unsigned int nframes )
+void qtractorAudioBus::buffer_commit ( float **ppXBuffer, unsigned int nframes )
 {
 	if (!m_bEnabled || (busMode() & qtractorBus::Output) == 0)
 		return;
@@ -2734,7 +2944,7 @@ void qtractorAudioBus::buffer_commit ( unsigned int nframes )
 	if (pAudioEngine == NULL)
 		return;
 
-	(*m_pfnBufferAdd)(m_ppOBuffer, m_ppXBuffer,
+	(*m_pfnBufferAdd)(m_ppOBuffer, ppXBuffer,
 		nframes, m_iChannels, m_iChannels, pAudioEngine->bufferOffset());
 }
 
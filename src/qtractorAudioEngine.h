@@ -36,6 +36,8 @@ class qtractorAudioBuffer;
 class qtractorAudioMonitor;
 class qtractorAudioFile;
 class qtractorAudioExportBuffer;
+class qtractorAudioExportWriter;
+class qtractorAudioGraph;
 class qtractorPluginList;
 class qtractorCurveList;
 
@@ -137,6 +139,13 @@ public:
 	void setMasterAutoConnect(bool bMasterAutoConnect);
 	bool isMasterAutoConnect() const;
 
+	// Parallel track processing worker threads (0=disabled).
+	void setWorkers(unsigned int iWorkers);
+	unsigned int workers() const;
+
+	// Parallel track processing scheduler accessor.
+	qtractorAudioGraph *audioGraph() const;
+
 	// Audio-export freewheeling (internal) state.
 	void setFreewheel(bool bFreewheel);
 	bool isFreewheel() const;
@@ -286,6 +295,10 @@ private:
 	// Common audio buffer sync thread.
 	qtractorAudioBufferThread *m_pSyncThread;
 
+	// Parallel track processing scheduler.
+	unsigned int        m_iWorkers;
+	qtractorAudioGraph *m_pAudioGraph;
+
 	// Audio-export (in)active state.
 	volatile bool        m_bExporting;
 	qtractorAudioFile   *m_pExportFile;
@@ -295,6 +308,8 @@ private:
 
 	QList<qtractorAudioBus *> *m_pExportBuses;
 	qtractorAudioExportBuffer *m_pExportBuffer;
+	qtractorAudioExportWriter *m_pExportWriter;
+	qtractorAudioGraph        *m_pExportGraph;
 
 	// Audio metronome stuff.
 	bool                 m_bMetronome;
@@ -374,6 +389,12 @@ public:
 		qtractorAudioBus *pInputBus = NULL);
 	void buffer_commit(unsigned int nframes);
 
+	// Private bus-buffering methods (eg. per-producer
+	// scratch buffers, committed at a later stage).
+	void buffer_prepare(float **ppXBuffer, float **ppYBuffer,
+		unsigned int nframes, qtractorAudioBus *pInputBus = NULL);
+	void buffer_commit(float **ppXBuffer, unsigned int nframes);
+
 	// Up-and-running predicate.
 	bool isEnabled() const { return m_bEnabled; }
 
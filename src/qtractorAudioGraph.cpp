@@ -0,0 +1,650 @@
+// qtractorAudioGraph.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2018, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qtractorAbout.h"
+#include "qtractorAudioGraph.h"
+#include "qtractorAudioEngine.h"
+
+#include "qtractorSession.h"
+#include "qtractorSessionCursor.h"
+
+#include "qtractorPlugin.h"
+#include "qtractorInsertPlugin.h"
+#include "qtractorCurve.h"
+
+#include <jack/thread.h>
+
+
+// Minimum pre-allocated graph capacity.
+#define QTRACTOR_AUDIO_GRAPH_TRACKS	64
+#define QTRACTOR_AUDIO_GRAPH_BUSES	16
+
+// Scratch buffer stride alignment (in frames; 64 byte cache-lines).
+#define QTRACTOR_AUDIO_GRAPH_ALIGN	16
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioGraphThread -- Track-chain worker thread.
+//
+
+// Constructor.
+qtractorAudioGraphThread::qtractorAudioGraphThread (
+	qtractorAudioGraph *pAudioGraph ) : QThread()
+{
+	m_pAudioGraph = pAudioGraph;
+
+	m_bRunState = false;
+}
+
+
+// Destructor.
+qtractorAudioGraphThread::~qtractorAudioGraphThread (void)
+{
+	if (isRunning()) do {
+		setRunState(false);
+	//	terminate();
+		sync();
+	} while (!wait(100));
+}
+
+
+// Run state accessor.
+void qtractorAudioGraphThread::setRunState ( bool bRunState )
+{
+	QMutexLocker locker(&m_mutex);
+
+	m_bRunState = bRunState;
+}
+
+bool qtractorAudioGraphThread::runState (void) const
+{
+	return m_bRunState;
+}
+
+
+// Wake from executive wait condition (RT-safe).
+void qtractorAudioGraphThread::sync (void)
+{
+	// Never block here: should the worker be busy,
+	// the process thread will take the work itself.
+	if (m_mutex.tryLock()) {
+		m_cond.wakeAll();
+		m_mutex.unlock();
+	}
+#ifdef CONFIG_DEBUG_0
+	else qDebug("qtractorAudioGraphThread[%p]::sync(): tryLock() failed.", this);
+#endif
+}
+
+
+// Thread run executive.
+void qtractorAudioGraphThread::run (void)
+{
+#ifdef CONFIG_DEBUG_0
+	qDebug("qtractorAudioGraphThread[%p]::run(): started.", this);
+#endif
+
+	// Workers must run at the same realtime priority
+	// of the JACK process thread, if applicable...
+	qtractorAudioEngine *pAudioEngine = m_pAudioGraph->audioEngine();
+	jack_client_t *pJackClient = pAudioEngine->jackClient();
+	if (m_pAudioGraph->isRealtime()
+		&& pJackClient && jack_is_realtime(pJackClient)) {
+		jack_acquire_real_time_scheduling(::pthread_self(),
+			jack_client_real_time_priority(pJackClient));
+	}
+
+	m_mutex.lock();
+
+	m_bRunState = true;
+
+	while (m_bRunState) {
+		// Do whatever we must, then wait for more...
+		m_pAudioGraph->process_resize();
+		m_pAudioGraph->process_tasks();
+		// Wait for sync...
+		m_cond.wait(&m_mutex);
+	}
+
+	m_mutex.unlock();
+
+#ifdef CONFIG_DEBUG_0
+	qDebug("qtractorAudioGraphThread[%p]::run(): stopped.", this);
+#endif
+}
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioGraph -- Parallel track-chain process scheduler.
+//
+
+// Constructor.
+qtractorAudioGraph::qtractorAudioGraph (
+	qtractorAudioEngine *pAudioEngine, unsigned int iWorkers, bool bRealtime )
+{
+	m_pAudioEngine = pAudioEngine;
+
+	m_pSessionCursor = NULL;
+	m_iFrameStart = 0;
+	m_iFrameEnd   = 0;
+	m_bExport     = false;
+
+	m_iMaxTracks = 0;
+	m_ppTracks   = NULL;
+	m_piSlot     = NULL;
+	m_piNext     = NULL;
+	m_piMixSlot  = NULL;
+	m_piMixNext  = NULL;
+	m_piMix      = NULL;
+	m_piTasks    = NULL;
+	m_iTasks     = 0;
+
+	m_iMaxBuses  = 0;
+	m_iBuses     = 0;
+	m_ppBuses    = NULL;
+	m_piParent   = NULL;
+	m_piHead     = NULL;
+	m_piTail     = NULL;
+	m_piMixHead  = NULL;
+	m_piMixTail  = NULL;
+	m_piReduce   = NULL;
+	m_iReduce    = 0;
+
+	m_iMaxChannels = 0;
+	m_iMaxFrames   = 0;
+	m_pfMixPool    = NULL;
+	m_ppMixXBuffer = NULL;
+	m_ppMixYBuffer = NULL;
+
+	m_iStage      = 0;
+	m_iStageTasks = 0;
+
+	ATOMIC_SET(&m_taskPending, 0);
+	ATOMIC_SET(&m_taskDone, 0);
+
+	// Initial capacity, immediate...
+	ATOMIC_SET(&m_resizePending, 1);
+	m_iResizeTracks   = QTRACTOR_AUDIO_GRAPH_TRACKS;
+	m_iResizeBuses    = QTRACTOR_AUDIO_GRAPH_BUSES;
+	m_iResizeChannels = (QTRACTOR_AUDIO_GRAPH_TRACKS << 1);
+	m_iResizeFrames   = pAudioEngine->bufferSize();
+	process_resize();
+
+	// Start the worker thread pool...
+	m_iWorkers  = iWorkers;
+	m_bRealtime = bRealtime;
+	m_ppWorkers = new qtractorAudioGraphThread * [m_iWorkers];
+	for (unsigned int i = 0; i < m_iWorkers; ++i) {
+		m_ppWorkers[i] = new qtractorAudioGraphThread(this);
+		m_ppWorkers[i]->start(m_bRealtime
+			? QThread::TimeCriticalPriority
+			: QThread::NormalPriority);
+	}
+}
+
+
+// Destructor.
+qtractorAudioGraph::~qtractorAudioGraph (void)
+{
+	for (unsigned int i = 0; i < m_iWorkers; ++i)
+		delete m_ppWorkers[i];
+	delete [] m_ppWorkers;
+
+	if (m_ppTracks)  delete [] m_ppTracks;
+	if (m_piSlot)    delete [] m_piSlot;
+	if (m_piNext)    delete [] m_piNext;
+	if (m_piMixSlot) delete [] m_piMixSlot;
+	if (m_piMixNext) delete [] m_piMixNext;
+	if (m_piMix)     delete [] m_piMix;
+	if (m_piTasks)   delete [] m_piTasks;
+
+	if (m_ppBuses)   delete [] m_ppBuses;
+	if (m_piParent)  delete [] m_piParent;
+	if (m_piHead)    delete [] m_piHead;
+	if (m_piTail)    delete [] m_piTail;
+	if (m_piMixHead) delete [] m_piMixHead;
+	if (m_piMixTail) delete [] m_piMixTail;
+	if (m_piReduce)  delete [] m_piReduce;
+
+	if (m_pfMixPool)    delete [] m_pfMixPool;
+	if (m_ppMixXBuffer) delete [] m_ppMixXBuffer;
+	if (m_ppMixYBuffer) delete [] m_ppMixYBuffer;
+}
+
+
+// Audio engine accessor.
+qtractorAudioEngine *qtractorAudioGraph::audioEngine (void) const
+{
+	return m_pAudioEngine;
+}
+
+
+// Number of worker threads.
+unsigned int qtractorAudioGraph::workers (void) const
+{
+	return m_iWorkers;
+}
+
+
+// Whether workers run with realtime scheduling.
+bool qtractorAudioGraph::isRealtime (void) const
+{
+	return m_bRealtime;
+}
+
+
+// Parallel process cycle executive (RT-safe).
+bool qtractorAudioGraph::process ( qtractorSessionCursor *pSessionCursor,
+	unsigned long iFrameStart, unsigned long iFrameEnd, bool bExport )
+{
+	if (m_iWorkers < 1)
+		return false;
+
+	// Capacity adjustment still pending?
+	if (!ATOMIC_CAS(&m_resizePending, 0, 0)) {
+		// Not claimed yet? retry waking the workers,
+		// as any earlier wakeup might have been missed...
+		if (ATOMIC_CAS(&m_resizePending, 1, 1))
+			wakeWorkers();
+		return false;
+	}
+
+	qtractorSession *pSession = m_pAudioEngine->session();
+	if (pSession == NULL)
+		return false;
+
+	// Partition tracks into independent chains...
+	if (build() < 0)
+		return false;
+
+	// Track automation processing is kept serial,
+	// as subject value updates are queued globally;
+	// export cycles don't, as plain serial export didn't...
+	int iTrack = 0;
+	qtractorTrack *pTrack = pSession->tracks().first();
+	while (pTrack) {
+		qtractorCurveList *pCurveList = pTrack->curveList();
+		if (!bExport && pCurveList && pCurveList->isProcess())
+			pCurveList->process(iFrameStart);
+		// Non-audio tracks are to be exported right away...
+		if (bExport && pTrack->trackType() != qtractorTrack::Audio) {
+			pTrack->process_export(pSessionCursor->clip(iTrack),
+				iFrameStart, iFrameEnd);
+		}
+		pTrack = pTrack->next();
+		++iTrack;
+	}
+
+	m_pSessionCursor = pSessionCursor;
+	m_iFrameStart = iFrameStart;
+	m_iFrameEnd   = iFrameEnd;
+	m_bExport     = bExport;
+
+	// First stage: all track-chains, into private buffers...
+	m_iStage = 0;
+	dispatch(m_iTasks);
+
+	// Second stage: output bus reductions...
+	m_iStage = 1;
+	dispatch(m_iReduce);
+
+	return true;
+}
+
+
+// Dispatch current stage tasks and wait for completion (RT-safe).
+void qtractorAudioGraph::dispatch ( int iTasks )
+{
+	// Not worth any dispatching at all?
+	if (iTasks < 2) {
+		if (iTasks > 0)
+			process_task(0);
+		return;
+	}
+
+	// Publish this stage tasks (ordered)...
+	m_iStageTasks = iTasks;
+	ATOMIC_SET(&m_taskDone, 0);
+	ATOMIC_ADD(&m_taskPending, iTasks);
+
+	// Wake up just enough workers...
+	unsigned int iWakes = iTasks - 1;
+	if (iWakes > m_iWorkers)
+		iWakes = m_iWorkers;
+	for (unsigned int i = 0; i < iWakes; ++i)
+		m_ppWorkers[i]->sync();
+
+	// Take our own share of the work...
+	process_tasks();
+
+	// Wait for all tasks in-flight to complete...
+	while (!ATOMIC_CAS(&m_taskDone, iTasks, iTasks))
+		process_tasks();
+}
+
+
+// Worker thread executive (claim and process tasks).
+void qtractorAudioGraph::process_tasks (void)
+{
+	for (;;) {
+		const int iPending = ATOMIC_GET(&m_taskPending);
+		if (iPending < 1)
+			break;
+		if (!ATOMIC_CAS(&m_taskPending, iPending, iPending - 1))
+			continue;
+		process_task(m_iStageTasks - iPending);
+		ATOMIC_INC(&m_taskDone);
+	}
+}
+
+
+// Process a single task (track-chain or bus reduction).
+void qtractorAudioGraph::process_task ( int iTask )
+{
+	if (m_iStage == 0) {
+		// Track-chain, each one into its own private buffer...
+		int iTrack = m_piTasks[iTask];
+		while (iTrack >= 0) {
+			float **ppXBuffer = NULL;
+			float **ppYBuffer = NULL;
+			if (m_piMixSlot[iTrack] >= 0) {
+				ppXBuffer = &m_ppMixXBuffer[m_piMix[iTrack]];
+				ppYBuffer = &m_ppMixYBuffer[m_piMix[iTrack]];
+			}
+			if (m_bExport) {
+				m_ppTracks[iTrack]->process_export(
+					m_pSessionCursor->clip(iTrack),
+					m_iFrameStart, m_iFrameEnd, ppXBuffer, ppYBuffer);
+			} else {
+				m_ppTracks[iTrack]->process(m_pSessionCursor->clip(iTrack),
+					m_iFrameStart, m_iFrameEnd, ppXBuffer, ppYBuffer);
+			}
+			iTrack = m_piNext[iTrack];
+		}
+	} else {
+		// Bus reduction, summing all its producers...
+		const int iSlot = m_piReduce[iTask];
+		qtractorAudioBus *pAudioBus
+			= static_cast<qtractorAudioBus *> (m_ppBuses[iSlot]);
+		const unsigned int nframes = m_iFrameEnd - m_iFrameStart;
+		int iTrack = m_piMixHead[iSlot];
+		while (iTrack >= 0) {
+			pAudioBus->buffer_commit(&m_ppMixXBuffer[m_piMix[iTrack]], nframes);
+			iTrack = m_piMixNext[iTrack];
+		}
+	}
+}
+
+
+// Chain builder (RT-safe, no allocation).
+int qtractorAudioGraph::build (void)
+{
+	qtractorSession *pSession = m_pAudioEngine->session();
+
+	const unsigned int iTracks = pSession->tracks().count();
+	const unsigned int iBuses = m_pAudioEngine->buses().count()
+		+ m_pAudioEngine->busesEx().count();
+	const unsigned int iFrames = m_pAudioEngine->bufferSize();
+	if (iTracks > m_iMaxTracks
+		|| iBuses > m_iMaxBuses
+		|| iFrames > m_iMaxFrames) {
+		resize(iTracks, iBuses, m_iMaxChannels, iFrames);
+		return -1;
+	}
+
+	m_iBuses  = 0;
+	m_iTasks  = 0;
+	m_iReduce = 0;
+
+	unsigned int iChannels = 0;
+
+	// First pass: map each audio track to its output bus slot
+	// and mix-down buffers, joining all aux-send buses it happens
+	// to write into directly...
+	int iTrack = 0;
+	qtractorTrack *pTrack = pSession->tracks().first();
+	while (pTrack) {
+		int iSlot = -1;
+		int iMixSlot = -2;
+		if (pTrack->trackType() == qtractorTrack::Audio) {
+			qtractorAudioBus *pAudioBus
+				= static_cast<qtractorAudioBus *> (pTrack->outputBus());
+			iMixSlot = -1;
+			if (pAudioBus) {
+				iMixSlot = busSlot(pAudioBus);
+				if (iMixSlot < 0)
+					return -1;
+				m_piMix[iTrack] = iChannels;
+				iChannels += pAudioBus->channels();
+				if (iChannels > m_iMaxChannels) {
+					resize(iTracks, iBuses, iChannels, iFrames);
+					return -1;
+				}
+			}
+			qtractorPluginList *pPluginList = pTrack->pluginList();
+			qtractorPlugin *pPlugin = pPluginList->first();
+			while (pPlugin) {
+				if (pPlugin->type()->typeHint() == qtractorPluginType::AuxSend) {
+					qtractorAudioAuxSendPlugin *pAuxSendPlugin
+						= static_cast<qtractorAudioAuxSendPlugin *> (pPlugin);
+					qtractorAudioBus *pAuxBus = pAuxSendPlugin->audioBus();
+					if (pAuxBus) {
+						const int iAuxSlot = busSlot(pAuxBus);
+						if (iAuxSlot < 0)
+							return -1;
+						if (iSlot < 0)
+							iSlot = iAuxSlot;
+						else
+							unionSlots(iSlot, iAuxSlot);
+					}
+				}
+				pPlugin = pPlugin->next();
+			}
+		}
+		m_ppTracks[iTrack]  = pTrack;
+		m_piSlot[iTrack]    = iSlot;
+		m_piNext[iTrack]    = -1;
+		m_piMixSlot[iTrack] = iMixSlot;
+		m_piMixNext[iTrack] = -1;
+		pTrack = pTrack->next();
+		++iTrack;
+	}
+
+	// Second pass: link tracks into chains, one per joint aux-send
+	// bus set, and into producer lists, one per output bus, keeping
+	// original track order all the way...
+	for (int i = 0; i < iTrack; ++i) {
+		const int iMixSlot = m_piMixSlot[i];
+		if (iMixSlot == -2)
+			continue;
+		const int iSlot = m_piSlot[i];
+		if (iSlot < 0) {
+			m_piTasks[m_iTasks++] = i;
+		} else {
+			const int iRoot = findSlot(iSlot);
+			if (m_piHead[iRoot] < 0) {
+				m_piHead[iRoot] = i;
+				m_piTasks[m_iTasks++] = i;
+			} else {
+				m_piNext[m_piTail[iRoot]] = i;
+			}
+			m_piTail[iRoot] = i;
+		}
+		if (iMixSlot >= 0) {
+			if (m_piMixHead[iMixSlot] < 0) {
+				m_piMixHead[iMixSlot] = i;
+				m_piReduce[m_iReduce++] = iMixSlot;
+			} else {
+				m_piMixNext[m_piMixTail[iMixSlot]] = i;
+			}
+			m_piMixTail[iMixSlot] = i;
+		}
+	}
+
+	return m_iTasks;
+}
+
+
+// Bus slot look-up/insertion helper.
+int qtractorAudioGraph::busSlot ( qtractorBus *pBus )
+{
+	for (unsigned int i = 0; i < m_iBuses; ++i) {
+		if (m_ppBuses[i] == pBus)
+			return i;
+	}
+
+	if (m_iBuses >= m_iMaxBuses)
+		return -1;
+
+	const int iSlot = m_iBuses++;
+	m_ppBuses[iSlot]   = pBus;
+	m_piParent[iSlot]  = iSlot;
+	m_piHead[iSlot]    = -1;
+	m_piTail[iSlot]    = -1;
+	m_piMixHead[iSlot] = -1;
+	m_piMixTail[iSlot] = -1;
+
+	return iSlot;
+}
+
+
+// Bus slot union-find helpers.
+int qtractorAudioGraph::findSlot ( int iSlot ) const
+{
+	while (m_piParent[iSlot] != iSlot) {
+		m_piParent[iSlot] = m_piParent[m_piParent[iSlot]];
+		iSlot = m_piParent[iSlot];
+	}
+
+	return iSlot;
+}
+
+void qtractorAudioGraph::unionSlots ( int iSlot1, int iSlot2 )
+{
+	const int iRoot1 = findSlot(iSlot1);
+	const int iRoot2 = findSlot(iSlot2);
+	if (iRoot1 != iRoot2)
+		m_piParent[iRoot2] = iRoot1;
+}
+
+
+// Request a deferred capacity adjustment (RT-safe).
+void qtractorAudioGraph::resize ( unsigned int iTracks, unsigned int iBuses,
+	unsigned int iChannels, unsigned int iFrames )
+{
+	if (!ATOMIC_CAS(&m_resizePending, 0, 0))
+		return;
+
+	m_iResizeTracks   = (iTracks   << 1);
+	m_iResizeBuses    = (iBuses    << 1);
+	m_iResizeChannels = (iChannels << 1);
+	m_iResizeFrames   = iFrames;
+
+	// Publish the request (ordered)...
+	ATOMIC_CAS(&m_resizePending, 0, 1);
+
+	// Any idle worker will do...
+	wakeWorkers();
+}
+
+
+// Wake all workers, whichever is idle (RT-safe).
+void qtractorAudioGraph::wakeWorkers (void)
+{
+	for (unsigned int i = 0; i < m_iWorkers; ++i)
+		m_ppWorkers[i]->sync();
+}
+
+
+// Worker thread deferred capacity adjustment (non RT-safe).
+void qtractorAudioGraph::process_resize (void)
+{
+	// Claim the pending request, if any...
+	if (!ATOMIC_CAS(&m_resizePending, 1, 2))
+		return;
+
+	if (m_iMaxTracks < m_iResizeTracks) {
+		if (m_ppTracks)  delete [] m_ppTracks;
+		if (m_piSlot)    delete [] m_piSlot;
+		if (m_piNext)    delete [] m_piNext;
+		if (m_piMixSlot) delete [] m_piMixSlot;
+		if (m_piMixNext) delete [] m_piMixNext;
+		if (m_piMix)     delete [] m_piMix;
+		if (m_piTasks)   delete [] m_piTasks;
+		m_iMaxTracks = m_iResizeTracks;
+		m_ppTracks  = new qtractorTrack * [m_iMaxTracks];
+		m_piSlot    = new int [m_iMaxTracks];
+		m_piNext    = new int [m_iMaxTracks];
+		m_piMixSlot = new int [m_iMaxTracks];
+		m_piMixNext = new int [m_iMaxTracks];
+		m_piMix     = new int [m_iMaxTracks];
+		m_piTasks   = new int [m_iMaxTracks];
+	}
+
+	if (m_iMaxBuses < m_iResizeBuses) {
+		if (m_ppBuses)   delete [] m_ppBuses;
+		if (m_piParent)  delete [] m_piParent;
+		if (m_piHead)    delete [] m_piHead;
+		if (m_piTail)    delete [] m_piTail;
+		if (m_piMixHead) delete [] m_piMixHead;
+		if (m_piMixTail) delete [] m_piMixTail;
+		if (m_piReduce)  delete [] m_piReduce;
+		m_iMaxBuses = m_iResizeBuses;
+		m_ppBuses   = new qtractorBus * [m_iMaxBuses];
+		m_piParent  = new int [m_iMaxBuses];
+		m_piHead    = new int [m_iMaxBuses];
+		m_piTail    = new int [m_iMaxBuses];
+		m_piMixHead = new int [m_iMaxBuses];
+		m_piMixTail = new int [m_iMaxBuses];
+		m_piReduce  = new int [m_iMaxBuses];
+	}
+
+	if (m_iMaxChannels < m_iResizeChannels
+		|| m_iMaxFrames < m_iResizeFrames) {
+		if (m_pfMixPool)    delete [] m_pfMixPool;
+		if (m_ppMixXBuffer) delete [] m_ppMixXBuffer;
+		if (m_ppMixYBuffer) delete [] m_ppMixYBuffer;
+		if (m_iMaxChannels < m_iResizeChannels)
+			m_iMaxChannels = m_iResizeChannels;
+		if (m_iMaxFrames < m_iResizeFrames)
+			m_iMaxFrames = m_iResizeFrames;
+		// Each channel buffer starts on its own cache-line,
+		// avoiding false-sharing between concurrent producers...
+		const unsigned int iAlignMask = QTRACTOR_AUDIO_GRAPH_ALIGN - 1;
+		const unsigned int iStride = (m_iMaxFrames + iAlignMask) & ~iAlignMask;
+		m_pfMixPool = new float [m_iMaxChannels * iStride + iAlignMask];
+		float *pfMixPool = m_pfMixPool;
+		while ((long(pfMixPool) & (iAlignMask << 2 | 3)) != 0)
+			++pfMixPool;
+		m_ppMixXBuffer = new float * [m_iMaxChannels];
+		m_ppMixYBuffer = new float * [m_iMaxChannels];
+		for (unsigned int i = 0; i < m_iMaxChannels; ++i) {
+			m_ppMixXBuffer[i] = pfMixPool + i * iStride;
+			m_ppMixYBuffer[i] = m_ppMixXBuffer[i];
+		}
+	}
+
+	// Done, release (ordered).
+	ATOMIC_CAS(&m_resizePending, 2, 0);
+}
+
+
+// end of qtractorAudioGraph.cpp
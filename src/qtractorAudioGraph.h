@@ -0,0 +1,226 @@
+// qtractorAudioGraph.h
+//
+/****************************************************************************
+   Copyright (C) 2005-2018, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qtractorAudioGraph_h
+#define __qtractorAudioGraph_h
+
+#include "qtractorAtomic.h"
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+
+
+// Forward declarations.
+class qtractorAudioGraph;
+class qtractorAudioEngine;
+class qtractorSessionCursor;
+class qtractorTrack;
+class qtractorBus;
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioGraphThread -- Track-chain worker thread.
+//
+
+class qtractorAudioGraphThread : public QThread
+{
+public:
+
+	// Constructor.
+	qtractorAudioGraphThread(qtractorAudioGraph *pAudioGraph);
+
+	// Destructor.
+	~qtractorAudioGraphThread();
+
+	// Thread run state accessors.
+	void setRunState(bool bRunState);
+	bool runState() const;
+
+	// Wake from executive wait condition (RT-safe).
+	void sync();
+
+protected:
+
+	// The main thread executive.
+	void run();
+
+private:
+
+	// Instance variables.
+	qtractorAudioGraph *m_pAudioGraph;
+
+	// Whether the thread is logically running.
+	volatile bool m_bRunState;
+
+	// Thread synchronization objects.
+	QMutex m_mutex;
+	QWaitCondition m_cond;
+};
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioGraph -- Parallel track-chain process scheduler.
+//
+// Each audio track renders into its own private mix-down (scratch)
+// buffer, taken from a pool pre-allocated for the whole period, so
+// that tracks sharing an output bus can be processed concurrently.
+// Tracks are only bound to the same chain when they aux-send into a
+// common bus. Once all chains are done, each output bus reduces its
+// producers scratch buffers in a second (also parallel) stage.
+// Work is claimed by a pool of worker threads, with the JACK process
+// thread taking its share of work as well.
+//
+
+class qtractorAudioGraph
+{
+public:
+
+	// Constructor; workers won't ask for realtime
+	// scheduling unless so told (eg. not for export).
+	qtractorAudioGraph(qtractorAudioEngine *pAudioEngine,
+		unsigned int iWorkers, bool bRealtime = true);
+
+	// Destructor.
+	~qtractorAudioGraph();
+
+	// Audio engine accessor.
+	qtractorAudioEngine *audioEngine() const;
+
+	// Number of worker threads.
+	unsigned int workers() const;
+
+	// Whether workers run with realtime scheduling.
+	bool isRealtime() const;
+
+	// Parallel process cycle executive (RT-safe);
+	// returns false whenever the graph can't be used on
+	// the current cycle and serial processing is due.
+	// Export (freewheeling) cycles process all tracks,
+	// non-audio ones serially, before any audio chains.
+	bool process(qtractorSessionCursor *pSessionCursor,
+		unsigned long iFrameStart, unsigned long iFrameEnd,
+		bool bExport = false);
+
+	// Worker thread executive (claim and process tasks).
+	void process_tasks();
+
+	// Worker thread deferred capacity adjustment (non RT-safe).
+	void process_resize();
+
+protected:
+
+	// Chain builder (RT-safe, no allocation).
+	int build();
+
+	// Bus slot look-up/union helpers.
+	int busSlot(qtractorBus *pBus);
+	int findSlot(int iSlot) const;
+	void unionSlots(int iSlot1, int iSlot2);
+
+	// Dispatch current stage tasks and wait for completion.
+	void dispatch(int iTasks);
+
+	// Wake all workers, whichever is idle.
+	void wakeWorkers();
+
+	// Process a single task (track-chain or bus reduction).
+	void process_task(int iTask);
+
+	// Request a deferred capacity adjustment.
+	void resize(unsigned int iTracks, unsigned int iBuses,
+		unsigned int iChannels, unsigned int iFrames);
+
+private:
+
+	// Instance variables.
+	qtractorAudioEngine *m_pAudioEngine;
+
+	// Worker thread pool.
+	unsigned int               m_iWorkers;
+	qtractorAudioGraphThread **m_ppWorkers;
+	bool                       m_bRealtime;
+
+	// Current cycle parameters.
+	qtractorSessionCursor *m_pSessionCursor;
+	unsigned long          m_iFrameStart;
+	unsigned long          m_iFrameEnd;
+	bool                   m_bExport;
+
+	// Per-track chain links.
+	unsigned int    m_iMaxTracks;
+	qtractorTrack **m_ppTracks;
+	int            *m_piSlot;
+	int            *m_piNext;
+
+	// Per-track output bus slot and mix-down links.
+	int            *m_piMixSlot;
+	int            *m_piMixNext;
+	int            *m_piMix;
+
+	// Per-bus union-find slots.
+	unsigned int    m_iMaxBuses;
+	unsigned int    m_iBuses;
+	qtractorBus   **m_ppBuses;
+	int            *m_piParent;
+	int            *m_piHead;
+	int            *m_piTail;
+
+	// Per-bus mix-down producer lists.
+	int            *m_piMixHead;
+	int            *m_piMixTail;
+
+	// Track-chain stage tasks (chain head track indexes).
+	int            *m_piTasks;
+	int             m_iTasks;
+
+	// Bus reduction stage tasks (bus slots).
+	int            *m_piReduce;
+	int             m_iReduce;
+
+	// Private mix-down (scratch) buffer pool.
+	unsigned int    m_iMaxChannels;
+	unsigned int    m_iMaxFrames;
+	float          *m_pfMixPool;
+	float         **m_ppMixXBuffer;
+	float         **m_ppMixYBuffer;
+
+	// Current dispatch stage (0=chains, 1=reduction).
+	int             m_iStage;
+	int             m_iStageTasks;
+
+	// Task dispatch counters.
+	qtractorAtomic  m_taskPending;
+	qtractorAtomic  m_taskDone;
+
+	// Deferred capacity adjustment request.
+	qtractorAtomic  m_resizePending;
+	unsigned int    m_iResizeTracks;
+	unsigned int    m_iResizeBuses;
+	unsigned int    m_iResizeChannels;
+	unsigned int    m_iResizeFrames;
+};
+
+
+#endif  // __qtractorAudioGraph_h
+
+
+// end of qtractorAudioGraph.h
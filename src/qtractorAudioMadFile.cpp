@@ -22,12 +22,54 @@
 #include "qtractorAbout.h"
 #include "qtractorAudioMadFile.h"
 
+#include "qtractorSession.h"
+
+#include <QFileInfo>
+#include <QDateTime>
+#include <QFile>
+#include <QDir>
+
 #include <sys/stat.h>
+#include <stdio.h>
+
+
+// Persistent seek index filename extension.
+static const QString c_sSeekFileExt = ".seek";
+
+// Seek index file format signature ("QTSK") and version.
+static const quint32 c_iSeekMagic = 0x4b535451;
+static const quint16 c_iSeekVersion = 1;
+
+// Seek index file header and node record layouts.
+struct qtractorAudioMadSeekHeader
+{
+	quint32 magic;
+	quint16 version;
+	quint16 flags;      // Seek index flags (see below).
+	quint32 count;
+	quint32 reserved2;
+	quint64 size;       // Source file size (bytes).
+	qint64  mtime;      // Source file modification time (msecs).
+};
+
+// Seek index flags: complete, mapped up to end-of-file.
+static const quint16 c_iSeekComplete = 0x0001;
+
+struct qtractorAudioMadSeekNode
+{
+	quint64 input;
+	quint64 output;
+	quint32 count;
+	quint32 reserved;
+};
 
 
 // Frame list mutex.
 QMutex qtractorAudioMadFile::g_mutex;
 
+// Seek index file writers mutex.
+QMutex qtractorAudioMadFile::g_saveMutex;
+
 
 //----------------------------------------------------------------------
 // class qtractorAudioMadFile -- Buffered audio file implementation.
@@ -58,6 +100,7 @@ qtractorAudioMadFile::qtractorAudioMadFile ( unsigned int iBufferSize )
 
 	// Frame mapping for sample-accurate seeking.
 	m_iSeekOffset = 0;
+	m_pFrameList  = NULL;
 }
 
 // Destructor.
@@ -85,6 +128,8 @@ bool qtractorAudioMadFile::open ( const QString& sFilename, int iMode )
 	if (m_pFile == NULL)
 		return false;
 
+	m_sFilename = sFilename;
+
 	// Create the decoded frame list.
 	m_pFrameList = createFrameList(sFilename);
 	if (m_pFrameList == NULL) {
@@ -92,12 +137,13 @@ bool qtractorAudioMadFile::open ( const QString& sFilename, int iMode )
 		return false;
 	}
 
-	// We've been here before we'll the total decoded length of the file...
+	// We've been here before we'll the total decoded length of the file,
+	// but only if it was ever mapped up to the end...
 	unsigned long iFramesEst = 0;
 
 	g_mutex.lock();
 
-	if (m_pFrameList->count() > 0)
+	if (m_pFrameList->bComplete && m_pFrameList->count() > 0)
 		iFramesEst = m_pFrameList->last().iOutputOffset;
 
 	g_mutex.unlock();
@@ -202,14 +248,16 @@ bool qtractorAudioMadFile::input (void)
 	if (iRead > 0) {
 		// Update the input offset, as for next time...
 		m_curr.iInputOffset += iRead;
-		// Time to add some frame mapping, on each 3rd iteration...
+		// Time to add some frame mapping, on each iteration...
 		g_mutex.lock();
-		if ((++m_curr.iDecodeCount % 3) == 0 && (m_pFrameList->count() < 1
-			|| m_pFrameList->last().iOutputOffset < m_curr.iOutputOffset)) {
+		++m_curr.iDecodeCount;
+		if (m_pFrameList->count() < 1
+			|| m_pFrameList->last().iOutputOffset < m_curr.iOutputOffset) {
 			m_pFrameList->append(FrameNode(
 				m_curr.iInputOffset - iRemaining,
 				m_curr.iOutputOffset,
 				m_curr.iDecodeCount));
+			m_pFrameList->bDirty = true;
 		}
 		g_mutex.unlock();
 		// Add some decode buffer guard...
@@ -332,6 +380,10 @@ int qtractorAudioMadFile::read ( float **ppFrames, unsigned int iFrames )
 				if (m_pFrameList->count() < 1 ||
 					m_pFrameList->last().iOutputOffset < m_curr.iOutputOffset)
 					m_pFrameList->append(m_curr);
+				if (!m_pFrameList->bComplete) {
+					m_pFrameList->bComplete = true;
+					m_pFrameList->bDirty = true;
+				}
 				g_mutex.unlock();
 				m_bEndOfStream = true;
 			}
@@ -475,8 +527,23 @@ void qtractorAudioMadFile::close (void)
 	}
 
 	// Frame lists are never destroyed here
-	// (they're cached for whole life-time of the program).
-	m_pFrameList = NULL;
+	// (they're cached for whole life-time of the program),
+	// but persisted whenever they've got any further...
+	if (m_pFrameList) {
+		// Take a (shallow) copy, then write it out unlocked...
+		FrameList frames;
+		g_mutex.lock();
+		if (m_pFrameList->bDirty) {
+			frames = *m_pFrameList;
+			m_pFrameList->bDirty = false;
+		}
+		g_mutex.unlock();
+		if (frames.bDirty)
+			saveFrameList(frames, m_sFilename);
+		m_pFrameList = NULL;
+	}
+
+	m_sFilename.clear();
 
 	// Reset all other state relevant variables.
 	m_bEndOfStream = false;
@@ -566,9 +633,25 @@ qtractorAudioMadFile::FrameList *qtractorAudioMadFile::createFrameList (
 	// Do the factory thing here...
 	static FrameListFactory s_lists;
 
+	QMutexLocker locker(&g_mutex);
+
 	FrameList *pFrameList = s_lists.value(sFilename, NULL);
 	if (pFrameList == NULL) {
 		pFrameList = new FrameList();
+		// Set (unique) seek index filename, along the peak files...
+		QDir dir;
+		qtractorSession *pSession = qtractorSession::getInstance();
+		if (pSession)
+			dir.setPath(pSession->sessionDir());
+		const QFileInfo fileInfo(sFilename);
+		const QString& sSeekFilePrefix
+			= QFileInfo(dir, fileInfo.fileName()).filePath();
+		const QFileInfo seekInfo(sSeekFilePrefix + '_'
+			+ QString::number(qHash(fileInfo.absoluteFilePath()), 16)
+			+ c_sSeekFileExt);
+		pFrameList->sIndexName = seekInfo.absoluteFilePath();
+		// Lazy load, whatever's been mapped before...
+		loadFrameList(pFrameList, sFilename);
 		s_lists.insert(sFilename, pFrameList);
 	}
 
@@ -576,4 +659,116 @@ qtractorAudioMadFile::FrameList *qtractorAudioMadFile::createFrameList (
 }
 
 
+// Load persistent seek index file, if still up-to-date.
+bool qtractorAudioMadFile::loadFrameList (
+	FrameList *pFrameList, const QString& sFilename )
+{
+	QFile file(pFrameList->sIndexName);
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+
+	qtractorAudioMadSeekHeader header;
+	if (file.read((char *) &header, sizeof(header)) != qint64(sizeof(header)))
+		return false;
+
+	// Old, foreign, stale or incomplete seek index?
+	const QFileInfo fileInfo(sFilename);
+	if (header.magic != c_iSeekMagic
+		|| header.version != c_iSeekVersion
+		|| header.size != quint64(fileInfo.size())
+		|| header.mtime != fileInfo.lastModified().toMSecsSinceEpoch()
+		|| file.size() != qint64(sizeof(header)
+			+ header.count * sizeof(qtractorAudioMadSeekNode)))
+		return false;
+
+	qtractorAudioMadSeekNode node;
+	for (quint32 i = 0; i < header.count; ++i) {
+		if (file.read((char *) &node, sizeof(node)) != qint64(sizeof(node)))
+			break;
+		pFrameList->append(FrameNode(node.input, node.output, node.count));
+	}
+
+	pFrameList->bComplete = (header.flags & c_iSeekComplete)
+		&& (pFrameList->count() == int(header.count));
+	pFrameList->bDirty = false;
+
+	return (pFrameList->count() > 0);
+}
+
+
+// Save persistent seek index file (from a frame list copy;
+// frame list mutex not held, as this is plain file i/o).
+bool qtractorAudioMadFile::saveFrameList (
+	const FrameList& frames, const QString& sFilename )
+{
+	// Concurrent writers (eg. several decoders of the same file)
+	// go one at a time, each one replacing the index as a whole...
+	QMutexLocker locker(&g_saveMutex);
+
+	const QFileInfo fileInfo(sFilename);
+
+	qtractorAudioMadSeekHeader header;
+
+	// Don't replace an up-to-date index by a shorter one...
+	QFile old(frames.sIndexName);
+	if (old.open(QIODevice::ReadOnly)) {
+		const bool bNewer
+			= (old.read((char *) &header, sizeof(header))
+				== qint64(sizeof(header))
+			&& header.magic == c_iSeekMagic
+			&& header.version == c_iSeekVersion
+			&& header.size == quint64(fileInfo.size())
+			&& header.mtime == fileInfo.lastModified().toMSecsSinceEpoch()
+			&& ((header.flags & c_iSeekComplete)
+				|| header.count > quint32(frames.count())));
+		old.close();
+		if (bNewer && !frames.bComplete)
+			return true;
+	}
+
+	// Write to a temporary file, then rename it over the index...
+	QFile file(frames.sIndexName + ".tmp");
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		return false;
+
+	::memset(&header, 0, sizeof(header));
+	header.magic   = c_iSeekMagic;
+	header.version = c_iSeekVersion;
+	header.flags   = (frames.bComplete ? c_iSeekComplete : 0);
+	header.count   = frames.count();
+	header.size    = fileInfo.size();
+	header.mtime   = fileInfo.lastModified().toMSecsSinceEpoch();
+
+	bool bResult = (file.write((const char *) &header, sizeof(header))
+		== qint64(sizeof(header)));
+
+	qtractorAudioMadSeekNode node;
+	::memset(&node, 0, sizeof(node));
+	QListIterator<FrameNode> iter(frames);
+	while (bResult && iter.hasNext()) {
+		const FrameNode& frame = iter.next();
+		node.input  = frame.iInputOffset;
+		node.output = frame.iOutputOffset;
+		node.count  = frame.iDecodeCount;
+		bResult = (file.write((const char *) &node, sizeof(node))
+			== qint64(sizeof(node)));
+	}
+
+	file.close();
+
+	// Don't leave an incomplete index behind...
+	if (bResult) {
+		bResult = (::rename(
+			QFile::encodeName(file.fileName()).constData(),
+			QFile::encodeName(frames.sIndexName).constData()) == 0);
+	}
+	if (!bResult) {
+		file.remove();
+		return false;
+	}
+
+	return true;
+}
+
+
 // end of qtractorAudioMadFile.cpp
@@ -24,6 +24,7 @@
 
 #include "qtractorAudioFile.h"
 
+#include <QString>
 #include <QList>
 #include <QMutex>
 
@@ -115,12 +116,27 @@ private:
 		unsigned int  iDecodeCount;     // Decoder iteration count.
 	};
 
-	// Decoded frame list type.
-	typedef QList<FrameNode> FrameList;
+	// Decoded frame list type
+	// (persistent seek index state included).
+	struct FrameList : public QList<FrameNode> {
+		// Member constructor.
+		FrameList() : bComplete(false), bDirty(false) {}
+		// Member fields.
+		QString sIndexName;             // Seek index cache file.
+		bool    bComplete;              // Mapped up to end-of-file.
+		bool    bDirty;                 // Not yet persisted.
+	};
 
 	// Frame list factory method.
 	static FrameList *createFrameList(const QString& sFilename);
 
+	// Persistent seek index file methods.
+	static bool loadFrameList(FrameList *pFrameList, const QString& sFilename);
+	static bool saveFrameList(const FrameList& frames, const QString& sFilename);
+
+	// Current file name (for seek index persistence).
+	QString m_sFilename;
+
 	// Frame list instance; 
 	FrameList *m_pFrameList;
 	// Current decoded frame node.
@@ -128,6 +144,9 @@ private:
 
 	// Frame list mutex.
 	static QMutex g_mutex;
+
+	// Seek index file writers serialization.
+	static QMutex g_saveMutex;
 };
 
 
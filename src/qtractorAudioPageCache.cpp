@@ -0,0 +1,307 @@
+// qtractorAudioPageCache.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2018, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qtractorAbout.h"
+#include "qtractorAudioPageCache.h"
+#include "qtractorAudioFile.h"
+
+#include <QFileInfo>
+#include <QDateTime>
+
+
+// Page size in frames per channel.
+static const unsigned int c_iPageFrames = (64 * 1024);
+
+// Default cache size limit (in bytes).
+static const unsigned long c_iPageCacheSize = (128 << 20);
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioPageCache -- Decoded audio page cache (singleton).
+//
+
+// Singleton instance.
+static qtractorAudioPageCache g_audioPageCache;
+
+// Singleton instance accessor (static).
+qtractorAudioPageCache *qtractorAudioPageCache::getInstance (void)
+{
+	return &g_audioPageCache;
+}
+
+
+// Constructor.
+qtractorAudioPageCache::qtractorAudioPageCache (void)
+	: m_iFileIds(0), m_iSize(0), m_iMaxSize(c_iPageCacheSize)
+{
+}
+
+
+// Default destructor.
+qtractorAudioPageCache::~qtractorAudioPageCache (void)
+{
+	QMutexLocker locker(&m_mutex);
+
+	Page *pPage = m_list.first();
+	while (pPage) {
+		Page *pNextPage = pPage->next();
+		m_list.unlink(pPage);
+		deletePage(pPage);
+		pPage = pNextPage;
+	}
+
+	m_pages.clear();
+	m_iSize = 0;
+}
+
+
+// Page size (in frames per channel).
+unsigned int qtractorAudioPageCache::pageFrames (void)
+{
+	return c_iPageFrames;
+}
+
+
+// Unique file identifier (for page keys).
+unsigned int qtractorAudioPageCache::fileId ( const QString& sFilename,
+	unsigned short iChannels, unsigned int iSampleRate )
+{
+	// Any file modification makes it a whole new one...
+	const QFileInfo info(sFilename);
+	const QString& sKey = info.absoluteFilePath()
+		+ ':' + QString::number(iChannels)
+		+ ':' + QString::number(iSampleRate)
+		+ ':' + QString::number(info.size())
+		+ ':' + QString::number(info.lastModified().toMSecsSinceEpoch());
+
+	QMutexLocker locker(&m_mutex);
+
+	QHash<QString, FileItem>::Iterator iter = m_fileIds.find(sKey);
+	if (iter == m_fileIds.end()) {
+		FileItem item;
+		item.id   = ++m_iFileIds;
+		item.refs = 0;
+		iter = m_fileIds.insert(sKey, item);
+	}
+
+	++(iter.value().refs);
+
+	return iter.value().id;
+}
+
+
+void qtractorAudioPageCache::releaseFileId ( unsigned int iFileId )
+{
+	QMutexLocker locker(&m_mutex);
+
+	QMutableHashIterator<QString, FileItem> iter(m_fileIds);
+	while (iter.hasNext()) {
+		FileItem& item = iter.next().value();
+		if (item.id != iFileId)
+			continue;
+		if (--item.refs > 0)
+			return;
+		iter.remove();
+		break;
+	}
+
+	// Drop all (unreferenced) pages of the file...
+	Page *pPage = m_list.first();
+	while (pPage) {
+		Page *pNextPage = pPage->next();
+		if ((pPage->key >> 40) == iFileId && pPage->refs == 0) {
+			m_list.unlink(pPage);
+			m_pages.remove(pPage->key);
+			m_iSize -= pPage->channels * c_iPageFrames * sizeof(float);
+			deletePage(pPage);
+		}
+		pPage = pNextPage;
+	}
+}
+
+
+// Page reference acquire (decode on miss).
+qtractorAudioPageCache::Page *qtractorAudioPageCache::acquirePage (
+	qtractorAudioFile *pFile, unsigned int iFileId, unsigned long iPage,
+	unsigned long& iFileOffset )
+{
+	const quint64 iKey = (quint64(iFileId) << 40) | quint64(iPage);
+
+	m_mutex.lock();
+
+	Page *pPage = m_pages.value(iKey, NULL);
+	if (pPage) {
+		++(pPage->refs);
+		m_list.unlink(pPage);
+		m_list.prepend(pPage);
+		m_mutex.unlock();
+		return pPage;
+	}
+
+	m_mutex.unlock();
+
+	// Decode it in (not locked), seeking only when not
+	// already there (ie. sequential misses don't)...
+	const unsigned long iOffset = iPage * c_iPageFrames;
+	if (iFileOffset != iOffset) {
+		if (!pFile->seek(iOffset)) {
+			iFileOffset = (unsigned long) -1;
+			return NULL;
+		}
+		iFileOffset = iOffset;
+	}
+
+	const unsigned short iChannels = pFile->channels();
+	pPage = createPage(iKey, iPage, iChannels);
+
+	float **ppFrames = new float * [iChannels];
+	while (pPage->frames < c_iPageFrames) {
+		for (unsigned short i = 0; i < iChannels; ++i)
+			ppFrames[i] = pPage->buffers[i] + pPage->frames;
+		const int nread = pFile->read(ppFrames, c_iPageFrames - pPage->frames);
+		if (nread < 1)
+			break;
+		pPage->frames += nread;
+	}
+	delete [] ppFrames;
+
+	iFileOffset += pPage->frames;
+
+	// Past end-of-file?
+	if (pPage->frames < 1) {
+		deletePage(pPage);
+		return NULL;
+	}
+
+	QMutexLocker locker(&m_mutex);
+
+	// Someone else might have been quicker...
+	Page *pOldPage = m_pages.value(iKey, NULL);
+	if (pOldPage) {
+		deletePage(pPage);
+		pPage = pOldPage;
+		m_list.unlink(pPage);
+	} else {
+		m_pages.insert(iKey, pPage);
+		m_iSize += iChannels * c_iPageFrames * sizeof(float);
+	}
+
+	++(pPage->refs);
+	m_list.prepend(pPage);
+
+	evict(m_iMaxSize);
+
+	return pPage;
+}
+
+
+// Page reference release.
+void qtractorAudioPageCache::releasePage ( Page *pPage )
+{
+	QMutexLocker locker(&m_mutex);
+
+	if (pPage->refs > 0)
+		--(pPage->refs);
+
+	evict(m_iMaxSize);
+}
+
+
+// Cache size limit (in bytes; zero disables caching).
+void qtractorAudioPageCache::setMaxSize ( unsigned long iMaxSize )
+{
+	QMutexLocker locker(&m_mutex);
+
+	m_iMaxSize = iMaxSize;
+
+	evict(m_iMaxSize);
+}
+
+unsigned long qtractorAudioPageCache::maxSize (void) const
+{
+	return m_iMaxSize;
+}
+
+
+// Current cache size (in bytes).
+unsigned long qtractorAudioPageCache::size (void) const
+{
+	return m_iSize;
+}
+
+
+// Drop all unreferenced pages.
+void qtractorAudioPageCache::clear (void)
+{
+	QMutexLocker locker(&m_mutex);
+
+	evict(0);
+}
+
+
+// Drop least recently used unreferenced pages over the limit.
+void qtractorAudioPageCache::evict ( unsigned long iMaxSize )
+{
+	Page *pPage = m_list.last();
+	while (pPage && m_iSize > iMaxSize) {
+		Page *pPrevPage = pPage->prev();
+		if (pPage->refs == 0) {
+			m_list.unlink(pPage);
+			m_pages.remove(pPage->key);
+			m_iSize -= pPage->channels * c_iPageFrames * sizeof(float);
+			deletePage(pPage);
+		}
+		pPage = pPrevPage;
+	}
+}
+
+
+// Page (de)allocators.
+qtractorAudioPageCache::Page *qtractorAudioPageCache::createPage (
+	quint64 iKey, unsigned long iPage, unsigned short iChannels )
+{
+	Page *pPage = new Page();
+
+	pPage->key      = iKey;
+	pPage->index    = iPage;
+	pPage->channels = iChannels;
+	pPage->frames   = 0;
+	pPage->buffers  = new float * [iChannels];
+	pPage->refs     = 0;
+
+	for (unsigned short i = 0; i < iChannels; ++i)
+		pPage->buffers[i] = new float [c_iPageFrames];
+
+	return pPage;
+}
+
+
+void qtractorAudioPageCache::deletePage ( Page *pPage )
+{
+	for (unsigned short i = 0; i < pPage->channels; ++i)
+		delete [] pPage->buffers[i];
+	delete [] pPage->buffers;
+
+	delete pPage;
+}
+
+
+// end of qtractorAudioPageCache.cpp
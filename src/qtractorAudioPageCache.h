@@ -0,0 +1,134 @@
+// qtractorAudioPageCache.h
+//
+/****************************************************************************
+   Copyright (C) 2005-2018, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qtractorAudioPageCache_h
+#define __qtractorAudioPageCache_h
+
+#include "qtractorList.h"
+
+#include <QString>
+#include <QHash>
+#include <QMutex>
+
+
+// Forward declarations.
+class qtractorAudioFile;
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioPageCache -- Decoded audio page cache (singleton).
+//
+// A process-wide, size-bounded LRU cache of fixed-size pages of
+// decoded audio frames, shared by all audio buffers reading the
+// very same file (eg. several takes or copies of one long stem).
+//
+
+class qtractorAudioPageCache
+{
+public:
+
+	// Constructor.
+	qtractorAudioPageCache();
+
+	// Default destructor.
+	~qtractorAudioPageCache();
+
+	// Decoded audio frames page.
+	struct Page : public qtractorList<Page>::Link
+	{
+		quint64         key;
+		unsigned long   index;
+		unsigned short  channels;
+		unsigned int    frames;
+		float         **buffers;
+		unsigned int    refs;
+	};
+
+	// Page size (in frames per channel).
+	static unsigned int pageFrames();
+
+	// Unique file identifier (for page keys) reference
+	// acquire and release; all pages of a file are dropped
+	// once its last reference is gone.
+	unsigned int fileId(const QString& sFilename,
+		unsigned short iChannels, unsigned int iSampleRate);
+	void releaseFileId(unsigned int iFileId);
+
+	// Page reference acquire (decode on miss) and release;
+	// the current file position (in frames) is given and
+	// updated, so that sequential misses don't re-seek.
+	Page *acquirePage(qtractorAudioFile *pFile, unsigned int iFileId,
+		unsigned long iPage, unsigned long& iFileOffset);
+	void releasePage(Page *pPage);
+
+	// Cache size limit (in bytes; zero disables caching).
+	void setMaxSize(unsigned long iMaxSize);
+	unsigned long maxSize() const;
+
+	// Current cache size (in bytes).
+	unsigned long size() const;
+
+	// Drop all unreferenced pages.
+	void clear();
+
+	// Singleton instance accessor.
+	static qtractorAudioPageCache *getInstance();
+
+protected:
+
+	// Drop least recently used unreferenced pages over the limit.
+	void evict(unsigned long iMaxSize);
+
+	// Page (de)allocators.
+	static Page *createPage(quint64 iKey, unsigned long iPage,
+		unsigned short iChannels);
+	static void deletePage(Page *pPage);
+
+private:
+
+	// Instance variables.
+	QMutex m_mutex;
+
+	// File identifier entry.
+	struct FileItem
+	{
+		unsigned int id;
+		unsigned int refs;
+	};
+
+	QHash<QString, FileItem> m_fileIds;
+
+	unsigned int m_iFileIds;
+
+	QHash<quint64, Page *> m_pages;
+
+	// Most recently used pages first.
+	qtractorList<Page> m_list;
+
+	unsigned long m_iSize;
+	unsigned long m_iMaxSize;
+};
+
+
+#endif  // __qtractorAudioPageCache_h
+
+
+// end of qtractorAudioPageCache.h
@@ -48,12 +48,24 @@ static const unsigned int c_iPeakFrames = (8 * 1024);
 // Default peak period as a digest representation in frames per channel.
 static const unsigned short c_iPeakPeriod = 1024;
 
+// Number of audio file buffers read between progress notifications.
+static const unsigned int c_iPeakChunks = 32;
+
 // Default peak filename extension.
 static const QString c_sPeakFileExt = ".peak";
 
+// Peak file format signature ("QTPK") and version.
+static const unsigned int c_iPeakMagic = 0x4b505451;
+static const unsigned short c_iPeakVersion = 2;
+
+// Maximum number of peak resolution levels and decimation ratio
+// between each consecutive level (mipmapped peak pyramid).
+static const unsigned short c_iPeakLevels = 8;
+static const unsigned short c_iPeakRatio = 16;
+
 
 //----------------------------------------------------------------------
-// class qtractorAudioPeakThread -- Audio Peak file thread.
+// class qtractorAudioPeakThread -- Audio Peak file (pool) thread.
 //
 
 class qtractorAudioPeakThread : public QThread
@@ -61,7 +73,7 @@ class qtractorAudioPeakThread : public QThread
 public:
 
 	// Constructor.
-	qtractorAudioPeakThread(unsigned int iSyncSize = 128);
+	qtractorAudioPeakThread(qtractorAudioPeakFactory *pPeakFactory);
 	// Destructor.
 	~qtractorAudioPeakThread();
 
@@ -69,9 +81,6 @@ public:
 	void setRunState(bool bRunState);
 	bool runState() const;
 
-	// Wake from executive wait condition.
-	void sync(qtractorAudioPeakFile *pPeakFile = NULL);
-
 protected:
 
 	// The main thread executive.
@@ -87,21 +96,12 @@ protected:
 
 private:
 
-	// The peak file queue instance reference.
-	unsigned int            m_iSyncSize;
-	unsigned int            m_iSyncMask;
-	qtractorAudioPeakFile **m_ppSyncItems;
-
-	volatile unsigned int   m_iSyncRead;
-	volatile unsigned int   m_iSyncWrite;
+	// The peak file factory (and queue) reference.
+	qtractorAudioPeakFactory *m_pPeakFactory;
 
 	// Whether the thread is logically running.
 	volatile bool m_bRunState;
 
-	// Thread synchronization objects.
-	QMutex m_mutex;
-	QWaitCondition m_cond;
-
 	// Current audio peak file instance.
 	qtractorAudioPeakFile *m_pPeakFile;
 
@@ -114,17 +114,10 @@ private:
 
 
 // Constructor.
-qtractorAudioPeakThread::qtractorAudioPeakThread ( unsigned int iSyncSize )
+qtractorAudioPeakThread::qtractorAudioPeakThread (
+	qtractorAudioPeakFactory *pPeakFactory ) : QThread()
 {
-	m_iSyncSize = (64 << 1);
-	while (m_iSyncSize < iSyncSize)
-		m_iSyncSize <<= 1;
-	m_iSyncMask = (m_iSyncSize - 1);
-	m_ppSyncItems = new qtractorAudioPeakFile * [m_iSyncSize];
-	m_iSyncRead   = 0;
-	m_iSyncWrite  = 0;
-
-	::memset(m_ppSyncItems, 0, m_iSyncSize * sizeof(qtractorAudioPeakFile *));
+	m_pPeakFactory = pPeakFactory;
 
 	m_bRunState = false;
 
@@ -137,15 +130,12 @@ qtractorAudioPeakThread::qtractorAudioPeakThread ( unsigned int iSyncSize )
 // Destructor.
 qtractorAudioPeakThread::~qtractorAudioPeakThread (void)
 {
-	delete [] m_ppSyncItems;
 }
 
 
 // Run state accessor.
 void qtractorAudioPeakThread::setRunState ( bool bRunState )
 {
-//	QMutexLocker locker(&m_mutex);
-
 	m_bRunState = bRunState;
 }
 
@@ -155,49 +145,6 @@ bool qtractorAudioPeakThread::runState (void) const
 }
 
 
-// Wake from executive wait condition.
-void qtractorAudioPeakThread::sync ( qtractorAudioPeakFile *pPeakFile )
-{
-	if (pPeakFile == NULL) {
-		unsigned int r = m_iSyncRead;
-		unsigned int w = m_iSyncWrite;
-		while (r != w) {
-			qtractorAudioPeakFile *pSyncItem = m_ppSyncItems[r];
-			if (pSyncItem)
-				pSyncItem->setWaitSync(false);
-			++r &= m_iSyncMask;
-			w = m_iSyncWrite;
-		}
-	//	m_iSyncRead = r;
-	} else {
-		// !pPeakFile->isWaitSync()
-		unsigned int n;
-		unsigned int r = m_iSyncRead;
-		unsigned int w = m_iSyncWrite;
-		if (w > r) {
-			n = ((r - w + m_iSyncSize) & m_iSyncMask) - 1;
-		} else if (r > w) {
-			n = (r - w) - 1;
-		} else {
-			n = m_iSyncSize - 1;
-		}
-		if (n > 0) {
-			pPeakFile->setWaitSync(true);
-			m_ppSyncItems[w] = pPeakFile;
-			m_iSyncWrite = (w + 1) & m_iSyncMask;
-		}
-	}
-
-	if (m_mutex.tryLock()) {
-		m_cond.wakeAll();
-		m_mutex.unlock();
-	}
-#ifdef CONFIG_DEBUG_0
-	else qDebug("qtractorAudioPeakThread[%p]::sync(): tryLock() failed.", this);
-#endif
-}
-
-
 // The main thread executive cycle.
 void qtractorAudioPeakThread::run (void)
 {
@@ -205,42 +152,32 @@ void qtractorAudioPeakThread::run (void)
 	qDebug("qtractorAudioPeakThread[%p]::run(): started...", this);
 #endif
 
-	m_mutex.lock();
-
 	m_bRunState = true;
 
 	while (m_bRunState) {
-		// Do whatever we must, then wait for more...
-		unsigned int r = m_iSyncRead;
-		unsigned int w = m_iSyncWrite;
-		while (m_bRunState && r != w) {
-			m_pPeakFile = m_ppSyncItems[r];
-			if (m_pPeakFile && m_pPeakFile->isWaitSync()) {
-				if (openPeakFile()) {
-					// Go ahead with the whole bunch...
-					while (writePeakFile());
-					// We're done.
-					closePeakFile();
+		// Take next pending peak file, or wait for more...
+		m_pPeakFile = m_pPeakFactory->takePeakFile(this);
+		if (m_pPeakFile == NULL)
+			continue;
+		if (m_pPeakFile->isWaitSync() && openPeakFile()) {
+			// Go ahead with the whole bunch, unless cancelled...
+			unsigned int iChunk = 0;
+			while (m_bRunState && m_pPeakFile->isWaitSync()
+				&& writePeakFile()) {
+				// Let partial results show up, now and then...
+				if (++iChunk >= c_iPeakChunks) {
+					notifyPeakEvent();
+					iChunk = 0;
 				}
-				m_pPeakFile->setWaitSync(false);
-				m_pPeakFile = NULL;
 			}
-			m_ppSyncItems[r] = NULL;
-			++r &= m_iSyncMask;
-			w = m_iSyncWrite;
-		}
-		m_iSyncRead = r;
-		// Are we still in the game?
-		if (m_bRunState) {
-			// Send notification event, anyway...
-			notifyPeakEvent();
-			// Wait for sync...
-			m_cond.wait(&m_mutex);
+			// We're done.
+			closePeakFile();
 		}
+		m_pPeakFile->setWaitSync(false);
+		m_pPeakFactory->donePeakFile(m_pPeakFile);
+		m_pPeakFile = NULL;
 	}
 
-	m_mutex.unlock();
-
 #ifdef CONFIG_DEBUG_0
 	qDebug("qtractorAudioPeakThread[%p]::run(): stopped.\n", this);
 #endif
@@ -316,9 +253,16 @@ void qtractorAudioPeakThread::closePeakFile (void)
 	qDebug("qtractorAudioPeakThread::closePeakFile(%p)", m_pPeakFile);
 #endif
 
+	// Cancelled while in the middle of it?
+	const bool bAborted = (!m_bRunState || !m_pPeakFile->isWaitSync());
+
 	// Always force target file close.
 	m_pPeakFile->closeWrite();
 
+	// Don't leave an incomplete peak file behind...
+	if (bAborted)
+		m_pPeakFile->remove();
+
 	// Get rid of physical used stuff.
 	if (m_ppAudioFrames) {
 		const unsigned short iChannels = m_pAudioFile->channels();
@@ -366,13 +310,20 @@ qtractorAudioPeakFile::qtractorAudioPeakFile (
 
 	m_openMode = None;
 
+	m_peakHeader.magic    = 0;
+	m_peakHeader.version  = 0;
 	m_peakHeader.period   = 0;
 	m_peakHeader.channels = 0;
+	m_peakHeader.levels   = 0;
+	m_peakHeader.length   = 0;
+
+	m_pMapped      = NULL;
 
 	m_pBuffer      = NULL;
 	m_iBuffSize    = 0;
 	m_iBuffLength  = 0;
 	m_iBuffOffset  = 0;
+	m_iBuffLevel   = 0;
 
 	m_bWaitSync = false;
 
@@ -413,8 +364,14 @@ bool qtractorAudioPeakFile::openRead (void)
 		return true;
 
 	// Are we still waiting for its creation?
-	if (m_bWaitSync)
+	if (m_bWaitSync) {
+		// Being visible, should get ahead of the queue...
+		qtractorAudioPeakFactory *pPeakFactory
+			= qtractorAudioPeakFactory::getInstance();
+		if (pPeakFactory)
+			pPeakFactory->sync(this);
 		return false;
+	}
 
 	// Need some preliminary file information...
 	QFileInfo fileInfo(m_sFilename);
@@ -444,6 +401,26 @@ bool qtractorAudioPeakFile::openRead (void)
 		return false;
 	}
 
+	// Old, foreign or incomplete peak file format?
+	if (m_peakHeader.magic != c_iPeakMagic
+		|| m_peakHeader.version != c_iPeakVersion
+		|| m_peakHeader.levels < 1
+		|| m_peakHeader.levels > c_iPeakLevels
+		|| m_peakFile.size() != qint64(levelOffset(m_peakHeader.levels))) {
+		m_peakFile.close();
+		m_peakHeader.levels = 0;
+		locker.unlock();
+		// Must be (re)created...
+		qtractorAudioPeakFactory *pPeakFactory
+			= qtractorAudioPeakFactory::getInstance();
+		if (pPeakFactory)
+			pPeakFactory->sync(this);
+		return false;
+	}
+
+	// Map the whole thing, if possible...
+	m_pMapped = m_peakFile.map(0, m_peakFile.size());
+
 	// Set open mode...
 	m_openMode = Read;
 
@@ -456,6 +433,9 @@ bool qtractorAudioPeakFile::openRead (void)
 	qDebug("frame       = %lu", sizeof(Frame));
 	qDebug("period      = %d", m_peakHeader.period);
 	qDebug("channels    = %d", m_peakHeader.channels);
+	qDebug("levels      = %d", m_peakHeader.levels);
+	qDebug("length      = %u", m_peakHeader.length);
+	qDebug("mapped      = %p", m_pMapped);
 	qDebug("---");
 #endif
 
@@ -472,6 +452,10 @@ void qtractorAudioPeakFile::closeRead (void)
 
 	// Close file.
 	if (m_openMode == Read) {
+		if (m_pMapped) {
+			m_peakFile.unmap(m_pMapped);
+			m_pMapped = NULL;
+		}
 		m_peakFile.close();
 		m_openMode = None;
 	}
@@ -483,6 +467,7 @@ void qtractorAudioPeakFile::closeRead (void)
 	m_iBuffSize   = 0;
 	m_iBuffLength = 0;
 	m_iBuffOffset = 0;
+	m_iBuffLevel  = 0;
 }
 
 
@@ -520,23 +505,84 @@ unsigned short qtractorAudioPeakFile::channels (void)
 	return m_peakHeader.channels;
 }
 
+unsigned short qtractorAudioPeakFile::levels (void)
+{
+	return m_peakHeader.levels;
+}
+
+
+// Peak frames length at given resolution level.
+unsigned long qtractorAudioPeakFile::length ( unsigned short iLevel )
+{
+	unsigned long iLength = m_peakHeader.length;
+	for (unsigned short i = 0; i < iLevel; ++i)
+		iLength = (iLength + c_iPeakRatio - 1) / c_iPeakRatio;
+
+	return iLength;
+}
+
+
+// Peak file offset of given resolution level (in bytes).
+unsigned long qtractorAudioPeakFile::levelOffset ( unsigned short iLevel ) const
+{
+	const unsigned int nsize = m_peakHeader.channels * sizeof(Frame);
+
+	unsigned long iOffset = sizeof(Header);
+	unsigned long iLength = m_peakHeader.length;
+	for (unsigned short i = 0; i < iLevel; ++i) {
+		iOffset += iLength * nsize;
+		iLength  = (iLength + c_iPeakRatio - 1) / c_iPeakRatio;
+	}
+
+	return iOffset;
+}
+
 
 // Read frames from peak file.
 qtractorAudioPeakFile::Frame *qtractorAudioPeakFile::read (
-	unsigned long iPeakOffset, unsigned int iPeakLength )
+	unsigned long iPeakOffset, unsigned int iPeakLength, unsigned short iLevel )
 {
 	// Must be open for something...
 	if (m_openMode == None)
 		return NULL;
 
+	// Memory-mapped levels are served directly (no locking, no copy)...
+	if (m_pMapped && iLevel < m_peakHeader.levels) {
+		const unsigned long iLength = length(iLevel);
+		Frame *pFrames = (Frame *) (m_pMapped + levelOffset(iLevel));
+		if (iPeakOffset + iPeakLength <= iLength)
+			return pFrames + m_peakHeader.channels * iPeakOffset;
+		// Tail overrun: take the remains and zero the rest...
+		QMutexLocker locker(&m_mutex);
+		m_iBuffLength = 0;
+		resizeBuffer(0, iPeakLength);
+		const unsigned int nsize = m_peakHeader.channels * sizeof(Frame);
+		const unsigned int nread
+			= (iPeakOffset < iLength ? iLength - iPeakOffset : 0);
+		if (nread > 0) {
+			::memcpy(m_pBuffer,
+				pFrames + m_peakHeader.channels * iPeakOffset, nread * nsize);
+		}
+		::memset(m_pBuffer + m_peakHeader.channels * nread, 0,
+			(iPeakLength - nread) * nsize);
+		return m_pBuffer;
+	}
+
 	// Make things critical...
 	QMutexLocker locker(&m_mutex);
 
 #ifdef CONFIG_DEBUG_0
-	qDebug("qtractorAudioPeakFile[%p]::read(%lu, %u) [%lu, %u, %u]", this,
-		iPeakOffset, iPeakLength, m_iBuffOffset, m_iBuffLength, m_iBuffSize);
+	qDebug("qtractorAudioPeakFile[%p]::read(%lu, %u, %u) [%lu, %u, %u]", this,
+		iPeakOffset, iPeakLength, iLevel, m_iBuffOffset, m_iBuffLength, m_iBuffSize);
 #endif
 
+	// Buffer cache is only good for the same level...
+	if (m_iBuffLevel != iLevel) {
+		m_iBuffLevel  = iLevel;
+		m_iBuffLength = 0;
+		m_iBuffOffset = 0;
+	}
+
 	// Cache effect, only valid if we're really reading...
 	const unsigned long iPeakEnd = iPeakOffset + iPeakLength;
 	if (iPeakOffset >= m_iBuffOffset && m_iBuffOffset < iPeakEnd) {
@@ -560,14 +606,13 @@ qtractorAudioPeakFile::Frame *qtractorAudioPeakFile::read (
 }
 
 
-// Read frames from peak file into local buffer cache.
-unsigned int qtractorAudioPeakFile::readBuffer (
-	unsigned int iBuffOffset, unsigned long iPeakOffset, unsigned int iPeakLength )
+// Local buffer cache (re)allocation.
+void qtractorAudioPeakFile::resizeBuffer (
+	unsigned int iBuffOffset, unsigned int iPeakLength )
 {
-	const unsigned int nsize = m_peakHeader.channels * sizeof(Frame);
-
 	// Shall we reallocate?
 	if (iBuffOffset + iPeakLength > m_iBuffSize) {
+		const unsigned int nsize = m_peakHeader.channels * sizeof(Frame);
 		Frame *pOldBuffer = m_pBuffer;
 		m_iBuffSize += (iPeakLength << 1);
 		m_pBuffer = new Frame [m_peakHeader.channels * m_iBuffSize];
@@ -576,6 +621,17 @@ unsigned int qtractorAudioPeakFile::readBuffer (
 			delete [] pOldBuffer;
 		}
 	}
+}
+
+
+// Read frames from peak file into local buffer cache.
+unsigned int qtractorAudioPeakFile::readBuffer (
+	unsigned int iBuffOffset, unsigned long iPeakOffset, unsigned int iPeakLength )
+{
+	const unsigned int nsize = m_peakHeader.channels * sizeof(Frame);
+
+	// Shall we reallocate?
+	resizeBuffer(iBuffOffset, iPeakLength);
 
 #ifdef CONFIG_DEBUG_0
 	qDebug("qtractorAudioPeakFile[%p]::readBuffer(%u, %lu, %u) [%lu, %u, %u]",
@@ -589,7 +645,7 @@ unsigned int qtractorAudioPeakFile::readBuffer (
 	const unsigned int iLength  = iPeakLength * nsize;
 
 	int nread = 0;
-	if (m_peakFile.seek(sizeof(Header) + iOffset))
+	if (m_peakFile.seek(levelOffset(m_iBuffLevel) + iOffset))
 		nread = int(m_peakFile.read(&pBuffer[0], iLength));
 
 	// Zero the remaining...
@@ -619,10 +675,19 @@ bool qtractorAudioPeakFile::openWrite (
 
 	// We'll force (re)open if already reading (duh?)
 	if (m_openMode == Read) {
+		if (m_pMapped) {
+			m_peakFile.unmap(m_pMapped);
+			m_pMapped = NULL;
+		}
 		m_peakFile.close();
 		m_openMode = None;
 	}
 
+	// Any cached frames are now stale...
+	m_iBuffLength = 0;
+	m_iBuffOffset = 0;
+	m_iBuffLevel  = 0;
+
 	// Just open and go ahead with it...
 	if (!m_peakFile.open(QIODevice::ReadWrite | QIODevice::Truncate))
 		return false;
@@ -630,9 +695,13 @@ bool qtractorAudioPeakFile::openWrite (
 	// Set open mode...
 	m_openMode = Write;
 
-	// Initialize header...
+	// Initialize header (single level, still incomplete)...
+	m_peakHeader.magic    = c_iPeakMagic;
+	m_peakHeader.version  = c_iPeakVersion;
 	m_peakHeader.period   = pPeakFactory->peakPeriod();
 	m_peakHeader.channels = iChannels;
+	m_peakHeader.levels   = 1;
+	m_peakHeader.length   = 0;
 
 	// Write peak file header.
 	if (m_peakFile.write((const char *) &m_peakHeader, sizeof(Header))
@@ -701,10 +770,11 @@ void qtractorAudioPeakFile::closeWrite (void)
 	// Make things critical...
 	QMutexLocker locker(&m_mutex);
 
-	// Flush and close...
+	// Flush, complete and close...
 	if (m_openMode == Write) {
 		if (m_pWriter && m_pWriter->npeak > 0)
 			writeFrame();
+		writeLevels();
 		m_peakFile.close();
 		m_openMode = None;
 	}
@@ -797,6 +867,80 @@ void qtractorAudioPeakFile::writeFrame (void)
 }
 
 
+// Append the lower resolution levels and finalize header.
+void qtractorAudioPeakFile::writeLevels (void)
+{
+	if (m_pWriter == NULL)
+		return;
+
+	const unsigned short iChannels = m_peakHeader.channels;
+	const unsigned int nsize = iChannels * sizeof(Frame);
+
+	unsigned long iLength = m_pWriter->offset / nsize;
+
+	m_peakHeader.levels = 1;
+	m_peakHeader.length = iLength;
+
+	// Read back the full resolution level...
+	Frame *pFrames = NULL;
+	if (iLength > c_iPeakRatio) {
+		pFrames = new Frame [iChannels * iLength];
+		if (!m_peakFile.seek(sizeof(Header))
+			|| m_peakFile.read((char *) pFrames, iLength * nsize)
+				!= qint64(iLength * nsize)) {
+			delete [] pFrames;
+			pFrames = NULL;
+		}
+	}
+
+	// Decimate each level from the previous one...
+	unsigned long iOffset = sizeof(Header) + iLength * nsize;
+	while (pFrames && m_peakHeader.levels < c_iPeakLevels
+		&& iLength > c_iPeakRatio) {
+		const unsigned long iLength2
+			= (iLength + c_iPeakRatio - 1) / c_iPeakRatio;
+		Frame *pFrames2 = new Frame [iChannels * iLength2];
+		for (unsigned long i2 = 0; i2 < iLength2; ++i2) {
+			const unsigned long i1 = i2 * c_iPeakRatio;
+			unsigned long j1 = i1 + c_iPeakRatio;
+			if (j1 > iLength)
+				j1 = iLength;
+			for (unsigned short k = 0; k < iChannels; ++k) {
+				Frame *pNewFrame = &pFrames2[iChannels * i2 + k];
+				Frame *pOldFrame = &pFrames[iChannels * i1 + k];
+				*pNewFrame = *pOldFrame;
+				for (unsigned long j = i1 + 1; j < j1; ++j) {
+					pOldFrame += iChannels;
+					if (pNewFrame->max < pOldFrame->max)
+						pNewFrame->max = pOldFrame->max;
+					if (pNewFrame->min < pOldFrame->min)
+						pNewFrame->min = pOldFrame->min;
+					if (pNewFrame->rms < pOldFrame->rms)
+						pNewFrame->rms = pOldFrame->rms;
+				}
+			}
+		}
+		delete [] pFrames;
+		pFrames = pFrames2;
+		iLength = iLength2;
+		if (!m_peakFile.seek(iOffset)
+			|| m_peakFile.write((const char *) pFrames, iLength * nsize)
+				!= qint64(iLength * nsize))
+			break;
+		iOffset += iLength * nsize;
+		++m_peakHeader.levels;
+	}
+
+	if (pFrames)
+		delete [] pFrames;
+
+	// Drop any incomplete level and finalize header...
+	m_peakFile.resize(levelOffset(m_peakHeader.levels));
+	if (m_peakFile.seek(0))
+		m_peakFile.write((const char *) &m_peakHeader, sizeof(Header));
+}
+
+
 // Reference count methods.
 void qtractorAudioPeakFile::addRef (void)
 {
@@ -903,8 +1047,18 @@ qtractorAudioPeakFile::Frame *qtractorAudioPeak::peakFrames (
 	if (iPeakPeriod < 1)
 		return NULL;
 
+	// Pick the coarsest resolution level still good for the width...
+	const unsigned short iPeakLevels = m_pPeakFile->levels();
+	unsigned short iPeakLevel = 0;
+	unsigned long iLevelPeriod = iPeakPeriod;
+	while (iPeakLevel + 1 < iPeakLevels && iFrameLength
+			/ (iLevelPeriod * c_iPeakRatio) >= (unsigned long) width) {
+		iLevelPeriod *= c_iPeakRatio;
+		++iPeakLevel;
+	}
+
 	// Peak frames length estimation...
-	const unsigned int iPeakLength = (iFrameLength / iPeakPeriod);
+	const unsigned int iPeakLength = (iFrameLength / iLevelPeriod);
 	if (iPeakLength < 1)
 		return NULL;
 
@@ -933,9 +1087,9 @@ qtractorAudioPeakFile::Frame *qtractorAudioPeak::peakFrames (
 	}
 
 	// Grab them in...
-	const unsigned long iPeakOffset = (iFrameOffset / iPeakPeriod);
+	const unsigned long iPeakOffset = (iFrameOffset / iLevelPeriod);
 	qtractorAudioPeakFile::Frame *pPeakFrames
-		= m_pPeakFile->read(iPeakOffset, iPeakLength);
+		= m_pPeakFile->read(iPeakOffset, iPeakLength, iPeakLevel);
 	if (pPeakFrames == NULL)
 		return NULL;
 
@@ -1002,7 +1156,8 @@ qtractorAudioPeakFactory *qtractorAudioPeakFactory::getInstance (void)
 // Constructor.
 qtractorAudioPeakFactory::qtractorAudioPeakFactory ( QObject *pParent )
 	: QObject(pParent), m_bAutoRemove(false),
-		m_pPeakThread(NULL), m_iPeakPeriod(c_iPeakPeriod)
+		m_iPeakThreads(0), m_ppPeakThreads(NULL),
+		m_iPeakBusy(0), m_iPeakPeriod(c_iPeakPeriod)
 {
 	// Pseudo-singleton reference setup.
 	g_pPeakFactory = this;
@@ -1012,14 +1167,22 @@ qtractorAudioPeakFactory::qtractorAudioPeakFactory ( QObject *pParent )
 // Default destructor.
 qtractorAudioPeakFactory::~qtractorAudioPeakFactory (void)
 {
-	if (m_pPeakThread) {
-		if (m_pPeakThread->isRunning()) do {
-			m_pPeakThread->setRunState(false);
-		//	m_pPeakThread->terminate();
-			m_pPeakThread->sync();
-		} while (!m_pPeakThread->wait(100));
-		delete m_pPeakThread;
-		m_pPeakThread = NULL;
+	if (m_ppPeakThreads) {
+		unsigned int i;
+		for (i = 0; i < m_iPeakThreads; ++i)
+			m_ppPeakThreads[i]->setRunState(false);
+		for (i = 0; i < m_iPeakThreads; ++i) {
+			qtractorAudioPeakThread *pPeakThread = m_ppPeakThreads[i];
+			if (pPeakThread->isRunning()) do {
+				pPeakThread->setRunState(false);
+			//	pPeakThread->terminate();
+				sync();
+			} while (!pPeakThread->wait(100));
+			delete pPeakThread;
+		}
+		delete [] m_ppPeakThreads;
+		m_ppPeakThreads = NULL;
+		m_iPeakThreads = 0;
 	}
 
 	cleanup();
@@ -1038,6 +1201,7 @@ void qtractorAudioPeakFactory::setPeakPeriod ( unsigned short iPeakPeriod )
 	QMutexLocker locker(&m_mutex);
 
 	sync(NULL);
+	syncWait();
 
 	m_iPeakPeriod = iPeakPeriod;
 
@@ -1064,9 +1228,16 @@ qtractorAudioPeak* qtractorAudioPeakFactory::createPeak (
 {
 	QMutexLocker locker(&m_mutex);
 
-	if (m_pPeakThread == NULL) {
-		m_pPeakThread = new qtractorAudioPeakThread();
-		m_pPeakThread->start();
+	if (m_ppPeakThreads == NULL) {
+		int iPeakThreads = QThread::idealThreadCount();
+		if (iPeakThreads < 1)
+			iPeakThreads = 1;
+		m_iPeakThreads = iPeakThreads;
+		m_ppPeakThreads = new qtractorAudioPeakThread * [m_iPeakThreads];
+		for (unsigned int i = 0; i < m_iPeakThreads; ++i) {
+			m_ppPeakThreads[i] = new qtractorAudioPeakThread(this);
+			m_ppPeakThreads[i]->start(QThread::LowPriority);
+		}
 	}
 
 	const QString& sPeakName
@@ -1103,7 +1274,81 @@ void qtractorAudioPeakFactory::notifyPeakEvent (void)
 // Base sync method.
 void qtractorAudioPeakFactory::sync ( qtractorAudioPeakFile *pPeakFile )
 {
-	if (m_pPeakThread) m_pPeakThread->sync(pPeakFile);
+	QMutexLocker locker(&m_syncMutex);
+
+	if (pPeakFile == NULL) {
+		// Cancel all pending and current peak files...
+		QListIterator<qtractorAudioPeakFile *> iter(m_pending);
+		while (iter.hasNext())
+			iter.next()->setWaitSync(false);
+		m_pending.clear();
+		QListIterator<qtractorAudioPeakFile *> iter2(m_current);
+		while (iter2.hasNext())
+			iter2.next()->setWaitSync(false);
+	}
+	else
+	if (!m_current.contains(pPeakFile)) {
+		// Latest requested (visible) ones go first...
+		m_pending.removeAll(pPeakFile);
+		m_pending.prepend(pPeakFile);
+		pPeakFile->setWaitSync(true);
+	}
+
+	m_syncCond.wakeAll();
+}
+
+
+// Wait for current peak files to finish or bail out.
+void qtractorAudioPeakFactory::syncWait (void)
+{
+	QMutexLocker locker(&m_syncMutex);
+
+	while (m_iPeakBusy > 0)
+		m_syncCond.wait(&m_syncMutex, 100);
+}
+
+
+// Peak file creation queue executives (pool thread side).
+qtractorAudioPeakFile *qtractorAudioPeakFactory::takePeakFile (
+	qtractorAudioPeakThread *pPeakThread )
+{
+	QMutexLocker locker(&m_syncMutex);
+
+	if (!pPeakThread->runState())
+		return NULL;
+
+	if (m_pending.isEmpty()) {
+		m_syncCond.wait(&m_syncMutex);
+		if (m_pending.isEmpty() || !pPeakThread->runState())
+			return NULL;
+	}
+
+	qtractorAudioPeakFile *pPeakFile = m_pending.takeFirst();
+	m_current.append(pPeakFile);
+	++m_iPeakBusy;
+
+	return pPeakFile;
+}
+
+
+void qtractorAudioPeakFactory::donePeakFile (
+	qtractorAudioPeakFile *pPeakFile )
+{
+	QMutexLocker locker(&m_syncMutex);
+
+	m_current.removeOne(pPeakFile);
+	--m_iPeakBusy;
+
+	m_syncCond.wakeAll();
+}
+
+
+// Peak files still being created (progress).
+unsigned int qtractorAudioPeakFactory::peakPending (void)
+{
+	QMutexLocker locker(&m_syncMutex);
+
+	return m_pending.count() + m_iPeakBusy;
 }
 
 
@@ -1113,6 +1358,7 @@ void qtractorAudioPeakFactory::cleanup (void)
 	QMutexLocker locker(&m_mutex);
 
 	sync(NULL);
+	syncWait();
 
 	// Cleanup all current registered peak files...
 	PeakFiles::ConstIterator iter = m_peaks.constBegin();
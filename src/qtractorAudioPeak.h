@@ -25,8 +25,10 @@
 #include <QString>
 #include <QFile>
 #include <QHash>
+#include <QList>
 
 #include <QMutex>
+#include <QWaitCondition>
 
 #include <QStringList>
 
@@ -59,12 +61,20 @@ public:
 	QString name() const;
 	unsigned short period();
 	unsigned short channels();
+	unsigned short levels();
 
-	// Audio peak file header.
+	// Peak frames length at given resolution level.
+	unsigned long length(unsigned short iLevel = 0);
+
+	// Audio peak file header (versioned).
 	struct Header
 	{
+		unsigned int   magic;
+		unsigned short version;
 		unsigned short period;
 		unsigned short channels;
+		unsigned short levels;
+		unsigned int   length;
 	};
 
 	// Audio peak file frame record.
@@ -77,7 +87,8 @@ public:
 
 	// Peak cache file methods.
 	bool openRead();
-	Frame *read(unsigned long iPeakOffset, unsigned int iPeakLength);
+	Frame *read(unsigned long iPeakOffset, unsigned int iPeakLength,
+		unsigned short iLevel = 0);
 	void closeRead();
 
 	// Write peak from audio frame methods.
@@ -106,6 +117,13 @@ protected:
 
 	// Internal creational methods.
 	void writeFrame();
+	void writeLevels();
+
+	// Peak file offset of given resolution level (in bytes).
+	unsigned long levelOffset(unsigned short iLevel) const;
+
+	// Local buffer cache (re)allocation.
+	void resizeBuffer(unsigned int iBuffOffset, unsigned int iPeakLength);
 
 	// Read frames from peak file into local buffer cache.
 	unsigned int readBuffer(unsigned int iBuffOffset,
@@ -123,10 +141,13 @@ private:
 
 	Header         m_peakHeader;
 
+	uchar         *m_pMapped;
+
 	Frame         *m_pBuffer;
 	unsigned int   m_iBuffSize;
 	unsigned int   m_iBuffLength;
 	unsigned long  m_iBuffOffset;
+	unsigned short m_iBuffLevel;
 
 	QMutex         m_mutex;
 
@@ -238,6 +259,13 @@ public:
 	// Base sync method.
 	void sync(qtractorAudioPeakFile *pPeakFile = NULL);
 
+	// Peak file creation queue executives (pool thread side).
+	qtractorAudioPeakFile *takePeakFile(qtractorAudioPeakThread *pPeakThread);
+	void donePeakFile(qtractorAudioPeakFile *pPeakFile);
+
+	// Peak files still being created (progress).
+	unsigned int peakPending();
+
 	// Cleanup method.
 	void cleanup();
 
@@ -249,6 +277,11 @@ signals:
 	// Peak ready signal.
 	void peakEvent();
 
+protected:
+
+	// Wait for current peak files to finish or bail out.
+	void syncWait();
+
 private:
 
 	// Factory mutex.
@@ -262,8 +295,18 @@ private:
 	// Auto-delete property.
 	bool m_bAutoRemove;
 
-	// The peak file creation detached thread.
-	qtractorAudioPeakThread *m_pPeakThread;
+	// The peak file creation thread pool.
+	unsigned int              m_iPeakThreads;
+	qtractorAudioPeakThread **m_ppPeakThreads;
+
+	// The peak file creation queue (latest requested first).
+	QMutex m_syncMutex;
+	QWaitCondition m_syncCond;
+
+	QList<qtractorAudioPeakFile *> m_pending;
+	QList<qtractorAudioPeakFile *> m_current;
+
+	unsigned int m_iPeakBusy;
 
 	// The current running peak-period.
 	unsigned short m_iPeakPeriod;
@@ -22,6 +22,18 @@
 #include "qtractorAbout.h"
 #include "qtractorAudioSndFile.h"
 
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#if defined(FALLOC_FL_KEEP_SIZE)
+#define CONFIG_FALLOCATE 1
+#endif
+#endif
+
+
+// Write-ahead pre-allocation chunk size (in bytes).
+static const unsigned long c_iPreallocSize = (16 << 20);
+
 
 //----------------------------------------------------------------------
 // class qtractorAudioSndFile -- Buffered audio file implementation.
@@ -35,6 +47,7 @@ qtractorAudioSndFile::qtractorAudioSndFile ( unsigned short iChannels,
 	::memset(&m_sfinfo, 0, sizeof(m_sfinfo));
 	m_sfinfo.channels   = iChannels;
 	m_sfinfo.samplerate = iSampleRate;
+	m_iFormat = 0;
 
 	// Initialize other stuff.
 	m_pSndFile    = NULL;
@@ -42,6 +55,9 @@ qtractorAudioSndFile::qtractorAudioSndFile ( unsigned short iChannels,
 	m_pBuffer     = NULL;
 	m_iBufferSize = 1024;
 
+	m_iFd         = -1;
+	m_iPrealloc   = 0;
+
 	// Adjust size the next nearest power-of-two.
 	while (m_iBufferSize < iBufferSize)
 		m_iBufferSize <<= 1;
@@ -80,11 +96,28 @@ bool qtractorAudioSndFile::open ( const QString& sFilename, int iMode )
 	if (sfmode & SFM_WRITE) {
 		if (m_sfinfo.channels == 0 || m_sfinfo.samplerate == 0)
 			return false;
-		m_sfinfo.format = qtractorAudioFileFactory::defaultFormat();
+		m_sfinfo.format = (m_iFormat
+			? m_iFormat : qtractorAudioFileFactory::defaultFormat());
 	}
 
 	// Now open it.
 	QByteArray aFilename = sFilename.toUtf8();
+#ifdef CONFIG_FALLOCATE
+	// Keep the descriptor, for pre-allocating disk space ahead...
+	if (sfmode & SFM_WRITE) {
+		m_iFd = ::open(aFilename.constData(), O_RDWR | O_CREAT | O_TRUNC, 0666);
+		if (m_iFd < 0)
+			return false;
+		m_iPrealloc = 0;
+		m_pSndFile = ::sf_open_fd(m_iFd, sfmode, &m_sfinfo, SF_FALSE);
+		if (m_pSndFile == NULL) {
+			::close(m_iFd);
+			m_iFd = -1;
+			return false;
+		}
+	}
+	else
+#endif
 	m_pSndFile = ::sf_open(aFilename.constData(), sfmode, &m_sfinfo);
 	if (m_pSndFile == NULL)
 		return false;
@@ -132,7 +165,9 @@ int qtractorAudioSndFile::write ( float **ppFrames, unsigned int iFrames )
 		for (i = 0; i < (unsigned short) m_sfinfo.channels; ++i)
 			m_pBuffer[k++] = ppFrames[i][n];
 	}
-	return ::sf_writef_float(m_pSndFile, m_pBuffer, iFrames);
+	const int nwrite = ::sf_writef_float(m_pSndFile, m_pBuffer, iFrames);
+	preallocCheck();
+	return nwrite;
 }
 
 
@@ -159,6 +194,19 @@ void qtractorAudioSndFile::close (void)
 		m_iMode = qtractorAudioSndFile::None;
 	}
 
+#ifdef CONFIG_FALLOCATE
+	// Give back any pre-allocated space beyond the end...
+	if (m_iFd >= 0) {
+		const off_t iSize = ::lseek(m_iFd, 0, SEEK_END);
+		if (iSize >= 0 && m_iPrealloc > (unsigned long) iSize
+			&& ::ftruncate(m_iFd, iSize) != 0)
+			qWarning("qtractorAudioSndFile::close(): ftruncate() failed.");
+		::close(m_iFd);
+		m_iFd = -1;
+		m_iPrealloc = 0;
+	}
+#endif
+
 	if (m_pBuffer) {
 		delete [] m_pBuffer;
 		m_pBuffer = NULL;
@@ -194,6 +242,18 @@ unsigned int qtractorAudioSndFile::sampleRate (void) const
 }
 
 
+// Write format override (0=default capture format).
+void qtractorAudioSndFile::setFormat ( int iFormat )
+{
+	m_iFormat = iFormat;
+}
+
+int qtractorAudioSndFile::format (void) const
+{
+	return m_iFormat;
+}
+
+
 // De/interleaving buffer stuff.
 void qtractorAudioSndFile::allocBufferCheck ( unsigned int iBufferSize )
 {
@@ -211,4 +271,34 @@ void qtractorAudioSndFile::allocBufferCheck ( unsigned int iBufferSize )
 }
 
 
+// Write-ahead disk space pre-allocation check: keeps a few extents
+// reserved in advance, so that concurrent capture files don't end up
+// interleaved and fragmented all over the disk.
+void qtractorAudioSndFile::preallocCheck (void)
+{
+#ifdef CONFIG_FALLOCATE
+	if (m_iFd < 0 || m_iPrealloc == (unsigned long) -1)
+		return;
+
+	const off_t iOffset = ::lseek(m_iFd, 0, SEEK_CUR);
+	if (iOffset < 0)
+		return;
+
+	const unsigned long iWatermark = (unsigned long) iOffset
+		+ (c_iPreallocSize >> 1);
+	if (iWatermark < m_iPrealloc)
+		return;
+
+	if (m_iPrealloc < (unsigned long) iOffset)
+		m_iPrealloc = iOffset;
+
+	if (::fallocate(m_iFd, FALLOC_FL_KEEP_SIZE,
+			m_iPrealloc, c_iPreallocSize) == 0)
+		m_iPrealloc += c_iPreallocSize;
+	else
+		m_iPrealloc = (unsigned long) -1; // Not supported, give up.
+#endif
+}
+
+
 // end of qtractorAudioSndFile.cpp
@@ -58,20 +58,32 @@ public:
 	// Specialty methods.
 	unsigned int   sampleRate() const;
 
+	// Write format override (0=default capture format).
+	void setFormat(int iFormat);
+	int format() const;
+
 protected:
 
 	// De/interleaving buffer (re)allocation check.
 	void allocBufferCheck(unsigned int iBufferSize);
 
+	// Write-ahead disk space pre-allocation check.
+	void preallocCheck();
+
 private:
 
 	int           m_iMode;          // open mode (Read|Write).
 	SNDFILE      *m_pSndFile;       // libsndfile descriptor.
 	SF_INFO       m_sfinfo;         // libsndfile info struct.
+	int           m_iFormat;        // write format override.
 
 	// De/interleaving buffer stuff.
 	float        *m_pBuffer;
 	unsigned int  m_iBufferSize;
+
+	// Write-ahead pre-allocation stuff.
+	int           m_iFd;
+	unsigned long m_iPrealloc;
 };
 
 
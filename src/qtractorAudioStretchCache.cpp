@@ -0,0 +1,647 @@
+// qtractorAudioStretchCache.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2018, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qtractorAbout.h"
+#include "qtractorAudioStretchCache.h"
+#include "qtractorAudioBuffer.h"
+#include "qtractorAudioSndFile.h"
+#include "qtractorTimeStretcher.h"
+
+#include "qtractorSession.h"
+
+#include <QThread>
+#include <QFileInfo>
+#include <QFile>
+#include <QDir>
+
+#include <QDateTime>
+
+
+// Rendered cache file extension.
+static const char *c_sStretchFileExt = ".stretch.wav";
+
+// Render chunk size (in frames per channel).
+static const unsigned int c_iStretchFrames = 4096;
+
+// Render request debounce delay (msecs).
+static const qint64 c_iStretchDelay = 1000;
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioStretchThread -- Time-stretch cache render thread.
+//
+
+class qtractorAudioStretchThread : public QThread
+{
+public:
+
+	// Constructor.
+	qtractorAudioStretchThread(qtractorAudioStretchCache *pStretchCache);
+
+	// Thread run state accessors.
+	void setRunState(bool bRunState);
+	bool runState() const;
+
+	// Wake from executive wait condition.
+	void sync();
+
+protected:
+
+	// The main thread executive.
+	void run();
+
+	// Actual cache file render.
+	bool render(qtractorAudioStretchCache::Item *pItem);
+
+private:
+
+	// The stretch cache (and queue) reference.
+	qtractorAudioStretchCache *m_pStretchCache;
+
+	// Whether the thread is logically running.
+	volatile bool m_bRunState;
+};
+
+
+// Constructor.
+qtractorAudioStretchThread::qtractorAudioStretchThread (
+	qtractorAudioStretchCache *pStretchCache ) : QThread()
+{
+	m_pStretchCache = pStretchCache;
+
+	m_bRunState = false;
+}
+
+
+// Run state accessor.
+void qtractorAudioStretchThread::setRunState ( bool bRunState )
+{
+	m_bRunState = bRunState;
+}
+
+bool qtractorAudioStretchThread::runState (void) const
+{
+	return m_bRunState;
+}
+
+
+// Wake from executive wait condition.
+void qtractorAudioStretchThread::sync (void)
+{
+	m_pStretchCache->sync();
+}
+
+
+// The main thread executive cycle.
+void qtractorAudioStretchThread::run (void)
+{
+#ifdef CONFIG_DEBUG_0
+	qDebug("qtractorAudioStretchThread[%p]::run(): started...", this);
+#endif
+
+	m_bRunState = true;
+
+	while (m_bRunState) {
+		// Take next pending item, or wait for more...
+		qtractorAudioStretchCache::Item *pItem
+			= m_pStretchCache->takeItem(this);
+		if (pItem == NULL)
+			continue;
+		m_pStretchCache->doneItem(pItem, render(pItem));
+	}
+
+#ifdef CONFIG_DEBUG_0
+	qDebug("qtractorAudioStretchThread[%p]::run(): stopped.\n", this);
+#endif
+}
+
+
+// Render the whole time-stretched/pitch-shifted thing,
+// through the very same audio buffer chain as live...
+bool qtractorAudioStretchThread::render (
+	qtractorAudioStretchCache::Item *pItem )
+{
+	qtractorAudioBuffer buff(NULL, pItem->channels);
+
+	buff.setStretchCache(false);
+	buff.setTimeStretch(pItem->timeStretch);
+	buff.setPitchShift(pItem->pitchShift);
+	buff.setWsolaTimeStretch(
+		pItem->flags & qtractorTimeStretcher::WsolaTimeStretch);
+	buff.setWsolaQuickSeek(
+		pItem->flags & qtractorTimeStretcher::WsolaQuickSeek);
+	buff.setWsolaFastSeek(
+		pItem->flags & qtractorTimeStretcher::WsolaFastSeek);
+
+	if (!buff.open(pItem->filename))
+		return false;
+
+	const unsigned short iChannels = buff.channels();
+
+	// Render into a temporary file first...
+	const QString& sTempName = pItem->cacheName + ".tmp";
+
+	qtractorAudioSndFile file(iChannels, pItem->sampleRate);
+	file.setFormat(SF_FORMAT_WAV | SF_FORMAT_FLOAT);
+	if (!file.open(sTempName, qtractorAudioFile::Write))
+		return false;
+
+	unsigned short i;
+
+	float **ppFrames = new float * [iChannels];
+	for (i = 0; i < iChannels; ++i)
+		ppFrames[i] = new float [c_iStretchFrames];
+
+	const unsigned long iLength = buff.length();
+	unsigned long iFrames = 0;
+
+	// Initial buffer read in...
+	buff.setSyncFlag(qtractorAudioBuffer::WaitSync);
+	buff.sync();
+
+	while (iFrames < iLength
+		&& m_bRunState && !m_pStretchCache->isCancelled(pItem)) {
+		// Refill, as the sync thread would do...
+		if (!buff.isIntegral()) {
+			buff.setSyncFlag(qtractorAudioBuffer::WaitSync);
+			buff.sync();
+			if (buff.syncHeadroom() < 1)
+				break;
+		}
+		unsigned int nahead = c_iStretchFrames;
+		if (nahead > iLength - iFrames)
+			nahead = iLength - iFrames;
+		const int nread = buff.read(ppFrames, nahead);
+		if (nread < 1)
+			break;
+		if (file.write(ppFrames, nread) < nread)
+			break;
+		iFrames += nread;
+	}
+
+	file.close();
+	buff.close();
+
+	for (i = 0; i < iChannels; ++i)
+		delete [] ppFrames[i];
+	delete [] ppFrames;
+
+	// Don't leave an incomplete cache file behind...
+	if (iFrames < iLength) {
+		QFile::remove(sTempName);
+		return false;
+	}
+
+	QFile::remove(pItem->cacheName);
+	return QFile::rename(sTempName, pItem->cacheName);
+}
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioStretchCache -- Pre-rendered time-stretch cache.
+//
+
+// Singleton instance.
+static qtractorAudioStretchCache g_audioStretchCache;
+
+// Singleton instance accessor (static).
+qtractorAudioStretchCache *qtractorAudioStretchCache::getInstance (void)
+{
+	return &g_audioStretchCache;
+}
+
+
+// Constructor.
+qtractorAudioStretchCache::qtractorAudioStretchCache (void)
+	: m_iSize(0), m_iMaxSize(0), m_iStretchIds(0), m_iBusy(0),
+		m_bCancel(false), m_bEnabled(false), m_pStretchThread(NULL)
+{
+}
+
+
+// Default destructor.
+qtractorAudioStretchCache::~qtractorAudioStretchCache (void)
+{
+	// The render thread must be long gone by now (see clear)...
+	qDeleteAll(m_items);
+}
+
+
+// Unique cache item key.
+QString qtractorAudioStretchCache::itemKey ( const QString& sFilename,
+	unsigned int iSampleRate, float fTimeStretch, float fPitchShift,
+	unsigned int iFlags )
+{
+	// Any file modification makes it a whole new one...
+	const QFileInfo info(sFilename);
+	return info.absoluteFilePath()
+		+ ':' + QString::number(info.size())
+		+ ':' + QString::number(info.lastModified().toMSecsSinceEpoch())
+		+ ':' + QString::number(iSampleRate)
+		+ ':' + QString::number(fTimeStretch)
+		+ ':' + QString::number(fPitchShift)
+		+ ':' + QString::number(iFlags);
+}
+
+
+// Request a cache item, queueing it for render when not already there.
+unsigned int qtractorAudioStretchCache::request ( const QString& sFilename,
+	unsigned short iChannels, unsigned int iSampleRate,
+	float fTimeStretch, float fPitchShift, unsigned int iFlags )
+{
+	if (!m_bEnabled)
+		return 0;
+
+	const QString& sKey = itemKey(sFilename,
+		iSampleRate, fTimeStretch, fPitchShift, iFlags);
+
+	QMutexLocker locker(&m_mutex);
+
+	unsigned int iStretchId = m_keys.value(sKey, 0);
+	if (iStretchId > 0) {
+		Item *pItem = m_items.value(iStretchId, NULL);
+		if (pItem)
+			++(pItem->refs);
+		return iStretchId;
+	}
+
+	// Set (unique) cache filename, along the peak files...
+	QDir dir;
+	qtractorSession *pSession = qtractorSession::getInstance();
+	if (pSession)
+		dir.setPath(pSession->sessionDir());
+
+	const QFileInfo fileInfo(sFilename);
+	const QString& sCacheFilePrefix
+		= QFileInfo(dir, fileInfo.fileName()).filePath();
+	const QFileInfo cacheInfo(sCacheFilePrefix + '_'
+		+ QString::number(qHash(sKey), 16)
+		+ c_sStretchFileExt);
+
+	// Left over from a previous run? (see scan)
+	iStretchId = m_files.value(cacheInfo.absoluteFilePath(), 0);
+	if (iStretchId > 0) {
+		Item *pItem = m_items.value(iStretchId, NULL);
+		if (pItem) {
+			pItem->filename    = sFilename;
+			pItem->channels    = iChannels;
+			pItem->sampleRate  = iSampleRate;
+			pItem->timeStretch = fTimeStretch;
+			pItem->pitchShift  = fPitchShift;
+			pItem->flags       = iFlags;
+			++(pItem->refs);
+			m_keys.insert(sKey, iStretchId);
+			return iStretchId;
+		}
+	}
+
+	iStretchId = ++m_iStretchIds;
+
+	Item *pItem = new Item;
+	pItem->id          = iStretchId;
+	pItem->filename    = sFilename;
+	pItem->cacheName   = cacheInfo.absoluteFilePath();
+	pItem->channels    = iChannels;
+	pItem->sampleRate  = iSampleRate;
+	pItem->timeStretch = fTimeStretch;
+	pItem->pitchShift  = fPitchShift;
+	pItem->flags       = iFlags;
+	pItem->state       = (cacheInfo.exists() ? Ready : Pending);
+	pItem->refs        = 1;
+	pItem->due         = QDateTime::currentMSecsSinceEpoch() + c_iStretchDelay;
+	pItem->size        = (pItem->state == Ready ? cacheInfo.size() : 0);
+
+	insertItem(sKey, pItem);
+
+	// Queue it for render (debounced), if not already there...
+	if (pItem->state == Pending) {
+		if (m_pStretchThread == NULL) {
+			m_pStretchThread = new qtractorAudioStretchThread(this);
+			m_pStretchThread->setRunState(true);
+			m_pStretchThread->start(QThread::LowPriority);
+		}
+		m_pending.append(iStretchId);
+		m_cond.wakeAll();
+	} else {
+		m_ready.append(iStretchId);
+		m_iSize += pItem->size;
+		trimSize();
+	}
+
+	return iStretchId;
+}
+
+
+// Release a cache item request; an unreferenced item
+// not rendered yet is superseded (dropped or cancelled).
+void qtractorAudioStretchCache::release ( unsigned int iStretchId )
+{
+	QMutexLocker locker(&m_mutex);
+
+	Item *pItem = m_items.value(iStretchId, NULL);
+	if (pItem == NULL || --(pItem->refs) > 0)
+		return;
+
+	switch (pItem->state) {
+	case Pending:
+		// Superseded before even started...
+		m_pending.removeAll(iStretchId);
+		removeItem(iStretchId);
+		break;
+	case Busy:
+		// Being rendered: cancel it (see isCancelled)...
+		break;
+	case Ready:
+		// Might get evicted now...
+		trimSize();
+		break;
+	default:
+		break;
+	}
+}
+
+
+// Rendered cache file path, if ready (or empty).
+QString qtractorAudioStretchCache::readyFile ( unsigned int iStretchId )
+{
+	QMutexLocker locker(&m_mutex);
+
+	Item *pItem = m_items.value(iStretchId, NULL);
+	if (pItem && pItem->state == Ready) {
+		// Most recently used...
+		m_ready.removeAll(iStretchId);
+		m_ready.append(iStretchId);
+		return pItem->cacheName;
+	}
+	else
+		return QString();
+}
+
+
+// Items still being rendered (progress).
+unsigned int qtractorAudioStretchCache::pending (void)
+{
+	QMutexLocker locker(&m_mutex);
+
+	return m_pending.count() + m_iBusy;
+}
+
+
+// Cancel all pending renders, stop the render thread
+// and forget all items (explicit shutdown included).
+void qtractorAudioStretchCache::clear (void)
+{
+	QMutexLocker locker(&m_mutex);
+
+	// Cancel any current render...
+	m_pending.clear();
+	m_bCancel = true;
+
+	qtractorAudioStretchThread *pStretchThread = m_pStretchThread;
+	m_pStretchThread = NULL;
+
+	locker.unlock();
+
+	// Stop the render thread...
+	if (pStretchThread) {
+		if (pStretchThread->isRunning()) do {
+			pStretchThread->setRunState(false);
+		//	pStretchThread->terminate();
+			pStretchThread->sync();
+		} while (!pStretchThread->wait(100));
+		delete pStretchThread;
+	}
+
+	locker.relock();
+
+	m_bCancel = false;
+	m_iBusy = 0;
+
+	qDeleteAll(m_items);
+	m_items.clear();
+	m_keys.clear();
+	m_files.clear();
+	m_ready.clear();
+	m_iSize = 0;
+}
+
+
+// Account for rendered cache files left over in a
+// directory (eg. from previous runs), oldest first.
+void qtractorAudioStretchCache::scan ( const QString& sDir )
+{
+	if (!m_bEnabled || sDir.isEmpty())
+		return;
+
+	const QFileInfoList& list = QDir(sDir).entryInfoList(
+		QStringList() << QString('*') + c_sStretchFileExt,
+		QDir::Files, QDir::Time | QDir::Reversed);
+
+	QMutexLocker locker(&m_mutex);
+
+	QListIterator<QFileInfo> iter(list);
+	while (iter.hasNext()) {
+		const QFileInfo& info = iter.next();
+		const QString& sCacheName = info.absoluteFilePath();
+		if (m_files.contains(sCacheName))
+			continue;
+		Item *pItem = new Item;
+		pItem->id          = ++m_iStretchIds;
+		pItem->cacheName   = sCacheName;
+		pItem->channels    = 0;
+		pItem->sampleRate  = 0;
+		pItem->timeStretch = 1.0f;
+		pItem->pitchShift  = 1.0f;
+		pItem->flags       = 0;
+		pItem->state       = Ready;
+		pItem->refs        = 0;
+		pItem->due         = 0;
+		pItem->size        = info.size();
+		insertItem(QString(), pItem);
+		m_ready.append(pItem->id);
+		m_iSize += pItem->size;
+	}
+
+	trimSize();
+}
+
+
+// Enable/disable (background) rendering.
+void qtractorAudioStretchCache::setEnabled ( bool bEnabled )
+{
+	m_bEnabled = bEnabled;
+}
+
+bool qtractorAudioStretchCache::isEnabled (void) const
+{
+	return m_bEnabled;
+}
+
+
+// Rendered cache files size limit (in bytes; 0=unlimited).
+void qtractorAudioStretchCache::setMaxSize ( qint64 iMaxSize )
+{
+	QMutexLocker locker(&m_mutex);
+
+	m_iMaxSize = iMaxSize;
+
+	trimSize();
+}
+
+qint64 qtractorAudioStretchCache::maxSize (void) const
+{
+	return m_iMaxSize;
+}
+
+
+// Render queue executives (render thread side).
+qtractorAudioStretchCache::Item *qtractorAudioStretchCache::takeItem (
+	qtractorAudioStretchThread *pStretchThread )
+{
+	QMutexLocker locker(&m_mutex);
+
+	while (pStretchThread->runState()) {
+		// Wait for more...
+		if (m_pending.isEmpty()) {
+			m_cond.wait(&m_mutex);
+			continue;
+		}
+		// Wait for the oldest request to settle down...
+		const unsigned int iStretchId = m_pending.first();
+		Item *pItem = m_items.value(iStretchId, NULL);
+		if (pItem) {
+			const qint64 iDelay
+				= pItem->due - QDateTime::currentMSecsSinceEpoch();
+			if (iDelay > 0) {
+				m_cond.wait(&m_mutex, (unsigned long) iDelay);
+				continue;
+			}
+		}
+		m_pending.removeFirst();
+		if (pItem) {
+			pItem->state = Busy;
+			++m_iBusy;
+			return pItem;
+		}
+	}
+
+	return NULL;
+}
+
+
+void qtractorAudioStretchCache::doneItem ( Item *pItem, bool bResult )
+{
+	QMutexLocker locker(&m_mutex);
+
+	--m_iBusy;
+
+	const unsigned int iStretchId = pItem->id;
+
+	// Superseded meanwhile?
+	if (pItem->refs < 1) {
+		if (bResult)
+			QFile::remove(pItem->cacheName);
+		removeItem(iStretchId);
+	}
+	else
+	if (bResult) {
+		pItem->state = Ready;
+		pItem->size = QFileInfo(pItem->cacheName).size();
+		m_ready.append(iStretchId);
+		m_iSize += pItem->size;
+		trimSize();
+	}
+	else pItem->state = Failed;
+
+	m_cond.wakeAll();
+}
+
+
+// Wake the render thread.
+void qtractorAudioStretchCache::sync (void)
+{
+	QMutexLocker locker(&m_mutex);
+
+	m_cond.wakeAll();
+}
+
+
+// Whether given render is to be cancelled.
+bool qtractorAudioStretchCache::isCancelled ( const Item *pItem ) const
+{
+	return m_bCancel || pItem->refs < 1;
+}
+
+
+// Register a new item (mutex held).
+void qtractorAudioStretchCache::insertItem ( const QString& sKey, Item *pItem )
+{
+	if (!sKey.isEmpty())
+		m_keys.insert(sKey, pItem->id);
+
+	m_items.insert(pItem->id, pItem);
+	m_files.insert(pItem->cacheName, pItem->id);
+}
+
+
+// Forget about an item (mutex held).
+void qtractorAudioStretchCache::removeItem ( unsigned int iStretchId )
+{
+	Item *pItem = m_items.take(iStretchId);
+	if (pItem == NULL)
+		return;
+
+	m_files.remove(pItem->cacheName);
+
+	QMutableHashIterator<QString, unsigned int> iter(m_keys);
+	while (iter.hasNext()) {
+		if (iter.next().value() == iStretchId)
+			iter.remove();
+	}
+
+	delete pItem;
+}
+
+
+// Evict unreferenced rendered files over the size limit,
+// least recently used first (mutex held).
+void qtractorAudioStretchCache::trimSize (void)
+{
+	if (m_iMaxSize < 1)
+		return;
+
+	QMutableListIterator<unsigned int> iter(m_ready);
+	while (m_iSize > m_iMaxSize && iter.hasNext()) {
+		const unsigned int iStretchId = iter.next();
+		Item *pItem = m_items.value(iStretchId, NULL);
+		if (pItem && pItem->refs > 0)
+			continue;
+		iter.remove();
+		if (pItem) {
+			m_iSize -= pItem->size;
+			QFile::remove(pItem->cacheName);
+			removeItem(iStretchId);
+		}
+	}
+}
+
+
+// end of qtractorAudioStretchCache.cpp
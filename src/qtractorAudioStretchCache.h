@@ -0,0 +1,172 @@
+// qtractorAudioStretchCache.h
+//
+/****************************************************************************
+   Copyright (C) 2005-2018, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qtractorAudioStretchCache_h
+#define __qtractorAudioStretchCache_h
+
+#include <QString>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QWaitCondition>
+
+
+// Forward declarations.
+class qtractorAudioStretchThread;
+
+
+//----------------------------------------------------------------------
+// class qtractorAudioStretchCache -- Pre-rendered time-stretch cache.
+//
+// Time-stretched and/or pitch-shifted audio clips are rendered in the
+// background, once and for all, into plain (float) audio files, kept
+// along the session directory. Audio buffers switch over to stream
+// from these as soon as they're ready, doing it live meanwhile.
+//
+
+class qtractorAudioStretchCache
+{
+public:
+
+	// Constructor.
+	qtractorAudioStretchCache();
+
+	// Default destructor.
+	~qtractorAudioStretchCache();
+
+	// Cache item state.
+	enum State { Pending = 0, Busy, Ready, Failed };
+
+	// Cache item descriptor.
+	struct Item
+	{
+		unsigned int    id;
+		QString         filename;
+		QString         cacheName;
+		unsigned short  channels;
+		unsigned int    sampleRate;
+		float           timeStretch;
+		float           pitchShift;
+		unsigned int    flags;
+		State           state;
+		int             refs;       // Requester reference count.
+		qint64          due;        // Render not before (msecs).
+		qint64          size;       // Rendered file size (bytes).
+	};
+
+	// Request a cache item, queueing it for render when
+	// not already there; returns the item identifier.
+	unsigned int request(const QString& sFilename,
+		unsigned short iChannels, unsigned int iSampleRate,
+		float fTimeStretch, float fPitchShift, unsigned int iFlags);
+
+	// Release a cache item request; an unreferenced item
+	// not rendered yet is superseded (dropped or cancelled).
+	void release(unsigned int iStretchId);
+
+	// Rendered cache file path, if ready (or empty).
+	QString readyFile(unsigned int iStretchId);
+
+	// Items still being rendered (progress).
+	unsigned int pending();
+
+	// Cancel all pending renders, stop the render thread
+	// and forget all items (explicit shutdown included).
+	void clear();
+
+	// Account for rendered cache files left over in a
+	// directory (eg. from previous runs), oldest first.
+	void scan(const QString& sDir);
+
+	// Enable/disable (background) rendering.
+	void setEnabled(bool bEnabled);
+	bool isEnabled() const;
+
+	// Rendered cache files size limit (in bytes; 0=unlimited).
+	void setMaxSize(qint64 iMaxSize);
+	qint64 maxSize() const;
+
+	// Render queue executives (render thread side).
+	Item *takeItem(qtractorAudioStretchThread *pStretchThread);
+	void doneItem(Item *pItem, bool bResult);
+
+	// Wake the render thread.
+	void sync();
+
+	// Whether given render is to be cancelled.
+	bool isCancelled(const Item *pItem) const;
+
+	// Singleton instance accessor.
+	static qtractorAudioStretchCache *getInstance();
+
+protected:
+
+	// Unique cache item key.
+	static QString itemKey(const QString& sFilename,
+		unsigned int iSampleRate, float fTimeStretch,
+		float fPitchShift, unsigned int iFlags);
+
+	// Register a new item (mutex held).
+	void insertItem(const QString& sKey, Item *pItem);
+
+	// Forget about an item (mutex held).
+	void removeItem(unsigned int iStretchId);
+
+	// Evict unreferenced rendered files over the size limit.
+	void trimSize();
+
+private:
+
+	// Instance variables.
+	QMutex m_mutex;
+	QWaitCondition m_cond;
+
+	QHash<QString, unsigned int> m_keys;
+	QHash<unsigned int, Item *>  m_items;
+
+	// Cache file paths (item identifiers).
+	QHash<QString, unsigned int> m_files;
+
+	// Render queue (item identifiers).
+	QList<unsigned int> m_pending;
+
+	// Rendered items, least recently used first.
+	QList<unsigned int> m_ready;
+
+	qint64 m_iSize;
+	qint64 m_iMaxSize;
+
+	unsigned int m_iStretchIds;
+	unsigned int m_iBusy;
+
+	volatile bool m_bCancel;
+
+	bool m_bEnabled;
+
+	// The render thread (lazy started).
+	qtractorAudioStretchThread *m_pStretchThread;
+};
+
+
+#endif  // __qtractorAudioStretchCache_h
+
+
+// end of qtractorAudioStretchCache.h
@@ -170,6 +170,9 @@ void qtractorClip::setClipStart ( unsigned long iClipStart )
 {
 	m_iClipStart = iClipStart;
 
+	if (m_pTrack)
+		m_pTrack->setClipIndexDirty();
+
 	if (m_pTrack && m_pTrack->session())
 		m_iClipStartTime = m_pTrack->session()->tickFromFrame(iClipStart);
 }
@@ -180,6 +183,9 @@ void qtractorClip::setClipLength ( unsigned long iClipLength )
 {
 	m_iClipLength = iClipLength;
 
+	if (m_pTrack)
+		m_pTrack->setClipIndexDirty();
+
 	if (m_pTrack && m_pTrack->session())
 		m_iClipLengthTime = m_pTrack->session()->tickFromFrameRange(
 			m_iClipStart, m_iClipStart + m_iClipLength);
@@ -406,6 +406,25 @@ bool qtractorClipCommand::addClipRecord (
 		return true;
 	}
 
+	// Report any capture overruns, explicitly...
+	if (trackType == qtractorTrack::Audio) {
+		qtractorAudioClip *pAudioClip
+			= static_cast<qtractorAudioClip *> (pClip);
+		qtractorAudioBuffer *pBuff = pAudioClip->buffer();
+		if (pBuff && pBuff->droppedFrames() > 0) {
+			qtractorMainForm *pMainForm = qtractorMainForm::getInstance();
+			if (pMainForm) {
+				pMainForm->appendMessagesColor(
+					QObject::tr("Audio capture overrun on track \"%1\": "
+						"%2 frames dropped (%3 times, %4% max. buffer fill).")
+						.arg(pTrack->trackName())
+						.arg(pBuff->droppedFrames())
+						.arg(pBuff->underruns())
+						.arg(pBuff->maxFillLevel()), "#cc0033");
+			}
+		}
+	}
+
 	// Time to close the clip...
 	pClip->close();
 
@@ -863,6 +882,37 @@ bool qtractorClipCommand::undo (void)
 }
 
 
+// Approximate memory footprint (undo history accounting).
+unsigned long qtractorClipCommand::memorySize (void) const
+{
+	unsigned long iMemorySize = qtractorCommand::memorySize()
+		+ m_items.count() * (sizeof(Item) + sizeof(Item *));
+
+	QListIterator<Item *> iter(m_items);
+	while (iter.hasNext()) {
+		Item *pItem = iter.next();
+		if (pItem->editCommand)
+			iMemorySize += pItem->editCommand->memorySize();
+		if (!pItem->autoDelete || pItem->clip == NULL)
+			continue;
+		// Removed clips are owned here, MIDI ones
+		// with their whole (unshared) sequence...
+		iMemorySize += sizeof(qtractorClip);
+		qtractorTrack *pTrack = pItem->clip->track();
+		if (pTrack && pTrack->trackType() == qtractorTrack::Midi) {
+			qtractorMidiClip *pMidiClip
+				= static_cast<qtractorMidiClip *> (pItem->clip);
+			qtractorMidiSequence *pSeq = pMidiClip->sequence();
+			if (pSeq && !pMidiClip->isHashLinked())
+				iMemorySize += pSeq->events().count()
+					* sizeof(qtractorMidiEvent);
+		}
+	}
+
+	return iMemorySize;
+}
+
+
 //----------------------------------------------------------------------
 // class qtractorClipTakeCommand - declaration.
 //
@@ -1148,6 +1198,22 @@ bool qtractorClipToolCommand::undo (void)
 }
 
 
+// Approximate memory footprint (undo history accounting).
+unsigned long qtractorClipToolCommand::memorySize (void) const
+{
+	unsigned long iMemorySize = qtractorCommand::memorySize();
+
+	QListIterator<qtractorMidiEditCommand *> iter(m_midiEditCommands);
+	while (iter.hasNext()) {
+		qtractorMidiEditCommand *pMidiEditCommand = iter.next();
+		if (pMidiEditCommand)
+			iMemorySize += pMidiEditCommand->memorySize();
+	}
+
+	return iMemorySize;
+}
+
+
 // Filename and length swap transaction...
 void qtractorClipToolCommand::swapMidiClipCtx ( qtractorMidiClip *pMidiClip )
 {
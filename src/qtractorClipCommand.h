@@ -100,6 +100,9 @@ public:
 	bool redo();
 	bool undo();
 
+	// Approximate memory footprint (undo history accounting).
+	unsigned long memorySize() const;
+
 protected:
 
 	// Common executive method.
@@ -265,6 +268,9 @@ public:
 	bool redo();
 	bool undo();
 
+	// Approximate memory footprint (undo history accounting).
+	unsigned long memorySize() const;
+
 protected:
 
 	// Filename and length swap transaction...
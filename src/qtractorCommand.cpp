@@ -29,11 +29,21 @@
 // class qtractorCommandList - declaration.
 //
 
+// Default undo history memory budget (0=unlimited).
+unsigned long qtractorCommandList::g_iDefaultMemoryLimit = 0;
+
+
 // Constructor.
 qtractorCommandList::qtractorCommandList (void)
 {
 	m_pLastCommand = NULL;
 
+	m_iMemoryLimit = g_iDefaultMemoryLimit;
+	m_iMemorySize  = 0;
+
+	m_pPinCommand = NULL;
+	m_bPinned = false;
+
 	m_commands.setAutoDelete(true);
 }
 
@@ -50,6 +60,11 @@ void qtractorCommandList::clear (void)
 	m_commands.clear();
 
 	m_pLastCommand = NULL;
+
+	m_iMemorySize = 0;
+
+	m_pPinCommand = NULL;
+	m_bPinned = false;
 }
 
 
@@ -74,7 +89,7 @@ void qtractorCommandList::removeLastCommand (void)
 {
 	if (m_pLastCommand) {
 		qtractorCommand *pPrevCommand = m_pLastCommand->prev();
-		m_commands.remove(m_pLastCommand);
+		remove(m_pLastCommand);
 		m_pLastCommand = pPrevCommand;
 	}
 }
@@ -101,22 +116,12 @@ void qtractorCommandList::backout ( qtractorCommand *pCommand )
 // Cannonical command methods.
 bool qtractorCommandList::push ( qtractorCommand *pCommand )
 {
-	// Trim the command list from current last command...
-	qtractorCommand *pNextCommand = nextCommand();
-	while (pNextCommand) {
-		qtractorCommand *pLateCommand = pNextCommand->next();
-		m_commands.remove(pNextCommand);
-		pNextCommand = pLateCommand;
-	}
+	const bool bResult = pushCommand(pCommand);
 
-	if (pCommand == NULL)
-		return false;
+	// Keep the undo history within budget...
+	trimMemory();
 
-	// It must be this last one...
-	m_commands.append(pCommand);
-	m_pLastCommand = m_commands.last();
-
-	return (m_pLastCommand != NULL);
+	return bResult;
 }
 
 bool qtractorCommandList::exec ( qtractorCommand *pCommand )
@@ -124,9 +129,13 @@ bool qtractorCommandList::exec ( qtractorCommand *pCommand )
 	bool bResult = false;
 
 	// Append command...
-	if (push(pCommand)) {
+	if (pushCommand(pCommand)) {
 		// Execute operation...
 		bResult = m_pLastCommand->redo();
+		// Keep the undo history within budget,
+		// as its footprint might have changed...
+		account(m_pLastCommand);
+		trimMemory();
 		// Notify commanders...
 		emit updateNotifySignal(m_pLastCommand->flags());
 	}
@@ -134,6 +143,28 @@ bool qtractorCommandList::exec ( qtractorCommand *pCommand )
 	return bResult;
 }
 
+
+// Append command as the last one (no budget trimming).
+bool qtractorCommandList::pushCommand ( qtractorCommand *pCommand )
+{
+	// Trim the command list from current last command...
+	qtractorCommand *pNextCommand = nextCommand();
+	while (pNextCommand) {
+		qtractorCommand *pLateCommand = pNextCommand->next();
+		remove(pNextCommand);
+		pNextCommand = pLateCommand;
+	}
+
+	if (pCommand == NULL)
+		return false;
+
+	// It must be this last one...
+	append(pCommand);
+
+	return (m_pLastCommand != NULL);
+}
+
+
 bool qtractorCommandList::undo (void)
 {
 	bool bResult = false;
@@ -141,6 +172,7 @@ bool qtractorCommandList::undo (void)
 	if (m_pLastCommand) {
 		// Undo operation...
 		bResult = m_pLastCommand->undo();
+		account(m_pLastCommand);
 		// Backward one command...
 		const unsigned int flags = m_pLastCommand->flags();
 		m_pLastCommand = m_pLastCommand->prev();
@@ -160,6 +192,7 @@ bool qtractorCommandList::redo (void)
 	if (m_pLastCommand) {
 		// Redo operation...
 		bResult = m_pLastCommand->redo();
+		account(m_pLastCommand);
 		// Notify commanders...
 		emit updateNotifySignal(m_pLastCommand->flags());
 	}
@@ -187,4 +220,107 @@ void qtractorCommandList::updateAction (
 }
 
 
+// Undo history memory budget (in bytes; 0=unlimited).
+void qtractorCommandList::setMemoryLimit ( unsigned long iMemoryLimit )
+{
+	m_iMemoryLimit = iMemoryLimit;
+
+	trimMemory();
+}
+
+unsigned long qtractorCommandList::memoryLimit (void) const
+{
+	return m_iMemoryLimit;
+}
+
+
+// Current undo history memory footprint (approximate).
+unsigned long qtractorCommandList::memorySize (void) const
+{
+	return m_iMemorySize;
+}
+
+
+// Default undo history memory budget.
+void qtractorCommandList::setDefaultMemoryLimit ( unsigned long iMemoryLimit )
+{
+	g_iDefaultMemoryLimit = iMemoryLimit;
+}
+
+unsigned long qtractorCommandList::defaultMemoryLimit (void)
+{
+	return g_iDefaultMemoryLimit;
+}
+
+
+// Eviction barrier: given command (or history start, if null)
+// and all later ones are never evicted (eg. for a backout).
+void qtractorCommandList::pin ( qtractorCommand *pCommand )
+{
+	m_pPinCommand = pCommand;
+	m_bPinned = true;
+}
+
+void qtractorCommandList::unpin (void)
+{
+	m_pPinCommand = NULL;
+	m_bPinned = false;
+
+	trimMemory();
+}
+
+
+// Append/remove command from chain (accounted for).
+void qtractorCommandList::append ( qtractorCommand *pCommand )
+{
+	m_commands.append(pCommand);
+	m_pLastCommand = m_commands.last();
+
+	pCommand->m_iMemoryAccount = 0;
+	account(pCommand);
+}
+
+void qtractorCommandList::remove ( qtractorCommand *pCommand )
+{
+	if (m_bPinned && pCommand == m_pPinCommand) {
+		m_pPinCommand = NULL;
+		m_bPinned = false;
+	}
+
+	m_iMemorySize -= pCommand->m_iMemoryAccount;
+	m_commands.remove(pCommand);
+}
+
+
+// Re-account command footprint (after redo/undo).
+void qtractorCommandList::account ( qtractorCommand *pCommand )
+{
+	const unsigned long iMemoryAccount = pCommand->memorySize();
+	m_iMemorySize -= pCommand->m_iMemoryAccount;
+	m_iMemorySize += iMemoryAccount;
+	pCommand->m_iMemoryAccount = iMemoryAccount;
+}
+
+
+// Evict oldest commands while over the memory budget;
+// the last (undoable) command and any pinned down are
+// always kept around.
+void qtractorCommandList::trimMemory (void)
+{
+	if (m_iMemoryLimit < 1 || m_pLastCommand == NULL)
+		return;
+
+	if (m_bPinned && m_pPinCommand == NULL)
+		return;
+
+	while (m_iMemorySize > m_iMemoryLimit) {
+		qtractorCommand *pCommand = m_commands.first();
+		if (pCommand == NULL || pCommand == m_pLastCommand
+			|| (m_bPinned && pCommand == m_pPinCommand))
+			break;
+		remove(pCommand);
+	}
+}
+
+
 // end of qtractorCommand.cpp
@@ -41,7 +41,7 @@ public:
 
 	// Constructor.
 	qtractorCommand(const QString& sName)
-		: m_sName(sName), m_flags(Refresh) {}
+		: m_sName(sName), m_flags(Refresh), m_iMemoryAccount(0) {}
 
 	// Virtual destructor.
 	virtual ~qtractorCommand() {}
@@ -88,6 +88,10 @@ public:
 	virtual bool redo() = 0;
 	virtual bool undo() = 0;
 
+	// Approximate memory footprint (undo history accounting).
+	virtual unsigned long memorySize() const
+		{ return sizeof(*this) + m_sName.length() * sizeof(QChar); }
+
 protected:
 
 	// Discrete flag accessors.
@@ -102,6 +106,11 @@ private:
 	// Instance variables.
 	QString      m_sName;
 	unsigned int m_flags;
+
+	// Footprint as last accounted for by the command list.
+	unsigned long m_iMemoryAccount;
+
+	friend class qtractorCommandList;
 };
 
 
@@ -144,17 +153,56 @@ public:
 	// Command action update helper.
 	void updateAction(QAction *pAction, qtractorCommand *pCommand) const;
 
+	// Undo history memory budget (in bytes; 0=unlimited).
+	void setMemoryLimit(unsigned long iMemoryLimit);
+	unsigned long memoryLimit() const;
+
+	// Current undo history memory footprint (approximate).
+	unsigned long memorySize() const;
+
+	// Default undo history memory budget.
+	static void setDefaultMemoryLimit(unsigned long iMemoryLimit);
+	static unsigned long defaultMemoryLimit();
+
+	// Eviction barrier: given command (or history start, if null)
+	// and all later ones are never evicted (eg. for a backout).
+	void pin(qtractorCommand *pCommand);
+	void unpin();
+
 signals:
 
 	// Command update notification.
 	void updateNotifySignal(unsigned int);
 
+protected:
+
+	// Append command as the last one (no budget trimming).
+	bool pushCommand(qtractorCommand *pCommand);
+
+	// Append/remove command from chain (accounted for).
+	void append(qtractorCommand *pCommand);
+	void remove(qtractorCommand *pCommand);
+
+	// Re-account command footprint (after redo/undo).
+	void account(qtractorCommand *pCommand);
+
+	// Evict oldest commands while over the memory budget.
+	void trimMemory();
+
 private:
 
 	// Instance variables.
 	qtractorList<qtractorCommand> m_commands;
 
 	qtractorCommand *m_pLastCommand;
+
+	unsigned long m_iMemoryLimit;
+	unsigned long m_iMemorySize;
+
+	qtractorCommand *m_pPinCommand;
+	bool m_bPinned;
+
+	static unsigned long g_iDefaultMemoryLimit;
 };
 
 
@@ -190,7 +190,8 @@ qtractorCurve::qtractorCurve ( qtractorCurveList *pList,
 	qtractorSubject *pSubject, Mode mode, unsigned int iMinFrameDist )
 	: m_pList(pList), m_mode(mode), m_iMinFrameDist(iMinFrameDist),
 		m_observer(pSubject, this), m_state(Idle), m_cursor(this),
-		m_bLogarithmic(false), m_color(Qt::darkRed), m_pEditList(NULL)
+		m_bLogarithmic(false), m_color(Qt::darkRed), m_pEditList(NULL),
+		m_bActive(false)
 {
 	m_nodes.setAutoDelete(true);
 
@@ -544,6 +545,32 @@ void qtractorCurve::Cursor::reset ( qtractorCurve::Node *pNode )
 }
 
 
+// Whether the value changes over the given frame range
+// (sub-block automation candidate; cached as active state).
+bool qtractorCurve::updateActive (
+	unsigned long iFrameStart, unsigned long iFrameEnd )
+{
+	m_bActive = false;
+
+	if (isProcess() && !isCapture()) {
+		const Node *pNode = seek(iFrameStart);
+		if (pNode) {
+			// Any node within range, or a sloping segment?
+			if (pNode->frame < iFrameEnd) {
+				m_bActive = true;
+			}
+			else
+			if (mode() != Hold) {
+				const Node *pPrev = pNode->prev();
+				m_bActive = (pPrev && pPrev->value != pNode->value);
+			}
+		}
+	}
+
+	return m_bActive;
+}
+
+
 // Common interpolate method.
 float qtractorCurve::value ( const Node *pNode, unsigned long iFrame ) const
 {
@@ -846,4 +873,20 @@ bool qtractorCurveEditList::execute ( bool bRedo )
 }
 
 
+//----------------------------------------------------------------------
+// qtractorCurveList -- Sub-block automation granularity (global option).
+
+unsigned int qtractorCurveList::g_iSubBlockSize = 0;
+
+void qtractorCurveList::setSubBlockSize ( unsigned int iSubBlockSize )
+{
+	g_iSubBlockSize = iSubBlockSize;
+}
+
+unsigned int qtractorCurveList::subBlockSize (void)
+{
+	return g_iSubBlockSize;
+}
+
+
 // end of qtractorCurve.cpp
@@ -211,6 +211,23 @@ public:
 
 	void process() { process(m_cursor.frame()); }
 
+	// Sub-block automation procedure (realtime-safe);
+	// sets the subject value only, with no notification.
+	void processEx(unsigned long iFrame)
+	{
+		if (isProcess() && !isCapture()) {
+			qtractorSubject *pSubject = m_observer.subject();
+			if (pSubject)
+				pSubject->setValueEx(value(iFrame));
+		}
+	}
+
+	// Whether the value changes over the given frame range
+	// (sub-block automation candidate; cached as active state).
+	bool updateActive(unsigned long iFrameStart, unsigned long iFrameEnd);
+	bool isActive() const
+		{ return m_bActive; }
+
 	// Record automation procedure.
 	void capture(unsigned long iFrame)
 	{
@@ -313,6 +330,9 @@ private:
 
 	// Capture (record) edit list.
 	qtractorCurveEditList *m_pEditList;
+
+	// Sub-block automation active state.
+	bool m_bActive;
 };
 
 
@@ -511,6 +531,37 @@ public:
 		}
 	}
 
+	// Sub-block automation: mark curves changing over the given
+	// frame range; returns the number of those active ones.
+	unsigned int updateActive(
+		unsigned long iFrameStart, unsigned long iFrameEnd)
+	{
+		unsigned int iActive = 0;
+		qtractorCurve *pCurve = first();
+		while (pCurve) {
+			if (pCurve->updateActive(iFrameStart, iFrameEnd))
+				++iActive;
+			pCurve = pCurve->next();
+		}
+		return iActive;
+	}
+
+	// Sub-block automation procedure (active curves only;
+	// realtime-safe, observers get notified later as usual).
+	void processActive(unsigned long iFrame)
+	{
+		qtractorCurve *pCurve = first();
+		while (pCurve) {
+			if (pCurve->isActive())
+				pCurve->processEx(iFrame);
+			pCurve = pCurve->next();
+		}
+	}
+
+	// Sub-block automation granularity (in frames; 0=disabled).
+	static void setSubBlockSize(unsigned int iSubBlockSize);
+	static unsigned int subBlockSize();
+
 	// Process management.
 	void updateProcess(bool bProcess)
 	{
@@ -634,6 +685,9 @@ private:
 
 	// Current selected curve.
 	qtractorCurve *m_pCurrentCurve;
+
+	// Sub-block automation granularity (global option).
+	static unsigned int g_iSubBlockSize;
 };
 
 
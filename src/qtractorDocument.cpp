@@ -31,10 +31,19 @@
 
 #include <QDomDocument>
 
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+
 #include <QFileInfo>
 #include <QTextStream>
 #include <QDir>
 
+#if QT_VERSION >= 0x050100
+#include <QSaveFile>
+#else
+#include <stdio.h>
+#endif
+
 
 // Local prototypes.
 static void remove_dir_list(const QList<QFileInfo>& list);
@@ -72,6 +81,191 @@ static void remove_dir_list ( const QList<QFileInfo>& list )
 }
 
 
+//-------------------------------------------------------------------------
+// qtractorDocument::Writer -- Streaming document writer.
+//
+// Complete (sub)elements are written out as soon as they're flushed, then
+// removed from the DOM, so that the whole document never gets to stay in
+// memory, only the currently open element path and its pending children.
+//
+
+class qtractorDocument::Writer
+{
+public:
+
+	// Constructor.
+	Writer(QIODevice *pDevice) : m_xml(pDevice)
+	{
+		m_xml.setAutoFormatting(true);
+		m_xml.setAutoFormattingIndent(1);
+	}
+
+	// Document prologue.
+	void start(const QDomDocument& doc)
+	{
+		m_xml.writeStartDocument();
+		const QString& sDocType = doc.doctype().name();
+		if (!sDocType.isEmpty())
+			m_xml.writeDTD("<!DOCTYPE " + sDocType + '>');
+	}
+
+	// Write out a complete element (path from the root element down).
+	void flush(const QList<QDomElement>& path, QDomElement& elem)
+	{
+		// Close open elements that are not in path anymore...
+		int i = 0;
+		while (i < m_stack.count() && i < path.count()
+			&& m_stack.at(i) == path.at(i))
+			++i;
+		while (m_stack.count() > i)
+			closeElement();
+		// Open the path elements not open yet...
+		for ( ; i < path.count(); ++i) {
+			const QDomElement& eOpen = path.at(i);
+			writeBefore(eOpen);
+			writeStartElement(eOpen);
+			m_stack.append(eOpen);
+		}
+		// Write previous pending siblings and the element itself...
+		writeBefore(elem);
+		writeNode(elem);
+		elem.parentNode().removeChild(elem);
+	}
+
+	// Document epilogue.
+	void finish(const QDomElement& root)
+	{
+		if (m_stack.isEmpty())
+			writeNode(root);
+		else while (!m_stack.isEmpty())
+			closeElement();
+		m_xml.writeEndDocument();
+	}
+
+	bool hasError() const { return m_xml.hasError(); }
+
+protected:
+
+	// Write and release all children preceding the given one.
+	void writeBefore(const QDomNode& node)
+	{
+		QDomNode nParent = node.parentNode();
+		if (!nParent.isElement())
+			return;
+		QDomNode nChild = nParent.firstChild();
+		while (!nChild.isNull() && nChild != node) {
+			const QDomNode nNext = nChild.nextSibling();
+			writeNode(nChild);
+			nParent.removeChild(nChild);
+			nChild = nNext;
+		}
+	}
+
+	// Write and release what's left of the innermost open element.
+	void closeElement()
+	{
+		QDomElement elem = m_stack.takeLast();
+		QDomNode nChild = elem.firstChild();
+		while (!nChild.isNull()) {
+			const QDomNode nNext = nChild.nextSibling();
+			writeNode(nChild);
+			elem.removeChild(nChild);
+			nChild = nNext;
+		}
+		m_xml.writeEndElement();
+		QDomNode nParent = elem.parentNode();
+		if (nParent.isElement())
+			nParent.removeChild(elem);
+	}
+
+	void writeStartElement(const QDomElement& elem)
+	{
+		m_xml.writeStartElement(elem.tagName());
+		const QDomNamedNodeMap& attrs = elem.attributes();
+		const int iCount = attrs.count();
+		for (int i = 0; i < iCount; ++i) {
+			const QDomAttr& attr = attrs.item(i).toAttr();
+			m_xml.writeAttribute(attr.name(), attr.value());
+		}
+	}
+
+	void writeNode(const QDomNode& node)
+	{
+		if (node.isElement()) {
+			writeStartElement(node.toElement());
+			for (QDomNode nChild = node.firstChild();
+					!nChild.isNull();
+						nChild = nChild.nextSibling()) {
+				writeNode(nChild);
+			}
+			m_xml.writeEndElement();
+		}
+		else
+		if (node.isCDATASection())
+			m_xml.writeCDATA(node.toCDATASection().data());
+		else
+		if (node.isText())
+			m_xml.writeCharacters(node.toText().data());
+		else
+		if (node.isComment())
+			m_xml.writeComment(node.toComment().data());
+	}
+
+private:
+
+	// Instance variables.
+	QXmlStreamWriter m_xml;
+
+	// Currently open element path.
+	QList<QDomElement> m_stack;
+};
+
+
+// Incremental DOM document parser (no whole file text in memory).
+static bool read_document ( QIODevice *pDevice, QDomDocument *pDocument )
+{
+	QXmlStreamReader xml(pDevice);
+
+	QDomNode node = *pDocument;
+	while (!xml.atEnd()) {
+		switch (xml.readNext()) {
+		case QXmlStreamReader::StartElement: {
+			QDomElement elem
+				= pDocument->createElement(xml.qualifiedName().toString());
+			const QXmlStreamAttributes& attrs = xml.attributes();
+			QXmlStreamAttributes::ConstIterator iter = attrs.constBegin();
+			const QXmlStreamAttributes::ConstIterator& iter_end = attrs.constEnd();
+			for ( ; iter != iter_end; ++iter) {
+				elem.setAttribute(iter->qualifiedName().toString(),
+					iter->value().toString());
+			}
+			node.appendChild(elem);
+			node = elem;
+			break;
+		}
+		case QXmlStreamReader::EndElement:
+			node = node.parentNode();
+			break;
+		case QXmlStreamReader::Characters:
+			if (xml.isCDATA()) {
+				node.appendChild(
+					pDocument->createCDATASection(xml.text().toString()));
+			}
+			else
+			if (!xml.isWhitespace()) {
+				node.appendChild(
+					pDocument->createTextNode(xml.text().toString()));
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	return !xml.hasError();
+}
+
+
 //-------------------------------------------------------------------------
 // qtractorDocument -- Session file import/export helper class.
 //
@@ -92,7 +286,7 @@ qtractorDocument *qtractorDocument::g_pDocument = NULL;
 qtractorDocument::qtractorDocument ( QDomDocument *pDocument,
 	const QString& sTagName, Flags flags )
 	: m_pDocument(pDocument), m_sTagName(sTagName), m_flags(flags),
-		m_pZipFile(NULL)
+		m_pZipFile(NULL), m_pWriter(NULL)
 {
 }
 
@@ -138,6 +332,30 @@ void qtractorDocument::saveTextElement ( const QString& sTagName,
 }
 
 
+// Streaming save: write out (and release) a complete element,
+// along with any of its pending ancestors and preceding siblings.
+void qtractorDocument::flushElement ( QDomElement *pElement )
+{
+	// Not saving or not streaming, keep it all around...
+	if (m_pWriter == NULL)
+		return;
+
+	// Get the ancestry path, from the root element down;
+	// must be attached to the document, otherwise bail out...
+	QList<QDomElement> path;
+	QDomNode node = pElement->parentNode();
+	while (node.isElement()) {
+		path.prepend(node.toElement());
+		node = node.parentNode();
+	}
+
+	if (path.isEmpty() || !node.isDocument())
+		return;
+
+	m_pWriter->flush(path, *pElement);
+}
+
+
 // Document flags property.
 void qtractorDocument::setFlags ( Flags flags )
 {
@@ -239,8 +457,8 @@ bool qtractorDocument::load ( const QString& sFilename, Flags flags )
 	QFile file(sDocname);
 	if (!file.open(mode))
 		return false;
-	// Parse it a-la-DOM :-)
-	if (!m_pDocument->setContent(&file)) {
+	// Parse it a-la-DOM, incrementally :-)
+	if (!read_document(&file, m_pDocument)) {
 		file.close();
 		return false;
 	}
@@ -297,30 +515,67 @@ bool qtractorDocument::save ( const QString& sFilename, Flags flags )
 	}
 #endif
 
+	// We're ready to stream to external file,
+	// through a temporary one, just in case;
+	// the original is only ever replaced atomically...
+	QFile file(sDocname);
+#ifdef CONFIG_LIBZ
+	const bool bRemove = !file.exists();
+#endif
+#if QT_VERSION >= 0x050100
+	QSaveFile temp(sDocname);
+#else
+	const QFileInfo fi(sDocname);
+	const QString sTarget
+		= (fi.isSymLink() ? fi.symLinkTarget() : sDocname);
+	QFile temp(sTarget + ".tmp");
+#endif
+	if (!temp.open(mode))
+		return false;
+
 	// Officially saving now...
 	g_pDocument = this;
 
+	m_pWriter = new Writer(&temp);
+	m_pWriter->start(*m_pDocument);
+
 	// Save spec...
 	QDomElement elem = m_pDocument->createElement(m_sTagName);
-	if (!saveElement(&elem)) {
-		g_pDocument = NULL;
-		return false;
-	}
 	m_pDocument->appendChild(elem);
+	bool bResult = saveElement(&elem);
+	if (bResult) {
+		m_pWriter->finish(elem);
+		bResult = !m_pWriter->hasError();
+	}
+
+	delete m_pWriter;
+	m_pWriter = NULL;
 
 	// Not saving anymore...
 	g_pDocument = NULL;
 
-	// Finally, we're ready to save to external file.
-	QFile file(sDocname);
-#ifdef CONFIG_LIBZ
-	const bool bRemove = !file.exists();
-#endif
-	if (!file.open(mode))
+#if QT_VERSION >= 0x050100
+	if (!bResult) {
+		temp.cancelWriting();
 		return false;
-	QTextStream ts(&file);
-	ts << m_pDocument->toString() << endl;
-	file.close();
+	}
+
+	if (!temp.commit())
+		return false;
+#else
+	temp.close();
+
+	if (!bResult) {
+		temp.remove();
+		return false;
+	}
+
+	if (::rename(QFile::encodeName(temp.fileName()).constData(),
+			QFile::encodeName(sTarget).constData()) != 0) {
+		temp.remove();
+		return false;
+	}
+#endif
 
 #ifdef CONFIG_LIBZ
 	// Commit to archive.
@@ -62,6 +62,10 @@ public:
 	void saveTextElement (const QString& sTagName, const QString& sText,
 		QDomElement *pElement);
 
+	// Streaming save: write out (and release) a complete element,
+	// along with any of its pending ancestors and preceding siblings.
+	void flushElement (QDomElement *pElement);
+
 	// Document flags property accessors.
 	bool isTemplate() const;
 	bool isArchive() const;
@@ -118,6 +122,11 @@ private:
 	// Archive stuff.
 	qtractorZipFile *m_pZipFile;
 
+	// Streaming save writer.
+	class Writer;
+
+	Writer *m_pWriter;
+
 	// Temporary files;
 	QStringList m_tempFiles;
 
@@ -0,0 +1,133 @@
+// qtractorEpoch.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2018, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qtractorAbout.h"
+#include "qtractorEpoch.h"
+
+#include <QMutex>
+
+
+// Retired items list lock (non-RT).
+static QMutex g_mutex;
+
+
+//----------------------------------------------------------------------
+// class qtractorEpoch -- Deferred reclamation of realtime shared data.
+//
+
+// Reader process cycle counts.
+qtractorAtomic qtractorEpoch::g_readers[qtractorEpoch::Readers];
+
+// Retired items list.
+qtractorEpoch::Item *qtractorEpoch::g_pItems = NULL;
+
+
+// Retire an item, to be reclaimed as soon as no
+// realtime reader may still be holding on to it.
+void qtractorEpoch::retire ( Item *pItem )
+{
+	if (pItem == NULL)
+		return;
+
+	QMutexLocker locker(&g_mutex);
+
+	// Stamp current reader counts (nb. after publishing)...
+	for (int i = 0; i < Readers; ++i)
+		pItem->m_aiReaders[i] = ATOMIC_GET(&g_readers[i]);
+
+	pItem->m_pNextItem = g_pItems;
+	g_pItems = pItem;
+
+	locker.unlock();
+
+	// Take the chance for some housekeeping...
+	collect();
+}
+
+
+// Reclaim all retired items that are safe to go.
+void qtractorEpoch::collect (void)
+{
+	QMutexLocker locker(&g_mutex);
+
+	Item *pItems = NULL;
+	Item *pPrevItem = NULL;
+	Item *pItem = g_pItems;
+	while (pItem) {
+		Item *pNextItem = pItem->m_pNextItem;
+		if (isQuiescent(pItem)) {
+			if (pPrevItem)
+				pPrevItem->m_pNextItem = pNextItem;
+			else
+				g_pItems = pNextItem;
+			pItem->m_pNextItem = pItems;
+			pItems = pItem;
+		} else {
+			pPrevItem = pItem;
+		}
+		pItem = pNextItem;
+	}
+
+	locker.unlock();
+
+	// Actual reclamation goes unlocked...
+	while (pItems) {
+		Item *pNextItem = pItems->m_pNextItem;
+		delete pItems;
+		pItems = pNextItem;
+	}
+}
+
+
+// Reclaim all retired items, unconditionally
+// (only when realtime readers are all gone).
+void qtractorEpoch::clear (void)
+{
+	QMutexLocker locker(&g_mutex);
+
+	Item *pItem = g_pItems;
+	g_pItems = NULL;
+
+	locker.unlock();
+
+	while (pItem) {
+		Item *pNextItem = pItem->m_pNextItem;
+		delete pItem;
+		pItem = pNextItem;
+	}
+}
+
+
+// Whether an item is safe to reclaim: every reader was either
+// outside a cycle when it got retired, or has moved on since.
+bool qtractorEpoch::isQuiescent ( const Item *pItem )
+{
+	for (int i = 0; i < Readers; ++i) {
+		const int iReader = pItem->m_aiReaders[i];
+		if ((iReader & 1) && ATOMIC_GET(&g_readers[i]) == iReader)
+			return false;
+	}
+
+	return true;
+}
+
+
+// end of qtractorEpoch.cpp
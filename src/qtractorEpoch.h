@@ -0,0 +1,111 @@
+// qtractorEpoch.h
+//
+/****************************************************************************
+   Copyright (C) 2005-2018, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qtractorEpoch_h
+#define __qtractorEpoch_h
+
+#include "qtractorAtomic.h"
+
+
+//----------------------------------------------------------------------
+// class qtractorEpoch -- Deferred reclamation of realtime shared data.
+//
+// Data shared with the realtime threads gets published by an atomic
+// pointer swap; the old copy is then retired, and only reclaimed once
+// every realtime reader has left any process cycle it was in.
+//
+
+class qtractorEpoch
+{
+public:
+
+	// Realtime reader threads.
+	enum Reader { Audio = 0, Midi, Readers };
+
+	// Reader process cycle markers (RT-safe);
+	// odd counts mean the reader is inside a cycle.
+	static void enter(Reader reader) { ATOMIC_INC(&g_readers[reader]); }
+	static void leave(Reader reader) { ATOMIC_INC(&g_readers[reader]); }
+
+	// Retired item base (destructor does the actual cleanup).
+	class Item
+	{
+	public:
+
+		// Constructor.
+		Item() : m_pNextItem(0) {}
+
+		// Virtual destructor.
+		virtual ~Item() {}
+
+	private:
+
+		friend class qtractorEpoch;
+
+		// Reader counts as of retirement.
+		int   m_aiReaders[Readers];
+		Item *m_pNextItem;
+	};
+
+	// Retire an item, to be reclaimed as soon as no
+	// realtime reader may still be holding on to it.
+	static void retire(Item *pItem);
+
+	// Reclaim all retired items that are safe to go.
+	static void collect();
+
+	// Reclaim all retired items, unconditionally
+	// (only when realtime readers are all gone).
+	static void clear();
+
+	// Atomic pointer publish (ordered); returns the old one.
+	template <typename T>
+	static T *publish(QAtomicPointer<T>& ptr, T *pNew)
+		{ return ptr.fetchAndStoreOrdered(pNew); }
+
+	// Atomic pointer fetch (acquire).
+	template <typename T>
+	static T *fetch(const QAtomicPointer<T>& ptr)
+	{
+	#if QT_VERSION >= 0x050000
+		return ptr.loadAcquire();
+	#else
+		return ptr;
+	#endif
+	}
+
+private:
+
+	// Whether an item is safe to reclaim.
+	static bool isQuiescent(const Item *pItem);
+
+	// Reader process cycle counts.
+	static qtractorAtomic g_readers[Readers];
+
+	// Retired items list.
+	static Item *g_pItems;
+};
+
+
+#endif  // __qtractorEpoch_h
+
+
+// end of qtractorEpoch.h
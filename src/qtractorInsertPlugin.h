@@ -347,6 +347,10 @@ public:
 	void setAudioBusName(const QString& sAudioBusName);
 	const QString& audioBusName() const;
 
+	// Audio send bus accessor.
+	qtractorAudioBus *audioBus() const
+		{ return m_pAudioBus; }
+
 	// Audio bus to appear on plugin lists.
 	void updateAudioBusName() const;
 
@@ -55,8 +55,192 @@
 // URI map/unmap features.
 #include "lv2/lv2plug.in/ns/ext/urid/urid.h"
 
-static QHash<QString, LV2_URID>    g_uri_map;
-static QHash<LV2_URID, QByteArray> g_ids_map;
+#include "qtractorEpoch.h"
+#include "qtractorAtomic.h"
+
+#include <QMutex>
+#include <QAtomicPointer>
+
+
+//----------------------------------------------------------------------
+// class qtractorLv2UridMap -- Concurrent URID map/unmap table.
+//
+// Lookups are lock-free and never allocate; inserts are serialized.
+// Entries are never removed (until exit), so readers may walk the
+// hash chains and the identifier blocks from any thread, any time.
+//
+
+class qtractorLv2UridMap
+{
+public:
+
+	// Constructor.
+	qtractorLv2UridMap();
+
+	// Destructor.
+	~qtractorLv2UridMap();
+
+	// Map/unmap methods.
+	LV2_URID map(const char *uri);
+	const char *unmap(LV2_URID id) const;
+
+protected:
+
+	// Table entry.
+	struct Entry
+	{
+		Entry *next;
+		unsigned int hash;
+		LV2_URID id;
+		char *uri;
+	};
+
+	// Lock-free lookup.
+	const Entry *find(const char *uri, unsigned int hash) const;
+
+	// String hash function (FNV-1a).
+	static unsigned int hash(const char *uri);
+
+private:
+
+	// Table dimensions (first identifier is 1000).
+	enum { IdBase = 1000, NumBuckets = 1024,
+		IdBlockSize = 256, NumIdBlocks = 4096 };
+
+	// Hash chain heads.
+	QAtomicPointer<Entry> m_buckets[NumBuckets];
+
+	// Identifier to entry blocks.
+	typedef QAtomicPointer<Entry> Slot;
+	QAtomicPointer<Slot> m_idBlocks[NumIdBlocks];
+
+	// Next identifier to hand out.
+	qtractorAtomic m_iNextId;
+
+	// Insert (writer) serialization.
+	QMutex m_mutex;
+};
+
+
+// Constructor.
+qtractorLv2UridMap::qtractorLv2UridMap (void)
+{
+	ATOMIC_SET(&m_iNextId, IdBase);
+}
+
+
+// Destructor.
+qtractorLv2UridMap::~qtractorLv2UridMap (void)
+{
+	for (unsigned int i = 0; i < NumBuckets; ++i) {
+		Entry *pEntry = qtractorEpoch::fetch(m_buckets[i]);
+		while (pEntry) {
+			Entry *pNext = pEntry->next;
+			::free(pEntry->uri);
+			delete pEntry;
+			pEntry = pNext;
+		}
+	}
+
+	for (unsigned int j = 0; j < NumIdBlocks; ++j) {
+		Slot *pBlock = qtractorEpoch::fetch(m_idBlocks[j]);
+		if (pBlock)
+			delete [] pBlock;
+	}
+}
+
+
+// String hash function (FNV-1a).
+unsigned int qtractorLv2UridMap::hash ( const char *uri )
+{
+	unsigned int h = 2166136261u;
+	while (*uri) {
+		h ^= (unsigned char) *uri++;
+		h *= 16777619u;
+	}
+	return h;
+}
+
+
+// Lock-free lookup.
+const qtractorLv2UridMap::Entry *qtractorLv2UridMap::find (
+	const char *uri, unsigned int h ) const
+{
+	const Entry *pEntry = qtractorEpoch::fetch(m_buckets[h & (NumBuckets - 1)]);
+	while (pEntry) {
+		if (pEntry->hash == h && ::strcmp(pEntry->uri, uri) == 0)
+			break;
+		pEntry = pEntry->next;
+	}
+	return pEntry;
+}
+
+
+// Map method.
+LV2_URID qtractorLv2UridMap::map ( const char *uri )
+{
+	const unsigned int h = hash(uri);
+
+	// Fast path: already there...
+	const Entry *pEntry = find(uri, h);
+	if (pEntry)
+		return pEntry->id;
+
+	QMutexLocker locker(&m_mutex);
+
+	// Someone else might have just inserted it...
+	pEntry = find(uri, h);
+	if (pEntry)
+		return pEntry->id;
+
+	const LV2_URID id = ATOMIC_GET(&m_iNextId);
+	const unsigned int k = id - IdBase;
+	const unsigned int j = k / IdBlockSize;
+	if (j >= NumIdBlocks)
+		return 0; // Table full (very unlikely).
+
+	Slot *pBlock = qtractorEpoch::fetch(m_idBlocks[j]);
+	if (pBlock == NULL) {
+		pBlock = new Slot [IdBlockSize];
+		qtractorEpoch::publish(m_idBlocks[j], pBlock);
+	}
+
+	// Fully set up the new entry before publishing it...
+	Entry *pNewEntry = new Entry;
+	pNewEntry->hash = h;
+	pNewEntry->id   = id;
+	pNewEntry->uri  = ::strdup(uri);
+
+	const unsigned int i = (h & (NumBuckets - 1));
+	pNewEntry->next = qtractorEpoch::fetch(m_buckets[i]);
+
+	qtractorEpoch::publish(pBlock[k % IdBlockSize], pNewEntry);
+	qtractorEpoch::publish(m_buckets[i], pNewEntry);
+
+	m_iNextId.fetchAndStoreRelease(id + 1);
+
+	return id;
+}
+
+
+// Unmap method (lock-free).
+const char *qtractorLv2UridMap::unmap ( LV2_URID id ) const
+{
+	if (id < IdBase || id >= LV2_URID(ATOMIC_GET(&m_iNextId)))
+		return NULL;
+
+	const unsigned int k = id - IdBase;
+	const Slot *pBlock = qtractorEpoch::fetch(m_idBlocks[k / IdBlockSize]);
+	if (pBlock == NULL)
+		return NULL;
+
+	const Entry *pEntry = qtractorEpoch::fetch(pBlock[k % IdBlockSize]);
+	return (pEntry ? pEntry->uri : NULL);
+}
+
+
+// The global URID map/unmap table.
+static qtractorLv2UridMap g_lv2_urid_table;
 
 
 static LV2_URID qtractor_lv2_urid_map (
@@ -154,31 +338,15 @@ static const void *qtractor_lv2_state_retrieve ( LV2_State_Handle handle,
 #endif	// CONFIG_LV2_STATE
 
 
-// URI map helpers (static).
+// URI map helpers (static; realtime-safe when already mapped).
 LV2_URID qtractorLv2Plugin::lv2_urid_map ( const char *uri )
 {
-	const QString sUri(uri);
-
-	QHash<QString, uint32_t>::ConstIterator iter
-		= g_uri_map.constFind(sUri);
-	if (iter == g_uri_map.constEnd()) {
-		LV2_URID id = g_uri_map.size() + 1000;
-		g_uri_map.insert(sUri, id);
-		g_ids_map.insert(id, sUri.toUtf8());
-		return id;
-	}
-
-	return iter.value();
+	return g_lv2_urid_table.map(uri);
 }
 
 const char *qtractorLv2Plugin::lv2_urid_unmap ( LV2_URID id )
 {
-	QHash<LV2_URID, QByteArray>::ConstIterator iter
-		= g_ids_map.constFind(id);
-	if (iter == g_ids_map.constEnd())
-		return NULL;
-
-	return iter.value().constData();
+	return g_lv2_urid_table.unmap(id);
 }
 
 
@@ -188,7 +356,11 @@ const char *qtractorLv2Plugin::lv2_urid_unmap ( LV2_URID id )
 #include <QThread>
 #include <QMutex>
 #include <QWaitCondition>
+#include <QList>
 
+#include "qtractorAtomic.h"
+
+#include <jack/jack.h>
 #include <jack/ringbuffer.h>
 
 //----------------------------------------------------------------------
@@ -211,11 +383,11 @@ public:
 	LV2_Feature **lv2_features() const
 		{ return m_lv2_features; }
 
-	// Schedule work.
-	void schedule(uint32_t size, const void *data);
+	// Schedule work (false on full request queue).
+	bool schedule(uint32_t size, const void *data);
 
-	// Respond work.
-	void respond(uint32_t size, const void *data);
+	// Respond work (false on full response queue).
+	bool respond(uint32_t size, const void *data);
 
 	// Commit work.
 	void commit();
@@ -223,6 +395,21 @@ public:
 	// Process work.
 	void process();
 
+	// Pending work flag (lock-free, set by any scheduler).
+	void setPending() { ATOMIC_SET(&m_pending, 1); }
+	bool takePending() { return ATOMIC_CAS(&m_pending, 1, 0); }
+
+	// Schedule/respond round-trip stats (microseconds).
+	unsigned long statsCount() const { return m_iStatsCount; }
+	unsigned long statsAvgTime() const
+		{ return (m_iStatsCount > 0 ? m_iStatsTotal / m_iStatsCount : 0); }
+	unsigned long statsMaxTime() const { return m_iStatsMax; }
+	unsigned long statsDrops() const { return m_iStatsDrops; }
+
+	// Worker thread pool concurrency (0=one thread per plugin).
+	static void setWorkerThreads(unsigned int iWorkerThreads);
+	static unsigned int workerThreads();
+
 private:
 
 	// Instance members.
@@ -237,8 +424,24 @@ private:
 	jack_ringbuffer_t  *m_pResponses;
 	void               *m_pResponse;
 
-	static qtractorLv2WorkerThread *g_pWorkerThread;
-	static unsigned int             g_iWorkerRefCount;
+	// Assigned worker thread (from pool).
+	qtractorLv2WorkerThread *m_pWorkerThread;
+
+	// Pending work flag.
+	qtractorAtomic      m_pending;
+
+	// Schedule time of the request being worked on.
+	jack_time_t         m_iWorkTime;
+
+	// Schedule/respond round-trip stats.
+	volatile unsigned long m_iStatsCount;
+	volatile unsigned long m_iStatsTotal;
+	volatile unsigned long m_iStatsMax;
+	volatile unsigned long m_iStatsDrops;
+
+	// Worker thread pool.
+	static QList<qtractorLv2WorkerThread *> g_workerThreads;
+	static unsigned int g_iWorkerThreads;
 };
 
 static LV2_Worker_Status qtractor_lv2_worker_schedule (
@@ -253,8 +456,8 @@ static LV2_Worker_Status qtractor_lv2_worker_schedule (
 	qDebug("qtractor_lv2_worker_schedule(%p, %u, %p)", pLv2Worker, size, data);
 #endif
 
-	pLv2Worker->schedule(size, data);
-	return LV2_WORKER_SUCCESS;
+	return (pLv2Worker->schedule(size, data)
+		? LV2_WORKER_SUCCESS : LV2_WORKER_ERR_NO_SPACE);
 }
 
 static LV2_Worker_Status qtractor_lv2_worker_respond (
@@ -269,8 +472,8 @@ static LV2_Worker_Status qtractor_lv2_worker_respond (
 	qDebug("qtractor_lv2_worker_respond(%p, %u, %p)", pLv2Worker, size, data);
 #endif
 
-	pLv2Worker->respond(size, data);
-	return LV2_WORKER_SUCCESS;
+	return (pLv2Worker->respond(size, data)
+		? LV2_WORKER_SUCCESS : LV2_WORKER_ERR_NO_SPACE);
 }
 
 //----------------------------------------------------------------------
@@ -281,9 +484,7 @@ class qtractorLv2WorkerThread : public QThread
 public:
 
 	// Constructor.
-	qtractorLv2WorkerThread(unsigned int iSyncSize = 128);
-	// Destructor.
-	~qtractorLv2WorkerThread();
+	qtractorLv2WorkerThread();
 
 	// Thread run state accessors.
 	void setRunState(bool bRunState);
@@ -292,6 +493,11 @@ public:
 	// Wake from executive wait condition.
 	void sync(qtractorLv2Worker *pLv2Worker = NULL);
 
+	// Assigned workers (pool load).
+	void attach(qtractorLv2Worker *pLv2Worker);
+	int detach(qtractorLv2Worker *pLv2Worker);
+	int refCount() const { return m_workers.count(); }
+
 protected:
 
 	// The main thread executive.
@@ -299,13 +505,8 @@ protected:
 
 private:
 
-	// The peak file queue instance reference.
-	unsigned int          m_iSyncSize;
-	unsigned int          m_iSyncMask;
-	qtractorLv2Worker   **m_ppSyncItems;
-
-	volatile unsigned int m_iSyncRead;
-	volatile unsigned int m_iSyncWrite;
+	// Assigned workers (only changed while thread is waiting).
+	QList<qtractorLv2Worker *> m_workers;
 
 	// Whether the thread is logically running.
 	volatile bool m_bRunState;
@@ -316,27 +517,11 @@ private:
 };
 
 // Constructor.
-qtractorLv2WorkerThread::qtractorLv2WorkerThread ( unsigned int iSyncSize )
+qtractorLv2WorkerThread::qtractorLv2WorkerThread (void)
 {
-	m_iSyncSize = (64 << 1);
-	while (m_iSyncSize < iSyncSize)
-		m_iSyncSize <<= 1;
-	m_iSyncMask = (m_iSyncSize - 1);
-	m_ppSyncItems = new qtractorLv2Worker * [m_iSyncSize];
-	m_iSyncRead   = 0;
-	m_iSyncWrite  = 0;
-
-	::memset(m_ppSyncItems, 0, m_iSyncSize * sizeof(qtractorLv2Worker *));
-
 	m_bRunState = false;
 }
 
-// Destructor.
-qtractorLv2WorkerThread::~qtractorLv2WorkerThread (void)
-{
-	delete [] m_ppSyncItems;
-}
-
 // Run state accessor.
 void qtractorLv2WorkerThread::setRunState ( bool bRunState )
 {
@@ -350,25 +535,13 @@ bool qtractorLv2WorkerThread::runState (void) const
 	return m_bRunState;
 }
 
-// Wake from executive wait condition.
+// Wake from executive wait condition (never blocks:
+// pending work is flagged on the worker itself, so
+// a missed wakeup is caught on the thread next pass).
 void qtractorLv2WorkerThread::sync ( qtractorLv2Worker *pLv2Worker )
 {
-	if (pLv2Worker) {
-		unsigned int n;
-		unsigned int r = m_iSyncRead;
-		unsigned int w = m_iSyncWrite;
-		if (w > r) {
-			n = ((r - w + m_iSyncSize) & m_iSyncMask) - 1;
-		} else if (r > w) {
-			n = (r - w) - 1;
-		} else {
-			n = m_iSyncSize - 1;
-		}
-		if (n > 0) {
-			m_ppSyncItems[w] = pLv2Worker;
-			m_iSyncWrite = (w + 1) & m_iSyncMask;
-		}
-	}
+	if (pLv2Worker)
+		pLv2Worker->setPending();
 
 	if (m_mutex.tryLock()) {
 		m_cond.wakeAll();
@@ -391,17 +564,21 @@ void qtractorLv2WorkerThread::run (void)
 	m_bRunState = true;
 
 	while (m_bRunState) {
-		// Do whatever we must, then wait for more...
-		unsigned int r = m_iSyncRead;
-		unsigned int w = m_iSyncWrite;
-		while (r != w) {
-			m_ppSyncItems[r]->process();
-			++r &= m_iSyncMask;
-			w = m_iSyncWrite;
+		// Do whatever we must, until nothing is pending...
+		bool bPending = true;
+		while (bPending) {
+			bPending = false;
+			QListIterator<qtractorLv2Worker *> iter(m_workers);
+			while (iter.hasNext()) {
+				qtractorLv2Worker *pLv2Worker = iter.next();
+				if (pLv2Worker->takePending()) {
+					pLv2Worker->process();
+					bPending = true;
+				}
+			}
 		}
-		m_iSyncRead = r;
-		// Wait for sync...
-		m_cond.wait(&m_mutex);
+		// Wait for sync (bounded, in case one was missed)...
+		m_cond.wait(&m_mutex, 100);
 	}
 
 	m_mutex.unlock();
@@ -411,11 +588,30 @@ void qtractorLv2WorkerThread::run (void)
 #endif
 }
 
+// Assign a worker to this thread.
+void qtractorLv2WorkerThread::attach ( qtractorLv2Worker *pLv2Worker )
+{
+	QMutexLocker locker(&m_mutex);
+
+	m_workers.append(pLv2Worker);
+}
+
+// Unassign a worker from this thread (waits for any
+// current processing to finish); returns remaining count.
+int qtractorLv2WorkerThread::detach ( qtractorLv2Worker *pLv2Worker )
+{
+	QMutexLocker locker(&m_mutex);
+
+	m_workers.removeAll(pLv2Worker);
+
+	return m_workers.count();
+}
+
 //----------------------------------------------------------------------
 // class qtractorLv2Worker -- LV2 Worker/Schedule item impl.
 //
-qtractorLv2WorkerThread *qtractorLv2Worker::g_pWorkerThread   = NULL;
-unsigned int             qtractorLv2Worker::g_iWorkerRefCount = 0;
+QList<qtractorLv2WorkerThread *> qtractorLv2Worker::g_workerThreads;
+unsigned int qtractorLv2Worker::g_iWorkerThreads = 0;
 
 // Constructor.
 qtractorLv2Worker::qtractorLv2Worker (
@@ -443,25 +639,57 @@ qtractorLv2Worker::qtractorLv2Worker (
 	m_pResponses = ::jack_ringbuffer_create(4096);
 	m_pResponse  = (void *) ::malloc(4096);
 
-	if (++g_iWorkerRefCount == 1) {
-		g_pWorkerThread = new qtractorLv2WorkerThread();
-		g_pWorkerThread->start();
+	ATOMIC_SET(&m_pending, 0);
+
+	m_iWorkTime   = 0;
+
+	m_iStatsCount = 0;
+	m_iStatsTotal = 0;
+	m_iStatsMax   = 0;
+	m_iStatsDrops = 0;
+
+	// Get a dedicated worker thread, while allowed;
+	// otherwise share the least loaded one...
+	m_pWorkerThread = NULL;
+	if (g_iWorkerThreads > 0
+		&& g_workerThreads.count() >= int(g_iWorkerThreads)) {
+		QListIterator<qtractorLv2WorkerThread *> iter(g_workerThreads);
+		while (iter.hasNext()) {
+			qtractorLv2WorkerThread *pWorkerThread = iter.next();
+			if (m_pWorkerThread == NULL
+				|| m_pWorkerThread->refCount() > pWorkerThread->refCount())
+				m_pWorkerThread = pWorkerThread;
+		}
 	}
+	if (m_pWorkerThread == NULL) {
+		m_pWorkerThread = new qtractorLv2WorkerThread();
+		m_pWorkerThread->start();
+		g_workerThreads.append(m_pWorkerThread);
+	}
+	m_pWorkerThread->attach(this);
 }
 
 // Destructor.
 qtractorLv2Worker::~qtractorLv2Worker (void)
 {
-	if (--g_iWorkerRefCount == 0) {
-		if (g_pWorkerThread->isRunning()) do {
-			g_pWorkerThread->setRunState(false);
-		//	g_pWorkerThread->terminate();
-			g_pWorkerThread->sync();
-		} while (!g_pWorkerThread->wait(100));
-		delete g_pWorkerThread;
-		g_pWorkerThread = NULL;
+#ifdef CONFIG_DEBUG
+	qDebug("qtractorLv2Worker[%p]::~qtractorLv2Worker(): "
+		"count=%lu avg=%luus max=%luus drops=%lu", this,
+		statsCount(), statsAvgTime(), statsMaxTime(), statsDrops());
+#endif
+
+	if (m_pWorkerThread->detach(this) == 0) {
+		g_workerThreads.removeAll(m_pWorkerThread);
+		if (m_pWorkerThread->isRunning()) do {
+			m_pWorkerThread->setRunState(false);
+		//	m_pWorkerThread->terminate();
+			m_pWorkerThread->sync();
+		} while (!m_pWorkerThread->wait(100));
+		delete m_pWorkerThread;
 	}
 
+	m_pWorkerThread = NULL;
+
 	::jack_ringbuffer_free(m_pRequests);
 	::jack_ringbuffer_free(m_pResponses);
 	::free(m_pResponse);
@@ -470,34 +698,56 @@ qtractorLv2Worker::~qtractorLv2Worker (void)
 }
 
 // Schedule work.
-void qtractorLv2Worker::schedule ( uint32_t size, const void *data )
+bool qtractorLv2Worker::schedule ( uint32_t size, const void *data )
 {
-	const uint32_t request_size = size + sizeof(size);
+	const jack_time_t time = ::jack_get_time();
+	const uint32_t request_size = size + sizeof(size) + sizeof(time);
 
-	if (::jack_ringbuffer_write_space(m_pRequests) >= request_size) {
+	// Backpressure: tell the plugin the queue is full...
+	const bool bResult
+		= (::jack_ringbuffer_write_space(m_pRequests) >= request_size);
+	if (bResult) {
 		char request_data[request_size];
 		::memcpy(request_data, &size, sizeof(size));
-		::memcpy(request_data + sizeof(size), data, size);
+		::memcpy(request_data + sizeof(size), &time, sizeof(time));
+		::memcpy(request_data + sizeof(size) + sizeof(time), data, size);
 		::jack_ringbuffer_write(m_pRequests,
 			(const char *) &request_data, request_size);
+	} else {
+		++m_iStatsDrops;
 	}
 
-	if (g_pWorkerThread)
-		g_pWorkerThread->sync(this);
+	m_pWorkerThread->sync(this);
+
+	return bResult;
 }
 
 // Response work.
-void qtractorLv2Worker::respond ( uint32_t size, const void *data )
+bool qtractorLv2Worker::respond ( uint32_t size, const void *data )
 {
+	// Schedule/respond round-trip stats...
+	if (m_iWorkTime > 0) {
+		const unsigned long iTime
+			= (unsigned long) (::jack_get_time() - m_iWorkTime);
+		m_iStatsTotal += iTime;
+		if (m_iStatsMax < iTime)
+			m_iStatsMax = iTime;
+		++m_iStatsCount;
+	}
+
 	const uint32_t response_size = size + sizeof(size);
 
-	if (::jack_ringbuffer_write_space(m_pResponses) >= response_size) {
+	const bool bResult
+		= (::jack_ringbuffer_write_space(m_pResponses) >= response_size);
+	if (bResult) {
 		char response_data[response_size];
 		::memcpy(response_data, &size, sizeof(size));
 		::memcpy(response_data + sizeof(size), data, size);
 		::jack_ringbuffer_write(m_pResponses,
 			(const char *) &response_data, response_size);
 	}
+
+	return bResult;
 }
 
 // Commit work.
@@ -555,6 +805,8 @@ void qtractorLv2Worker::process (void)
 
 	while (read_space > 0) {
 		::jack_ringbuffer_read(m_pRequests, (char *) &size, sizeof(size));
+		::jack_ringbuffer_read(m_pRequests,
+			(char *) &m_iWorkTime, sizeof(m_iWorkTime));
 		::jack_ringbuffer_read(m_pRequests, (char *) buf, size);
 		if (worker->work) {
 			for (i = 0; i < iInstances; ++i) {
@@ -564,12 +816,26 @@ void qtractorLv2Worker::process (void)
 						qtractor_lv2_worker_respond, this, size, buf);
 			}
 		}
-		read_space -= sizeof(size) + size;
+		read_space -= sizeof(size) + sizeof(m_iWorkTime) + size;
 	}
 
+	m_iWorkTime = 0;
+
 	if (buf) ::free(buf);
 }
 
+
+// Worker thread pool concurrency (0=one thread per plugin).
+void qtractorLv2Worker::setWorkerThreads ( unsigned int iWorkerThreads )
+{
+	g_iWorkerThreads = iWorkerThreads;
+}
+
+unsigned int qtractorLv2Worker::workerThreads (void)
+{
+	return g_iWorkerThreads;
+}
+
 #endif	// CONFIG_LV2_WORKER
 
 
@@ -1786,6 +2052,17 @@ void qtractorLv2PluginType::lv2_open (void)
 		= qtractorLv2Plugin::lv2_urid_map(LV2_ATOM__String);
 	g_lv2_urids.atom_Path
 		= qtractorLv2Plugin::lv2_urid_map(LV2_ATOM__Path);
+	// Pre-intern other common atom types, as plugins
+	// may well map these first thing in run()...
+	static const char *s_atom_uris[] = {
+		LV2_ATOM__URID, LV2_ATOM__URI, LV2_ATOM__Tuple,
+		LV2_ATOM__Vector, LV2_ATOM__Property, LV2_ATOM__Resource,
+		LV2_ATOM__Literal, LV2_ATOM__Number, LV2_ATOM__Sound,
+		LV2_ATOM__frameTime, LV2_ATOM__beatTime, LV2_ATOM__atomTransfer,
+		NULL
+	};
+	for (int i = 0; s_atom_uris[i]; ++i)
+		qtractorLv2Plugin::lv2_urid_map(s_atom_uris[i]);
 #endif
 #ifdef CONFIG_LV2_PATCH
 	g_lv2_urids.patch_Get
@@ -2027,6 +2304,19 @@ QStringList qtractorLv2PluginType::lv2_plugins (void)
 }
 
 
+// Plugin bundle directory path (static).
+QString qtractorLv2PluginType::lv2_bundle_path ( const QString& sUri )
+{
+	const LilvPlugin *plugin = lv2_plugin(sUri);
+	if (plugin == NULL)
+		return QString();
+
+	const char *pszBundleUri
+		= lilv_node_as_uri(lilv_plugin_get_bundle_uri(plugin));
+	return QUrl(QString::fromLocal8Bit(pszBundleUri)).toLocalFile();
+}
+
+
 #ifdef CONFIG_LV2_UI_SHOW
 
 // Check for LV2 UI Show interface.
@@ -2132,6 +2422,7 @@ qtractorLv2Plugin::qtractorLv2Plugin ( qtractorPluginList *pList,
 		, m_lv2_features(NULL)
 	#ifdef CONFIG_LV2_WORKER
 		, m_lv2_worker(NULL)
+		, m_lv2_worker_drops(0)
 	#endif
 	#ifdef CONFIG_LV2_UI
 		, m_lv2_ui_type(LV2_UI_TYPE_NONE)
@@ -2662,8 +2953,11 @@ void qtractorLv2Plugin::setChannels ( unsigned short iChannels )
 
 #ifdef CONFIG_LV2_WORKER
 	if (m_lv2_worker) {
+		// Report any worker requests dropped lately...
+		lv2_worker_report();
 		delete m_lv2_worker;
 		m_lv2_worker = NULL;
+		m_lv2_worker_drops = 0;
 	}
 #endif
 	if (m_ppInstances) {
@@ -4457,6 +4751,68 @@ const LV2_Worker_Interface *qtractorLv2Plugin::lv2_worker_interface (
 		(*descriptor->extension_data)(LV2_WORKER__interface);
 }
 
+
+// LV2 Worker/Schedule round-trip stats (microseconds).
+bool qtractorLv2Plugin::lv2_worker_stats ( unsigned long& iCount,
+	unsigned long& iAvgTime, unsigned long& iMaxTime,
+	unsigned long& iDrops ) const
+{
+	if (m_lv2_worker == NULL)
+		return false;
+
+	iCount   = m_lv2_worker->statsCount();
+	iAvgTime = m_lv2_worker->statsAvgTime();
+	iMaxTime = m_lv2_worker->statsMaxTime();
+	iDrops   = m_lv2_worker->statsDrops();
+
+	return true;
+}
+
+
+// LV2 Worker/Schedule overrun (dropped requests) report.
+void qtractorLv2Plugin::lv2_worker_report (void)
+{
+	unsigned long iCount, iAvgTime, iMaxTime, iDrops;
+	if (!lv2_worker_stats(iCount, iAvgTime, iMaxTime, iDrops)
+		|| iDrops <= m_lv2_worker_drops)
+		return;
+
+	qtractorMainForm *pMainForm = qtractorMainForm::getInstance();
+	if (pMainForm) {
+		pMainForm->appendMessagesColor(
+			QObject::tr("LV2 Worker overrun on plugin \"%1\": "
+				"%2 requests dropped (%3 done, %4 us avg., %5 us max.).")
+				.arg(type()->name())
+				.arg(iDrops - m_lv2_worker_drops)
+				.arg(iCount)
+				.arg(iAvgTime)
+				.arg(iMaxTime), "#cc0033");
+	}
+
+	m_lv2_worker_drops = iDrops;
+}
+
+
+// Report any new worker overruns, all plugins (static).
+void qtractorLv2Plugin::idleWorkerAll (void)
+{
+	QListIterator<qtractorLv2Plugin *> iter(g_lv2Plugins);
+	while (iter.hasNext())
+		iter.next()->lv2_worker_report();
+}
+
+
+// LV2 Worker/Schedule thread pool concurrency (0=one per plugin).
+void qtractorLv2Plugin::setWorkerThreads ( unsigned int iWorkerThreads )
+{
+	qtractorLv2Worker::setWorkerThreads(iWorkerThreads);
+}
+
+unsigned int qtractorLv2Plugin::workerThreads (void)
+{
+	return qtractorLv2Worker::workerThreads();
+}
+
 #endif	// CONFIG_LV2_WORKER
 
 
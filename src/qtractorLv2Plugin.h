@@ -148,6 +148,9 @@ public:
 	// Plugin type (URI) listing (static).
 	static QStringList lv2_plugins();
 
+	// Plugin bundle directory path (static).
+	static QString lv2_bundle_path(const QString& sUri);
+
 #ifdef CONFIG_LV2_EVENT
 	unsigned short eventIns()   const { return m_iEventIns;   }
 	unsigned short eventOuts()  const { return m_iEventOuts;  }
@@ -283,6 +286,20 @@ public:
 #ifdef CONFIG_LV2_WORKER
 	// LV2 Worker/Schedule extension data interface accessor.
 	const LV2_Worker_Interface *lv2_worker_interface(unsigned short iInstance) const;
+
+	// LV2 Worker/Schedule round-trip stats (microseconds).
+	bool lv2_worker_stats(unsigned long& iCount, unsigned long& iAvgTime,
+		unsigned long& iMaxTime, unsigned long& iDrops) const;
+
+	// LV2 Worker/Schedule thread pool concurrency (0=one per plugin).
+	static void setWorkerThreads(unsigned int iWorkerThreads);
+	static unsigned int workerThreads();
+
+	// LV2 Worker/Schedule overrun (dropped requests) report.
+	void lv2_worker_report();
+
+	// Report any new worker overruns, all plugins (static).
+	static void idleWorkerAll();
 #endif
 
 #ifdef CONFIG_LV2_STATE
@@ -481,6 +498,9 @@ private:
 #ifdef CONFIG_LV2_WORKER
 	// LV2 Worker/Schedule support.
 	qtractorLv2Worker *m_lv2_worker;
+
+	// Worker dropped requests reported so far.
+	unsigned long m_lv2_worker_drops;
 #endif
 
 #ifdef CONFIG_LV2_UI
@@ -40,8 +40,10 @@
 
 #include "qtractorAudioPeak.h"
 #include "qtractorAudioBuffer.h"
+#include "qtractorAudioStretchCache.h"
 #include "qtractorAudioEngine.h"
 #include "qtractorMidiEngine.h"
+#include "qtractorEpoch.h"
 
 #include "qtractorSessionDocument.h"
 #include "qtractorSessionCursor.h"
@@ -1297,6 +1299,12 @@ qtractorMainForm::~qtractorMainForm (void)
 	if (m_pSession)
 		delete m_pSession;
 
+	// Stop pre-rendering time-stretch cache, explicitly.
+	qtractorAudioStretchCache::getInstance()->clear();
+
+	// Reclaim all retired realtime shared data.
+	qtractorEpoch::clear();
+
 	// Pseudo-singleton reference shut-down.
 	g_pMainForm = NULL;
 }
@@ -1523,6 +1531,45 @@ void qtractorMainForm::setup ( qtractorOptions *pOptions )
 		m_pOptions->bAudioWsolaTimeStretch);
 	qtractorAudioBuffer::setDefaultWsolaQuickSeek(
 		m_pOptions->bAudioWsolaQuickSeek);
+	qtractorAudioBuffer::setDefaultWsolaFastSeek(
+		m_pOptions->bAudioWsolaFastSeek);
+	// Set shared decoded audio page cache limit...
+	if (m_pOptions->iAudioPageCache >= 0) {
+		qtractorAudioPageCache::getInstance()->setMaxSize(
+			(unsigned long) m_pOptions->iAudioPageCache << 20);
+	}
+	// Set pre-rendered time-stretch cache mode...
+	qtractorAudioStretchCache::getInstance()->setEnabled(
+		m_pOptions->bAudioStretchCache);
+	if (m_pOptions->iAudioStretchCacheSize >= 0) {
+		qtractorAudioStretchCache::getInstance()->setMaxSize(
+			qint64(m_pOptions->iAudioStretchCacheSize) << 20);
+	}
+	qtractorCurveList::setSubBlockSize(
+		m_pOptions->iAudioAutomationBlock);
+	// Set audio track buffer threads (shared pool)...
+	if (m_pOptions->iAudioSyncThreads > 0) {
+		qtractorAudioBufferThread::setDefaultSyncThreads(
+			m_pOptions->iAudioSyncThreads);
+	}
+	// Set undo history memory budget...
+	if (m_pOptions->iUndoMemoryLimit >= 0) {
+		// Clamp to what fits in (32bit) unsigned long bytes...
+		const unsigned long iMaxMemoryLimit = (~0UL >> 20);
+		unsigned long iMemoryLimit = m_pOptions->iUndoMemoryLimit;
+		if (iMemoryLimit > iMaxMemoryLimit)
+			iMemoryLimit = iMaxMemoryLimit;
+		iMemoryLimit <<= 20;
+		qtractorCommandList::setDefaultMemoryLimit(iMemoryLimit);
+		(m_pSession->commands())->setMemoryLimit(iMemoryLimit);
+	}
+#ifdef CONFIG_LV2_WORKER
+	// Set LV2 worker thread pool concurrency...
+	if (m_pOptions->iLv2WorkerThreads >= 0) {
+		qtractorLv2Plugin::setWorkerThreads(
+			m_pOptions->iLv2WorkerThreads);
+	}
+#endif
 
 	// Load (action) keyboard shortcuts...
 	m_pOptions->loadActionShortcuts(this);
@@ -1533,8 +1580,11 @@ void qtractorMainForm::setup ( qtractorOptions *pOptions )
 
 	// Some special defaults...
 	qtractorAudioEngine *pAudioEngine = m_pSession->audioEngine();
-	if (pAudioEngine)
+	if (pAudioEngine) {
 		pAudioEngine->setMasterAutoConnect(m_pOptions->bAudioMasterAutoConnect);
+		if (m_pOptions->iAudioWorkers > 0)
+			pAudioEngine->setWorkers(m_pOptions->iAudioWorkers);
+	}
 	
 	// Final widget slot connections....
 	QObject::connect(m_pFileSystem->toggleViewAction(),
@@ -7544,6 +7594,10 @@ void qtractorMainForm::fastTimerSlot (void)
 	// Update plugin LV2 Time designated ports, if any...
 	qtractorLv2Plugin::updateTimePost();
 #endif
+#ifdef CONFIG_LV2_WORKER
+	// Report plugin LV2 Worker overruns, if any...
+	qtractorLv2Plugin::idleWorkerAll();
+#endif
 #ifdef CONFIG_LV2_UI
 	// Crispy plugin LV2 UI idle-updates...
 	qtractorLv2Plugin::idleEditorAll();
@@ -7620,6 +7674,7 @@ void qtractorMainForm::slowTimerSlot (void)
 					unsigned short i = pos.beat_type;
 					while (i > 1) {	++(pNode->beatDivisor); i >>= 1; }
 					pTimeScale->updateNode(pNode);
+					pTimeScale->updateScale();
 					m_pTempoSpinBox->setTempo(pNode->tempo, false);
 					m_pTempoSpinBox->setBeatsPerBar(pNode->beatsPerBar, false);
 					m_pTempoSpinBox->setBeatDivisor(pNode->beatDivisor, false);
@@ -7705,6 +7760,16 @@ void qtractorMainForm::slowTimerSlot (void)
 	if (m_iAudioPeakTimer > 0 && --m_iAudioPeakTimer < 1) {
 		m_iAudioPeakTimer = 0;
 		m_pTracks->trackView()->updateContents();
+		// Still some peak files on the way?
+		qtractorAudioPeakFactory *pPeakFactory
+			= m_pSession->audioPeakFactory();
+		const unsigned int iPeakPending
+			= (pPeakFactory ? pPeakFactory->peakPending() : 0);
+		if (iPeakPending > 0) {
+			statusBar()->showMessage(
+				tr("Building audio peak files (%1 to go)...")
+					.arg(iPeakPending), 3000);
+		}
 	}
 
 	// Check if its time to refresh Audio connections...
@@ -7772,6 +7837,9 @@ void qtractorMainForm::slowTimerSlot (void)
 		}
 	}
 
+	// Reclaim retired realtime shared data, if any...
+	qtractorEpoch::collect();
+
 	// Register the next slow-timer slot.
 	QTimer::singleShot(QTRACTOR_TIMER_DELAY, this, SLOT(slowTimerSlot()));
 }
@@ -8303,6 +8371,7 @@ void qtractorMainForm::midiClkNotify ( float fTempo )
 	if (pNode->prev()) {
 		pNode->tempo = fTempo;
 		pTimeScale->updateNode(pNode);
+		pTimeScale->updateScale();
 	} else {
 		m_pSession->setTempo(fTempo);
 	}
@@ -47,6 +47,10 @@
 #include <QDomDocument>
 
 
+// Maximum number of chased state events on locate.
+static const unsigned int c_iMaxChaseEvents = 256;
+
+
 #if QT_VERSION < 0x040500
 namespace Qt {
 const WindowFlags WindowCloseButtonHint = WindowFlags(0x08000000);
@@ -182,6 +186,9 @@ qtractorMidiClip::qtractorMidiClip ( qtractorTrack *pTrack )
 	m_iRevision = 0;
 
 	m_pMidiEditorForm = NULL;
+
+	m_iChaseTime = 0;
+	m_bChase = false;
 }
 
 // Copy constructor.
@@ -203,6 +210,9 @@ qtractorMidiClip::qtractorMidiClip ( const qtractorMidiClip& clip )
 	m_iRevision = clip.revision();
 
 	m_pMidiEditorForm = NULL;
+
+	m_iChaseTime = 0;
+	m_bChase = false;
 }
 
 
@@ -813,6 +823,11 @@ void qtractorMidiClip::seek ( unsigned long iFrame )
 
 	// Seek for the nearest sequence event...
 	m_playCursor.seek(pSeq, (t1 > t0 ? t1 - t0 : 0));
+
+	// Chase the prevailing state on next cycle
+	// (only on real locates, never on loop-wraps)...
+	m_iChaseTime = (t1 > t0 ? t1 - t0 : 0);
+	m_bChase = (m_iChaseTime > 0);
 }
 
 
@@ -825,6 +840,8 @@ void qtractorMidiClip::reset ( bool /* bLooping */ )
 
 	// Reset to the first sequence event...
 	m_playCursor.reset(pSeq);
+
+	m_bChase = false;
 }
 
 
@@ -940,6 +957,17 @@ void qtractorMidiClip::process (
 
 	// Enqueue the requested events...
 	const float fGain = clipGain();
+
+	// Chased state goes first, once after locate...
+	if (m_bChase) {
+		m_bChase = false;
+		qtractorMidiEvent *apChase[c_iMaxChaseEvents];
+		const unsigned int iChase
+			= pSeq->chaseEvents(m_iChaseTime, apChase, c_iMaxChaseEvents);
+		for (unsigned int i = 0; i < iChase; ++i)
+			pMidiEngine->enqueue(pTrack, apChase[i], iTimeStart, fGain);
+	}
+
 	qtractorMidiEvent *pEvent
 		= m_playCursor.seek(pSeq, iTimeStart > t0 ? iTimeStart - t0 : 0);
 	while (pEvent) {
@@ -982,6 +1010,17 @@ void qtractorMidiClip::process_export (
 
 	// Enqueue the requested events...
 	const float fGain = clipGain();
+
+	// Chased state goes first, once after locate...
+	if (m_bChase) {
+		m_bChase = false;
+		qtractorMidiEvent *apChase[c_iMaxChaseEvents];
+		const unsigned int iChase
+			= pSeq->chaseEvents(m_iChaseTime, apChase, c_iMaxChaseEvents);
+		for (unsigned int i = 0; i < iChase; ++i)
+			enqueue_export(pTrack, apChase[i], iTimeStart, fGain);
+	}
+
 	qtractorMidiEvent *pEvent
 		= m_playCursor.seek(pSeq, iTimeStart > t0 ? iTimeStart - t0 : 0);
 	while (pEvent) {
@@ -289,6 +289,10 @@ private:
 	qtractorMidiCursor m_playCursor;
 	qtractorMidiCursor m_drawCursor;
 
+	// Pending chase (controller, program...) state on locate.
+	unsigned long m_iChaseTime;
+	volatile bool m_bChase;
+
 	// This clip editor form widget.
 	qtractorMidiEditorForm *m_pMidiEditorForm;
 
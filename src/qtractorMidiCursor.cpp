@@ -23,6 +23,10 @@
 #include "qtractorMidiSequence.h"
 
 
+// Maximum linear steps before falling back to binary search.
+static const unsigned int c_iSeekSteps = 8;
+
+
 //-------------------------------------------------------------------------
 // qtractorMidiCursor -- MIDI event cursor capsule.
 
@@ -42,6 +46,22 @@ qtractorMidiEvent *qtractorMidiCursor::seek (
 		m_pEvent = pSeq->events().first();
 	}
 	else
+	if (pSeq->isIndexed()) {
+		// Seek forward a few steps, as usual...
+		unsigned int iSteps = 0;
+		if (iTime > m_iTime && m_pEvent) {
+			while (iSteps < c_iSeekSteps && m_pEvent->next()
+				&& (m_pEvent->next())->time() < iTime) {
+				m_pEvent = m_pEvent->next();
+				++iSteps;
+			}
+		}
+		// Otherwise binary search...
+		if (iTime != m_iTime && (m_pEvent == NULL
+			|| iTime < m_iTime || iSteps >= c_iSeekSteps))
+			m_pEvent = pSeq->seekEvent(iTime);
+	}
+	else
 	if (iTime > m_iTime) {
 		// Seek forward...
 		if (m_pEvent == NULL)
@@ -73,12 +93,16 @@ qtractorMidiEvent *qtractorMidiCursor::reset (
 	qtractorMidiSequence *pSeq, unsigned long iTime )
 {
 	// Reset-seek forward...
-	if (m_iTime >= iTime)
-		m_pEvent = NULL;
-	if (m_pEvent == NULL)
-		m_pEvent = pSeq->events().first();
-	while (m_pEvent && m_pEvent->time() + m_pEvent->duration() < iTime)
-		m_pEvent = m_pEvent->next();
+	if (pSeq->isIndexed()) {
+		m_pEvent = pSeq->resetEvent(iTime);
+	} else {
+		if (m_iTime >= iTime)
+			m_pEvent = NULL;
+		if (m_pEvent == NULL)
+			m_pEvent = pSeq->events().first();
+		while (m_pEvent && m_pEvent->time() + m_pEvent->duration() < iTime)
+			m_pEvent = m_pEvent->next();
+	}
 	while (m_pEvent && m_pEvent->time() > iTime)
 		m_pEvent = m_pEvent->prev();
 	if (m_pEvent == NULL)
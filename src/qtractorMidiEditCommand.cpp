@@ -220,6 +220,9 @@ bool qtractorMidiEditCommand::execute ( bool bRedo )
 		}
 	}
 
+	// Rebuild the time-sorted event index...
+	pSeq->updateIndex();
+
 	// Just reset/update editor internals...
 	m_pMidiClip->updateEditorEx(iSelectClear > 0);
 
@@ -388,4 +391,25 @@ bool qtractorMidiEditCommand::undo (void)
 }
 
 
+// Approximate memory footprint (undo history accounting).
+unsigned long qtractorMidiEditCommand::memorySize (void) const
+{
+	unsigned long iMemorySize = qtractorCommand::memorySize()
+		+ m_items.count() * (sizeof(Item) + sizeof(Item *));
+
+	// Removed events are owned here...
+	QListIterator<Item *> iter(m_items);
+	while (iter.hasNext()) {
+		Item *pItem = iter.next();
+		if (pItem->autoDelete && pItem->event) {
+			iMemorySize += sizeof(qtractorMidiEvent);
+			if (pItem->event->type() == qtractorMidiEvent::SYSEX)
+				iMemorySize += pItem->event->sysex_len();
+		}
+	}
+
+	return iMemorySize;
+}
+
+
 // end of qtractorMidiEditCommand.cpp
@@ -75,6 +75,9 @@ public:
 	bool redo();
 	bool undo();
 
+	// Approximate memory footprint (undo history accounting).
+	unsigned long memorySize() const;
+
 	// Adjust edit-command result to prevent event overlapping.
 	bool adjust();
 
@@ -427,12 +427,15 @@ void qtractorMidiEditEvent::updatePixmap ( int cx, int /*cy*/ )
 		|| m_eventType == qtractorMidiEvent::REGPARAM
 		|| m_eventType == qtractorMidiEvent::NONREGPARAM
 		|| m_eventType == qtractorMidiEvent::CONTROL14);
-	qtractorMidiEvent *pEvent
-		= m_pEditor->seekEvent(iTickStart > t0 ? iTickStart - t0 : 0);
-	while (pEvent) {
+	// Visible events only (interval look-up)...
+	QList<qtractorMidiEvent *> events;
+	pSeq->findEvents(
+		iTickStart > t0 ? iTickStart - t0 : 0,
+		iTickEnd > t0 ? iTickEnd - t0 : 0, events);
+	QListIterator<qtractorMidiEvent *> iter(events);
+	while (iter.hasNext()) {
+		qtractorMidiEvent *pEvent = iter.next();
 		const unsigned long t1 = t0 + pEvent->time();
-		if (t1 >= iTickEnd)
-			break;
 		unsigned long t2 = t1 + pEvent->duration();
 		if (t2 > iTimeEnd)
 			t2 = iTimeEnd;
@@ -479,7 +482,6 @@ void qtractorMidiEditEvent::updatePixmap ( int cx, int /*cy*/ )
 				painter.fillRect(x + 1, y0 - 1, w1 - 4, 2, rgbValue);
 			}
 		}
-		pEvent = pEvent->next();
 	}
 
 	// Draw loop boundaries, if applicable...
@@ -411,12 +411,15 @@ void qtractorMidiEditView::updatePixmap ( int cx, int cy )
 	int hue, sat, val;
 	rgbNote.getHsv(&hue, &sat, &val); sat = 86;
 
-	qtractorMidiEvent *pEvent
-		= m_pEditor->seekEvent(iTickStart > t0 ? iTickStart - t0 : 0);
-	while (pEvent) {
+	// Visible events only (interval look-up)...
+	QList<qtractorMidiEvent *> events;
+	pSeq->findEvents(
+		iTickStart > t0 ? iTickStart - t0 : 0,
+		iTickEnd > t0 ? iTickEnd - t0 : 0, events);
+	QListIterator<qtractorMidiEvent *> iter(events);
+	while (iter.hasNext()) {
+		qtractorMidiEvent *pEvent = iter.next();
 		const unsigned long t1 = t0 + pEvent->time();
-		if (t1 >= iTickEnd)
-			break;
 		unsigned long t2 = t1 + pEvent->duration();
 		if (t2 > iTimeEnd)
 			t2 = iTimeEnd;
@@ -454,7 +457,6 @@ void qtractorMidiEditView::updatePixmap ( int cx, int cy )
 				}
 			}
 		}
-		pEvent = pEvent->next();
 	}
 
 	// Draw loop boundaries, if applicable...
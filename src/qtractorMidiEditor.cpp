@@ -898,7 +898,6 @@ void qtractorMidiEditor::setMidiClip ( qtractorMidiClip *pMidiClip )
 		if (pSeq) {
 			// Reset some internal state...
 			m_cursor.reset(pSeq);
-			m_cursorAt.reset(pSeq);
 			// Reset as last on middle note and snap duration...
 			m_last.note = (pSeq->noteMin() + pSeq->noteMax()) >> 1;
 			if (m_last.note == 0)
@@ -2452,7 +2451,6 @@ void qtractorMidiEditor::reset ( bool bSelectClear )
 		qtractorMidiSequence *pSeq = m_pMidiClip->sequence();
 		if (pSeq) {
 			m_cursor.reset(pSeq);
-			m_cursorAt.reset(pSeq);
 		}
 	}
 }
@@ -2521,9 +2519,20 @@ qtractorMidiEvent *qtractorMidiEditor::eventAt (
 		|| eventType == qtractorMidiEvent::CONTROL14);
 	const unsigned short eventParam = m_pEditEvent->eventParam();
 
-	qtractorMidiEvent *pEvent = m_cursorAt.reset(pSeq, iTime);
+	// Minimum width items just before might be hit as well...
+	const int x1 = x0 + pos.x() - (h4 > 8 ? h4 : 8);
+	pNode = cursor.seekPixel(x1 > 0 ? x1 : 0);
+	unsigned long iTimeStart = pNode->tickFromPixel(x1 > 0 ? x1 : 0);
+	iTimeStart = (iTimeStart > t0 ? iTimeStart - t0 : 0);
+
+	// Candidate events only (interval look-up)...
+	QList<qtractorMidiEvent *> events;
+	pSeq->findEvents(iTimeStart, iTime + 1, events);
+
 	qtractorMidiEvent *pEventAt = NULL;
-	while (pEvent && iTime >= pEvent->time()) {
+	QListIterator<qtractorMidiEvent *> iter(events);
+	while (iter.hasNext()) {
+		qtractorMidiEvent *pEvent = iter.next();
 		if (((bEditView && pEvent->type() == m_pEditView->eventType()) ||
 			 (!bEditView && (pEvent->type() == m_pEditEvent->eventType() &&
 				(!bEventParam || pEvent->param() == eventParam))))) {
@@ -2576,8 +2585,6 @@ qtractorMidiEvent *qtractorMidiEditor::eventAt (
 					break;
 			}
 		}
-		// Maybe next one...
-		pEvent = pEvent->next();
 	}
 
 	return pEventAt;
@@ -3298,10 +3305,6 @@ void qtractorMidiEditor::updateDragSelect (
 	if (--x1 < 0) x1 = 0;
 	++x2;
 
-	pNode = cursor.seekPixel(x0 + x1);
-	unsigned long t1 = pNode->tickFromPixel(x0 + x1);
-	const unsigned long iTickStart = (t1 > t0 ? t1 - t0 : 0);
-
 	pNode = cursor.seekPixel(x0 + x2);
 	unsigned long t2 = pNode->tickFromPixel(x0 + x2);
 	const unsigned long iTickEnd = (t2 > t0 ? t2 - t0 : 0);
@@ -3324,13 +3327,22 @@ void qtractorMidiEditor::updateDragSelect (
 		|| eventType == qtractorMidiEvent::CONTROL14);
 	const unsigned short eventParam = m_pEditEvent->eventParam();
 
-	qtractorMidiEvent *pEvent = m_cursorAt.seek(pSeq, iTickStart);
+	// Minimum width items just before might be hit as well...
+	x1 -= (h4 > 8 ? h4 : 8);
+	pNode = cursor.seekPixel(x0 + (x1 > 0 ? x1 : 0));
+	unsigned long t1 = pNode->tickFromPixel(x0 + (x1 > 0 ? x1 : 0));
+
+	// Candidate events only (interval look-up)...
+	QList<qtractorMidiEvent *> events;
+	pSeq->findEvents(t1 > t0 ? t1 - t0 : 0, iTickEnd + 1, events);
 
 	qtractorMidiEvent *pEventAt = NULL;
 	QRect rectViewAt;
 	QRect rectEventAt;
 
-	while (pEvent && iTickEnd >= pEvent->time()) {
+	QListIterator<qtractorMidiEvent *> iter(events);
+	while (iter.hasNext()) {
+		qtractorMidiEvent *pEvent = iter.next();
 		if (((bEditView && pEvent->type() == m_pEditView->eventType()) ||
 			 (!bEditView && (pEvent->type() == m_pEditEvent->eventType() &&
 				(!bEventParam || pEvent->param() == eventParam))))) {
@@ -3391,8 +3403,6 @@ void qtractorMidiEditor::updateDragSelect (
 				rectEventAt = rectEvent;
 			}
 		}
-		// Lookup next...
-		pEvent = pEvent->next();
 	}
 
 	// Most evident single selection...
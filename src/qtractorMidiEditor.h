@@ -568,9 +568,8 @@ private:
 	unsigned long m_iOffset;
 	unsigned long m_iLength;
 
-	// Event cursors (main time-line).
+	// Event cursor (main time-line).
 	qtractorMidiCursor m_cursor;
-	qtractorMidiCursor m_cursorAt;
 
 	// The current selection list.
 	qtractorMidiEditSelect m_select;
@@ -34,6 +34,7 @@
 #include "qtractorMidiSequence.h"
 #include "qtractorMidiClip.h"
 #include "qtractorMidiManager.h"
+#include "qtractorEpoch.h"
 #include "qtractorMidiControl.h"
 #include "qtractorMidiTimer.h"
 #include "qtractorMidiSysex.h"
@@ -547,8 +548,11 @@ void qtractorMidiOutputThread::run (void)
 		qDebug("qtractorMidiOutputThread[%p]::run(): waked.", this);
 #endif
 		// Only if playing, the output process cycle.
-		if (m_pMidiEngine->isPlaying())
+		if (m_pMidiEngine->isPlaying()) {
+			qtractorEpoch::enter(qtractorEpoch::Midi);
 			process();
+			qtractorEpoch::leave(qtractorEpoch::Midi);
+		}
 	}
 
 	m_mutex.unlock();
@@ -1352,7 +1356,7 @@ void qtractorMidiEngine::resetTempo (void)
 		return;
 
 	// Recache tempo node...
-	qtractorTimeScale::Node *pNode
+	const qtractorTimeScale::Node *pNode
 		= m_pMetroCursor->seekFrame(pSession->playHead());
 
 	// Set queue tempo...
@@ -2075,8 +2079,8 @@ void qtractorMidiEngine::enqueue ( qtractorTrack *pTrack,
 			pEvent->type(), pEvent->value(), tick);
 
 	// Do it for the MIDI track plugins too...
-	qtractorTimeScale::Cursor& cursor = pSession->timeScale()->cursor();
-	qtractorTimeScale::Node *pNode = cursor.seekTick(iTime);
+	qtractorTimeScale::SnapshotCursor cursor(pSession->timeScale());
+	const qtractorTimeScale::Node *pNode = cursor.seekTick(iTime);
 	const long f0 = m_iFrameStart;
 	const unsigned long t0 = pNode->frameFromTick(iTime);
 	const unsigned long t1 = (long(t0) < f0 ? t0 : t0 - f0);
@@ -2154,7 +2158,8 @@ void qtractorMidiEngine::driftCheck (void)
 			m_pAlsaSeq, m_iAlsaQueue, pQueueStatus) >= 0) {
 		const long iAudioFrame = m_iFrameStart
 			+ pAudioEngine->jackFrameTime() - m_iAudioFrameStart;
-		qtractorTimeScale::Node *pNode = m_pMetroCursor->seekFrame(iAudioFrame);
+		qtractorTimeScale::SnapshotCursor cursor(pSession->timeScale());
+		const qtractorTimeScale::Node *pNode = cursor.seekFrame(iAudioFrame);
 		const long iAudioTime
 			= long(pNode->tickFromFrame(iAudioFrame)) - m_iTimeStart;
 		const long iMidiTime
@@ -2285,7 +2290,7 @@ bool qtractorMidiEngine::init (void)
 	}
 
 	// Time-scale cursor (tempo/time-signature map)
-	m_pMetroCursor = new qtractorTimeScale::Cursor(pSession->timeScale());
+	m_pMetroCursor = new qtractorTimeScale::SnapshotCursor(pSession->timeScale());
 
 	return true;
 }
@@ -3205,7 +3210,7 @@ void qtractorMidiEngine::processMetro (
 	if (m_pMetroCursor == NULL)
 		return;
 
-	qtractorTimeScale::Node *pNode = m_pMetroCursor->seekFrame(iFrameEnd);
+	const qtractorTimeScale::Node *pNode = m_pMetroCursor->seekFrame(iFrameEnd);
 
 	// Take this moment to check for tempo changes...
 	if (pNode->tempo != m_fMetroTempo) {
@@ -3324,7 +3329,7 @@ void qtractorMidiEngine::processMetro (
 
 
 // Access to current tempo/time-signature cursor.
-qtractorTimeScale::Cursor *qtractorMidiEngine::metroCursor (void) const
+qtractorTimeScale::SnapshotCursor *qtractorMidiEngine::metroCursor (void) const
 {
 	return m_pMetroCursor;
 }
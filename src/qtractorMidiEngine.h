@@ -202,7 +202,7 @@ public:
 	void processMetro(unsigned long iFrameStart, unsigned long iFrameEnd);
 
 	// Access to current tempo/time-signature cursor.
-	qtractorTimeScale::Cursor *metroCursor() const;
+	qtractorTimeScale::SnapshotCursor *metroCursor() const;
 
 	// Control bus accessors.
 	void setControlBus(bool bControlBus);
@@ -367,7 +367,7 @@ private:
 	bool             m_bMetroEnabled;
 
 	// Time-scale cursor (tempo/time-signature map)
-	qtractorTimeScale::Cursor *m_pMetroCursor;
+	qtractorTimeScale::SnapshotCursor *m_pMetroCursor;
 
 	// Track down tempo changes.
 	float m_fMetroTempo;
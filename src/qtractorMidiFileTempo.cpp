@@ -268,18 +268,23 @@ void qtractorMidiFileTempo::intoTimeScale (
 
 	pTimeScale->reset();
 
-	// Copy tempo-map nodes...
+	// Copy tempo-map nodes (nb. not published until
+	// updateScale, so seek on the live node list)...
+	qtractorTimeScale::Cursor& cursor = pTimeScale->cursor();
 	qtractorMidiFileTempo::Node *pNode = m_nodes.first();
 	while (pNode) {
 		const unsigned long iTime = uint64_t(pNode->tick) * p / q;
+		const unsigned long iTick = iTime + iTimeOffset;
 		pTimeScale->addNode(
-			pTimeScale->frameFromTick(iTime + iTimeOffset),
+			cursor.seekTick(iTick)->frameFromTick(iTick),
 			pNode->tempo, 2,
 			pNode->beatsPerBar,
 			pNode->beatDivisor);
 		pNode = pNode->next();
 	}
 
+	pTimeScale->updateScale();
+
 	// Copy location markers...
 	qtractorMidiFileTempo::Marker *pMarker = m_markers.first();
 	while (pMarker) {
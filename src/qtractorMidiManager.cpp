@@ -319,7 +319,7 @@ void qtractorMidiOutputBuffer::processSync (void)
 		return;
 
 	const unsigned long iTimeStart = pMidiEngine->timeStartEx();
-	qtractorTimeScale::Cursor cursor(pSession->timeScale());
+	qtractorTimeScale::SnapshotCursor cursor(pSession->timeScale());
 
 	qtractorMidiManager *pMidiManager = NULL;
 	if (m_pMidiBus->pluginList_out())
@@ -328,7 +328,7 @@ void qtractorMidiOutputBuffer::processSync (void)
 
 	snd_seq_event_t *pEv = m_outputBuffer.peek();
 	while (pEv) {
-		qtractorTimeScale::Node *pNode = cursor.seekFrame(pEv->time.tick);
+		const qtractorTimeScale::Node *pNode = cursor.seekFrame(pEv->time.tick);
 		const unsigned long iTime = pNode->tickFromFrame(pEv->time.tick);
 		const unsigned long tick = (iTime > iTimeStart ? iTime - iTimeStart : 0);
 		qtractorMidiEvent::EventType type = qtractorMidiEvent::EventType(0);
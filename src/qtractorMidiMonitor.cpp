@@ -198,8 +198,8 @@ void qtractorMidiMonitor::splitTime ( qtractorTimeScale *pTimeScale,
 	unsigned long iFrame, unsigned long iTime )
 {
 	// Reset time references...
-	qtractorTimeScale::Cursor cursor(pTimeScale);
-	qtractorTimeScale::Node *pNode = cursor.seekFrame(iFrame);
+	qtractorTimeScale::SnapshotCursor cursor(pTimeScale);
+	const qtractorTimeScale::Node *pNode = cursor.seekFrame(iFrame);
 	const unsigned long t0 = pNode->tickFromFrame(iFrame);
 
 	// Time slot: the amount of time (in ticks)
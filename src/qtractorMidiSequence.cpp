@@ -21,11 +21,183 @@
 
 #include "qtractorMidiSequence.h"
 
+#include "qtractorEpoch.h"
+
+#include <QHash>
+#include <QList>
+
+
+// Chase state checkpoint interval (in indexed events).
+static const unsigned int c_iChaseInterval = 128;
+
+
+// Event end time (as far as the interval tree is concerned).
+static inline unsigned long eventTimeEnd ( const qtractorMidiEvent *pEvent )
+{
+	if (pEvent->type() == qtractorMidiEvent::SYSEX)
+		return pEvent->time();
+	else
+		return pEvent->time() + pEvent->duration();
+}
+
 
 //----------------------------------------------------------------------
 // class qtractorMidiSequence -- The generic MIDI event sequence buffer.
 //
 
+// Chase state checkpoints: the last state event of each kind,
+// as of every so many indexed events (in sequence order).
+struct qtractorMidiSequence::ChaseIndex
+{
+	ChaseIndex(qtractorMidiEvent **ppIndex, unsigned int iCount)
+	{
+		count = (iCount / c_iChaseInterval) + 1;
+		offsets = new unsigned int [count + 1];
+		QHash<int, unsigned int> state;
+		QList<qtractorMidiEvent *> list;
+		unsigned int i = 0;
+		for (unsigned int k = 0; k < count; ++k) {
+			const unsigned int iEnd = k * c_iChaseInterval;
+			for ( ; i < iEnd; ++i) {
+				const int iKey = chaseKey(ppIndex[i]);
+				if (iKey >= 0)
+					state.insert(iKey, i);
+			}
+			QList<unsigned int> snap = state.values();
+			qSort(snap.begin(), snap.end());
+			offsets[k] = list.count();
+			QListIterator<unsigned int> iter(snap);
+			while (iter.hasNext())
+				list.append(ppIndex[iter.next()]);
+		}
+		offsets[count] = list.count();
+		events = new qtractorMidiEvent * [offsets[count] + 1];
+		for (i = 0; i < offsets[count]; ++i)
+			events[i] = list.at(i);
+	}
+
+	~ChaseIndex()
+	{
+		delete [] events;
+		delete [] offsets;
+	}
+
+	unsigned int        count;
+	unsigned int       *offsets;    // per checkpoint, (count + 1).
+	qtractorMidiEvent **events;
+};
+
+
+// Time-sorted event index, with an (implicit) interval tree:
+// each subtree [lo, hi) is rooted at its middle index, which
+// holds the maximum end time of the subtree.
+struct qtractorMidiSequence::Index : public qtractorEpoch::Item
+{
+	Index(const qtractorList<qtractorMidiEvent>& list)
+	{
+		count = list.count();
+		events = new qtractorMidiEvent * [count + 1];
+		ends = new unsigned long [count + 1];
+		// Collect event pointers;
+		// first SYSEX is kept (duration meaningless there)...
+		unsigned int i = 0;
+		sysex = count;
+		qtractorMidiEvent *pEvent = list.first();
+		for ( ; pEvent && i < count; pEvent = pEvent->next()) {
+			if (pEvent->type() == qtractorMidiEvent::SYSEX && sysex > i)
+				sysex = i;
+			events[i++] = pEvent;
+		}
+		count = i;
+		// Build the interval tree...
+		buildEnds(0, count);
+		// Build chase state checkpoints...
+		chase = new ChaseIndex(events, count);
+	}
+
+	~Index()
+	{
+		delete chase;
+		delete [] ends;
+		delete [] events;
+	}
+
+	// First indexed event at or after given time (binary search).
+	unsigned int find(unsigned long iTime) const
+	{
+		unsigned int lo = 0;
+		unsigned int hi = count;
+		while (lo < hi) {
+			const unsigned int mid = lo + ((hi - lo) >> 1);
+			if (events[mid]->time() < iTime)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		return lo;
+	}
+
+	// Interval tree builder (subtree maximum end times).
+	unsigned long buildEnds(unsigned int lo, unsigned int hi)
+	{
+		if (lo >= hi)
+			return 0;
+		const unsigned int mid = lo + ((hi - lo) >> 1);
+		unsigned long iTimeEnd = eventTimeEnd(events[mid]);
+		const unsigned long iTimeEnd1 = buildEnds(lo, mid);
+		if (iTimeEnd < iTimeEnd1)
+			iTimeEnd = iTimeEnd1;
+		const unsigned long iTimeEnd2 = buildEnds(mid + 1, hi);
+		if (iTimeEnd < iTimeEnd2)
+			iTimeEnd = iTimeEnd2;
+		ends[mid] = iTimeEnd;
+		return iTimeEnd;
+	}
+
+	// First indexed event ending at or after given time (or hi).
+	unsigned int findEnd(unsigned int lo, unsigned int hi,
+		unsigned long iTime) const
+	{
+		if (lo >= hi)
+			return hi;
+		const unsigned int mid = lo + ((hi - lo) >> 1);
+		if (ends[mid] < iTime)
+			return hi;
+		const unsigned int i = findEnd(lo, mid, iTime);
+		if (i < mid)
+			return i;
+		if (eventTimeEnd(events[mid]) >= iTime)
+			return mid;
+		return findEnd(mid + 1, hi, iTime);
+	}
+
+	// Collect indexed events overlapping given time range (in order).
+	void findEvents(unsigned int lo, unsigned int hi,
+		unsigned long iTimeStart, unsigned long iTimeEnd,
+		QList<qtractorMidiEvent *>& list) const
+	{
+		if (lo >= hi)
+			return;
+		const unsigned int mid = lo + ((hi - lo) >> 1);
+		if (ends[mid] < iTimeStart)
+			return;
+		findEvents(lo, mid, iTimeStart, iTimeEnd, list);
+		qtractorMidiEvent *pEvent = events[mid];
+		if (pEvent->time() >= iTimeEnd)
+			return;
+		if (eventTimeEnd(pEvent) >= iTimeStart)
+			list.append(pEvent);
+		findEvents(mid + 1, hi, iTimeStart, iTimeEnd, list);
+	}
+
+	qtractorMidiEvent **events;
+	unsigned long      *ends;       // Subtree maximum end times.
+	unsigned int        count;
+	unsigned int        sysex;      // First SYSEX event index.
+	ChaseIndex         *chase;      // Chase state checkpoints.
+};
+
+
 // Constructor.
 qtractorMidiSequence::qtractorMidiSequence ( const QString& sName,
 	unsigned short iChannel, unsigned short iTicksPerBeat )
@@ -50,6 +222,8 @@ qtractorMidiSequence::qtractorMidiSequence ( const QString& sName,
 qtractorMidiSequence::~qtractorMidiSequence (void)
 {
 	clear();
+
+	resetIndex();
 }
 
 
@@ -68,6 +242,10 @@ void qtractorMidiSequence::clear (void)
 
 	m_events.clear();
 	m_notes.clear();
+
+	// Empty index is an up-to-date one...
+	qtractorEpoch::retire(
+		qtractorEpoch::publish(m_pIndex, new Index(m_events)));
 }
 
 
@@ -125,6 +303,8 @@ void qtractorMidiSequence::addEvent ( qtractorMidiEvent *pEvent )
 // Insert event in correct time sort order.
 void qtractorMidiSequence::insertEvent ( qtractorMidiEvent *pEvent )
 {
+	resetIndex();
+
 	// Find the proper position in time sequence...
 	qtractorMidiEvent *pEventAfter = m_events.last();
 	while (pEventAfter && pEventAfter->time() > pEvent->time())
@@ -154,6 +334,8 @@ void qtractorMidiSequence::insertEvent ( qtractorMidiEvent *pEvent )
 // Unlink event from a channel sequence.
 void qtractorMidiSequence::unlinkEvent ( qtractorMidiEvent *pEvent )
 {
+	resetIndex();
+
 	m_events.unlink(pEvent);
 }
 
@@ -161,6 +343,8 @@ void qtractorMidiSequence::unlinkEvent ( qtractorMidiEvent *pEvent )
 // Remove event from a channel sequence.
 void qtractorMidiSequence::removeEvent ( qtractorMidiEvent *pEvent )
 {
+	resetIndex();
+
 	m_events.remove(pEvent);
 }
 
@@ -184,6 +368,197 @@ void qtractorMidiSequence::close (void)
 
 	// Reset all pending notes.
 	m_notes.clear();
+
+	// Ready for binary-search seeks...
+	updateIndex();
+}
+
+
+// Time-sorted event index (re)builder.
+void qtractorMidiSequence::updateIndex (void)
+{
+	// Build anew, chase state included; the old one is
+	// retired (still valid for any concurrent reader)...
+	qtractorEpoch::retire(
+		qtractorEpoch::publish(m_pIndex, new Index(m_events)));
+}
+
+
+// Event index invalidation (retires the current one).
+void qtractorMidiSequence::resetIndex (void)
+{
+	qtractorEpoch::retire(qtractorEpoch::publish(m_pIndex, (Index *) NULL));
+}
+
+
+// Whether the event index is up-to-date.
+bool qtractorMidiSequence::isIndexed (void) const
+{
+	return (qtractorEpoch::fetch(m_pIndex) != NULL);
+}
+
+
+// Last event before given time (or first) index look-up.
+qtractorMidiEvent *qtractorMidiSequence::seekEvent ( unsigned long iTime ) const
+{
+	const Index *pIndex = qtractorEpoch::fetch(m_pIndex);
+	if (pIndex == NULL) {
+		// Not indexed (anymore), do it the slow way...
+		qtractorMidiEvent *pEvent = m_events.first();
+		while (pEvent && pEvent->next()
+			&& (pEvent->next())->time() < iTime)
+			pEvent = pEvent->next();
+		return pEvent;
+	}
+
+	if (pIndex->count < 1)
+		return NULL;
+
+	const unsigned int i = pIndex->find(iTime);
+	return pIndex->events[i > 0 ? i - 1 : 0];
+}
+
+
+// First event possibly still running at given time index look-up;
+// the same as scanning from the first event, while it ends before.
+qtractorMidiEvent *qtractorMidiSequence::resetEvent ( unsigned long iTime ) const
+{
+	const Index *pIndex = qtractorEpoch::fetch(m_pIndex);
+	if (pIndex == NULL) {
+		// Not indexed (anymore), do it the slow way...
+		qtractorMidiEvent *pEvent = m_events.first();
+		while (pEvent && pEvent->time() + pEvent->duration() < iTime)
+			pEvent = pEvent->next();
+		return pEvent;
+	}
+
+	unsigned int i = pIndex->findEnd(0, pIndex->count, iTime);
+	if (i > pIndex->sysex)
+		i = pIndex->sysex;
+
+	return (i < pIndex->count ? pIndex->events[i] : NULL);
+}
+
+
+// Interval look-up: all events overlapping given time range
+// (starting before end, ending at or after start), time sorted.
+int qtractorMidiSequence::findEvents (
+	unsigned long iTimeStart, unsigned long iTimeEnd,
+	QList<qtractorMidiEvent *>& events ) const
+{
+	const int iCount = events.count();
+
+	const Index *pIndex = qtractorEpoch::fetch(m_pIndex);
+	if (pIndex) {
+		pIndex->findEvents(0, pIndex->count, iTimeStart, iTimeEnd, events);
+	} else {
+		// Not indexed yet (eg. while recording), do it the slow way...
+		qtractorMidiEvent *pEvent = m_events.first();
+		for ( ; pEvent && pEvent->time() < iTimeEnd; pEvent = pEvent->next()) {
+			if (eventTimeEnd(pEvent) >= iTimeStart)
+				events.append(pEvent);
+		}
+	}
+
+	return events.count() - iCount;
+}
+
+
+// Notes sounding at given time look-up.
+int qtractorMidiSequence::findNotes ( unsigned long iTime,
+	QList<qtractorMidiEvent *>& notes ) const
+{
+	QList<qtractorMidiEvent *> events;
+	findEvents(iTime, iTime + 1, events);
+
+	const int iCount = notes.count();
+
+	QListIterator<qtractorMidiEvent *> iter(events);
+	while (iter.hasNext()) {
+		qtractorMidiEvent *pEvent = iter.next();
+		if (pEvent->type() == qtractorMidiEvent::NOTEON
+			&& pEvent->time() + pEvent->duration() > iTime)
+			notes.append(pEvent);
+	}
+
+	return notes.count() - iCount;
+}
+
+
+// Chase state key (negative if not a chased event).
+int qtractorMidiSequence::chaseKey ( const qtractorMidiEvent *pEvent )
+{
+	switch (pEvent->type()) {
+	case qtractorMidiEvent::CONTROLLER: {
+		const unsigned char controller = pEvent->controller();
+		// Skip data entry, (N)RPN selectors and channel mode messages...
+		if (controller == 6 || controller == 38
+			|| (controller >= 96 && controller <= 101)
+			|| controller >= 120)
+			return -1;
+		return controller;
+	}
+	case qtractorMidiEvent::PGMCHANGE:
+		return 0x100;
+	case qtractorMidiEvent::PITCHBEND:
+		return 0x101;
+	case qtractorMidiEvent::CHANPRESS:
+		return 0x102;
+	case qtractorMidiEvent::REGPARAM:
+		return 0x10000 | pEvent->param();
+	case qtractorMidiEvent::NONREGPARAM:
+		return 0x20000 | pEvent->param();
+	case qtractorMidiEvent::CONTROL14:
+		return 0x30000 | pEvent->param();
+	default:
+		return -1;
+	}
+}
+
+
+// Chase look-up: last controller, program, pitch-bend... state
+// events before given time, in sequence order (RT-safe).
+unsigned int qtractorMidiSequence::chaseEvents ( unsigned long iTime,
+	qtractorMidiEvent **ppEvents, unsigned int iMaxEvents ) const
+{
+	const Index *pIndex = qtractorEpoch::fetch(m_pIndex);
+	if (pIndex == NULL)
+		return 0;
+
+	const ChaseIndex *pChaseIndex = pIndex->chase;
+
+	// Start from nearest checkpoint before...
+	const unsigned int iEnd = pIndex->find(iTime);
+	const unsigned int k = iEnd / c_iChaseInterval;
+	if (k >= pChaseIndex->count)
+		return 0;
+
+	unsigned int n = 0;
+	unsigned int j = pChaseIndex->offsets[k];
+	const unsigned int jEnd = pChaseIndex->offsets[k + 1];
+	for ( ; j < jEnd && n < iMaxEvents; ++j)
+		ppEvents[n++] = pChaseIndex->events[j];
+
+	// Replay the remaining events, latest of each kind
+	// moves to the end, so sequence order is kept...
+	for (unsigned int i = k * c_iChaseInterval; i < iEnd; ++i) {
+		qtractorMidiEvent *pEvent = pIndex->events[i];
+		const int iKey = chaseKey(pEvent);
+		if (iKey < 0)
+			continue;
+		for (j = 0; j < n; ++j) {
+			if (chaseKey(ppEvents[j]) == iKey)
+				break;
+		}
+		if (j < n) {
+			for (--n; j < n; ++j)
+				ppEvents[j] = ppEvents[j + 1];
+		}
+		if (n < iMaxEvents)
+			ppEvents[n++] = pEvent;
+	}
+
+	return n;
 }
 
 
@@ -225,6 +600,7 @@ void qtractorMidiSequence::replaceEvents ( qtractorMidiSequence *pSeq,
 	}
 
 	// Done.
+	updateIndex();
 }
 
 
@@ -232,6 +608,7 @@ void qtractorMidiSequence::replaceEvents ( qtractorMidiSequence *pSeq,
 void qtractorMidiSequence::copyEvents ( qtractorMidiSequence *pSeq )
 {
 	// Remove existing events.
+	resetIndex();
 	m_events.clear();
 	
 	// Clone new ones...
@@ -240,6 +617,7 @@ void qtractorMidiSequence::copyEvents ( qtractorMidiSequence *pSeq )
 		m_events.append(new qtractorMidiEvent(*pEvent));
 
 	// Done.
+	updateIndex();
 }
 
 
@@ -26,6 +26,8 @@
 
 #include <QString>
 #include <QMultiHash>
+#include <QList>
+#include <QAtomicPointer>
 
 // typedef unsigned long long uint64_t;
 #include <stdint.h>
@@ -123,9 +125,43 @@ public:
 	// Sequence closure method.
 	void close();
 
+	// Time-sorted event index (re)builder.
+	void updateIndex();
+
+	// Whether the event index is up-to-date.
+	bool isIndexed() const;
+
+	// Last event before given time (or first) index look-up.
+	qtractorMidiEvent *seekEvent(unsigned long iTime) const;
+
+	// First event possibly still running at given time index look-up.
+	qtractorMidiEvent *resetEvent(unsigned long iTime) const;
+
+	// Interval look-up: all events overlapping given time range
+	// (starting before end, ending at or after start), time sorted.
+	int findEvents(unsigned long iTimeStart, unsigned long iTimeEnd,
+		QList<qtractorMidiEvent *>& events) const;
+
+	// Notes sounding at given time look-up.
+	int findNotes(unsigned long iTime,
+		QList<qtractorMidiEvent *>& notes) const;
+
+	// Chase look-up: last controller, program, pitch-bend... state
+	// events before given time, in sequence order (RT-safe).
+	unsigned int chaseEvents(unsigned long iTime,
+		qtractorMidiEvent **ppEvents, unsigned int iMaxEvents) const;
+
 	// Typed hash table to track note-ons.
 	typedef QMultiHash<unsigned char, qtractorMidiEvent *> NoteMap;
 
+protected:
+
+	// Event index invalidation (retires the current one).
+	void resetIndex();
+
+	// Chase state key (negative if not a chased event).
+	static int chaseKey(const qtractorMidiEvent *pEvent);
+
 private:
 
 	// Sequence/track properties.
@@ -152,6 +188,15 @@ private:
 
 	// Local hash table to track note-ons.
 	NoteMap m_notes;
+
+	// Chase state checkpoints, every so many indexed events.
+	struct ChaseIndex;
+
+	// Time-sorted event index (binary-search seek), chase state
+	// included; immutable, published atomically (null when dirty).
+	struct Index;
+
+	QAtomicPointer<Index> m_pIndex;
 };
 
 
@@ -55,6 +55,11 @@ public:
 	float prevValue() const
 		{ return m_fPrevValue; }
 
+	// Direct value setter, with no observer notification
+	// whatsoever (eg. sub-block automation, realtime-safe).
+	void setValueEx(float fValue)
+		{ m_fValue = safeValue(fValue); }
+
 	// Observers notification.
 	void notify(qtractorObserver *pSender, bool bUpdate);
 
@@ -27,6 +27,7 @@
 #include <QSplitter>
 #include <QAction>
 #include <QList>
+#include <QThread>
 
 #include <QTextStream>
 
@@ -95,6 +96,7 @@ void qtractorOptions::loadOptions (void)
 	iDisplayFormat  = m_settings.value("/DisplayFormat", 1).toInt();
 	iMaxRecentFiles = m_settings.value("/MaxRecentFiles", 5).toInt();
 	iBaseFontSize   = m_settings.value("/BaseFontSize", 0).toInt();
+	iUndoMemoryLimit = m_settings.value("/UndoMemoryLimit", 256).toInt();
 	m_settings.endGroup();
 
 	// Load logging options...
@@ -138,6 +140,7 @@ void qtractorOptions::loadOptions (void)
 	bAudioAutoTimeStretch = m_settings.value("/AutoTimeStretch", false).toBool();
 	bAudioWsolaTimeStretch = m_settings.value("/WsolaTimeStretch", true).toBool();
 	bAudioWsolaQuickSeek = m_settings.value("/WsolaQuickSeek", false).toBool();
+	bAudioWsolaFastSeek  = m_settings.value("/WsolaFastSeek", false).toBool();
 	bAudioPlayerBus      = m_settings.value("/PlayerBus", false).toBool();
 	bAudioMetroBus       = m_settings.value("/MetroBus", false).toBool();
 	bAudioMetronome      = m_settings.value("/Metronome", false).toBool();
@@ -145,6 +148,12 @@ void qtractorOptions::loadOptions (void)
 	bAudioPlayerAutoConnect = m_settings.value("/PlayerAutoConnect", true).toBool();
 	bAudioMetroAutoConnect = m_settings.value("/MetroAutoConnect", true).toBool();
 	iAudioMetroOffset  = (unsigned long) m_settings.value("/MetroOffset", 0).toUInt();
+	iAudioWorkers      = m_settings.value("/Workers", 0).toInt();
+	iAudioPageCache    = m_settings.value("/PageCache", 128).toInt();
+	iAudioSyncThreads  = m_settings.value("/SyncThreads", 0).toInt();
+	bAudioStretchCache = m_settings.value("/StretchCache", false).toBool();
+	iAudioStretchCacheSize = m_settings.value("/StretchCacheSize", 1024).toInt();
+	iAudioAutomationBlock = m_settings.value("/AutomationBlock", 0).toInt();
 	m_settings.endGroup();
 
 	// MIDI rendering options group.
@@ -238,11 +247,10 @@ void qtractorOptions::loadOptions (void)
 	bOpenEditor = m_settings.value("/OpenEditor", true).toBool();
 	bQueryEditorType = m_settings.value("/QueryEditorType", false).toBool();
 	bDummyPluginScan = m_settings.value("/DummyPluginScan", true).toBool();
-	iDummyLadspaHash = m_settings.value("/DummyLadspaHash", 0).toInt();
-	iDummyDssiHash = m_settings.value("/DummyDssiHash", 0).toInt();
-	iDummyVstHash = m_settings.value("/DummyVstHash", 0).toInt();
-	iDummyLv2Hash = m_settings.value("/DummyLv2Hash", 0).toInt();
+	iDummyPluginScanJobs = m_settings.value("/DummyPluginScanJobs", 0).toInt();
 	bLv2DynManifest = m_settings.value("/Lv2DynManifest", false).toBool();
+	iLv2WorkerThreads = m_settings.value("/Lv2WorkerThreads",
+		QThread::idealThreadCount()).toInt();
 	bSaveCurve14bit = m_settings.value("/SaveCurve14bit", false).toBool();
 	m_settings.endGroup();
 
@@ -393,6 +401,7 @@ void qtractorOptions::saveOptions (void)
 	m_settings.setValue("/DisplayFormat", iDisplayFormat);
 	m_settings.setValue("/MaxRecentFiles", iMaxRecentFiles);
 	m_settings.setValue("/BaseFontSize", iBaseFontSize);
+	m_settings.setValue("/UndoMemoryLimit", iUndoMemoryLimit);
 	m_settings.endGroup();
 
 	// Save logging options...
@@ -436,6 +445,7 @@ void qtractorOptions::saveOptions (void)
 	m_settings.setValue("/AutoTimeStretch", bAudioAutoTimeStretch);
 	m_settings.setValue("/WsolaTimeStretch", bAudioWsolaTimeStretch);
 	m_settings.setValue("/WsolaQuickSeek", bAudioWsolaQuickSeek);
+	m_settings.setValue("/WsolaFastSeek", bAudioWsolaFastSeek);
 	m_settings.setValue("/PlayerBus", bAudioPlayerBus);
 	m_settings.setValue("/MetroBus", bAudioMetroBus);
 	m_settings.setValue("/Metronome", bAudioMetronome);
@@ -443,6 +453,12 @@ void qtractorOptions::saveOptions (void)
 	m_settings.setValue("/PlayerAutoConnect", bAudioPlayerAutoConnect);
 	m_settings.setValue("/MetroAutoConnect", bAudioMetroAutoConnect);
 	m_settings.setValue("/MetroOffset", uint(iAudioMetroOffset));
+	m_settings.setValue("/Workers", iAudioWorkers);
+	m_settings.setValue("/PageCache", iAudioPageCache);
+	m_settings.setValue("/SyncThreads", iAudioSyncThreads);
+	m_settings.setValue("/StretchCache", bAudioStretchCache);
+	m_settings.setValue("/StretchCacheSize", iAudioStretchCacheSize);
+	m_settings.setValue("/AutomationBlock", iAudioAutomationBlock);
 	m_settings.endGroup();
 
 	// MIDI rendering options group.
@@ -536,11 +552,9 @@ void qtractorOptions::saveOptions (void)
 	m_settings.setValue("/OpenEditor", bOpenEditor);
 	m_settings.setValue("/QueryEditorType", bQueryEditorType);
 	m_settings.setValue("/DummyPluginScan", bDummyPluginScan);
-	m_settings.setValue("/DummyLadspaHash", iDummyLadspaHash);
-	m_settings.setValue("/DummyDssiHash", iDummyDssiHash);
-	m_settings.setValue("/DummyVstHash", iDummyVstHash);
-	m_settings.setValue("/DummyLv2Hash", iDummyLv2Hash);
+	m_settings.setValue("/DummyPluginScanJobs", iDummyPluginScanJobs);
 	m_settings.setValue("/Lv2DynManifest", bLv2DynManifest);
+	m_settings.setValue("/Lv2WorkerThreads", iLv2WorkerThreads);
 	m_settings.setValue("/SaveCurve14bit", bSaveCurve14bit);
 	m_settings.endGroup();
 
@@ -109,6 +109,7 @@ public:
 	bool    bAudioAutoTimeStretch;
 	bool    bAudioWsolaTimeStretch;
 	bool    bAudioWsolaQuickSeek;
+	bool    bAudioWsolaFastSeek;
 	bool    bAudioPlayerBus;
 	bool    bAudioMetroBus;
 	bool    bAudioMetronome;
@@ -120,6 +121,22 @@ public:
 	// Audio metronome latency offset compensation.
 	unsigned long iAudioMetroOffset;
 
+	// Audio parallel track processing workers (0=disabled).
+	int     iAudioWorkers;
+
+	// Audio shared decoded page cache size (MB; 0=disabled).
+	int     iAudioPageCache;
+
+	// Audio track buffer threads (0=one per track).
+	int     iAudioSyncThreads;
+
+	// Audio pre-rendered time-stretch cache.
+	bool    bAudioStretchCache;
+	int     iAudioStretchCacheSize;
+
+	// Audio sub-block automation size (frames; 0=disabled).
+	int     iAudioAutomationBlock;
+
 	// Audio metronome parameters.
 	QString sMetroBarFilename;
 	float   fMetroBarGain;
@@ -231,13 +248,11 @@ public:
 
 	// Out-of-process plugin scanning and cache option.
 	bool bDummyPluginScan;
-	int  iDummyLadspaHash;
-	int  iDummyDssiHash;
-	int  iDummyVstHash;
-	int  iDummyLv2Hash;
+	int  iDummyPluginScanJobs;
 
 	// LV2 plugin specific options.
 	bool bLv2DynManifest;
+	int  iLv2WorkerThreads;
 
 	// Automation preferred resolution (14bit).
 	bool bSaveCurve14bit;
@@ -252,6 +267,9 @@ public:
 	int iMaxRecentFiles;
 	QStringList recentFiles;
 
+	// Undo history memory budget (in MB; 0=unlimited).
+	int iUndoMemoryLimit;
+
 	// Tracks view options...
 	int  iTrackViewSelectMode;
 	bool bTrackViewDropSpan;
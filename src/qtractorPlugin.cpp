@@ -1437,6 +1437,8 @@ qtractorPluginList::qtractorPluginList (
 	m_pppBuffers[0] = NULL;
 	m_pppBuffers[1] = NULL;
 
+	m_ppSubBuffer = NULL;
+
 	m_pCurveList = new qtractorCurveList();
 
 	m_bAudioOutputBus
@@ -1543,6 +1545,11 @@ void qtractorPluginList::setChannelsEx (
 		m_pppBuffers[1] = NULL;
 	}
 
+	if (m_ppSubBuffer) {
+		delete [] m_ppSubBuffer;
+		m_ppSubBuffer = NULL;
+	}
+
 	// Go, go, go...
 	m_iChannels = iChannels;
 
@@ -1563,6 +1570,7 @@ void qtractorPluginList::setChannelsEx (
 			m_pppBuffers[1][i] = new float [iBufferSize];
 			::memset(m_pppBuffers[1][i], 0, iBufferSize * sizeof(float));
 		}
+		m_ppSubBuffer = new float * [m_iChannels];
 	}
 
 	// Reset all plugin chain channels...
@@ -1861,6 +1869,36 @@ void qtractorPluginList::process ( float **ppBuffer, unsigned int nframes )
 }
 
 
+// Whether the chain may be processed in sub-blocks
+// (insert and aux-send plugins work on whole bus buffers).
+bool qtractorPluginList::isSubBlockSafe (void) const
+{
+	qtractorPlugin *pPlugin = first();
+	while (pPlugin) {
+		const qtractorPluginType::Hint typeHint = pPlugin->type()->typeHint();
+		if (typeHint == qtractorPluginType::Insert
+			|| typeHint == qtractorPluginType::AuxSend)
+			return false;
+		pPlugin = pPlugin->next();
+	}
+
+	return true;
+}
+
+
+// Sub-block buffer references (at given frame offset).
+float **qtractorPluginList::subBuffer ( float **ppBuffer, unsigned int iOffset )
+{
+	if (ppBuffer == NULL || m_ppSubBuffer == NULL)
+		return NULL;
+
+	for (unsigned short i = 0; i < m_iChannels; ++i)
+		m_ppSubBuffer[i] = ppBuffer[i] + iOffset;
+
+	return m_ppSubBuffer;
+}
+
+
 // Document element methods.
 bool qtractorPluginList::loadElement (
 	qtractorDocument *pDocument, QDomElement *pElement )
@@ -834,6 +834,12 @@ public:
 	// The meta-main audio-processing plugin-chain procedure.
 	void process(float **ppBuffer, unsigned int nframes);
 
+	// Whether the chain may be processed in sub-blocks.
+	bool isSubBlockSafe() const;
+
+	// Sub-block buffer references (at given frame offset).
+	float **subBuffer(float **ppBuffer, unsigned int iOffset);
+
 	// Document element methods.
 	bool loadElement(qtractorDocument *pDocument, QDomElement *pElement);
 	bool saveElement(qtractorDocument *pDocument, QDomElement *pElement);
@@ -973,6 +979,9 @@ private:
 	// Internal running buffer chain references.
 	float **m_pppBuffers[2];
 
+	// Sub-block buffer references (automation).
+	float **m_ppSubBuffer;
+
 	// MIDI bank/program observable subject.
 	MidiProgramSubject *m_pMidiProgramSubject;
 
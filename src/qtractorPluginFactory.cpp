@@ -40,10 +40,12 @@
 #include "qtractorOptions.h"
 
 #include <QApplication>
+#include <QThread>
 
 #include <QTextStream>
 #include <QFileInfo>
 #include <QDateTime>
+#include <QTime>
 #include <QDir>
 
 #if QT_VERSION < 0x050000
@@ -69,7 +71,8 @@ qtractorPluginFactory *qtractorPluginFactory::getInstance (void)
 
 // Contructor.
 qtractorPluginFactory::qtractorPluginFactory ( QObject *pParent )
-	: QObject(pParent), m_typeHint(qtractorPluginType::Any)
+	: QObject(pParent), m_typeHint(qtractorPluginType::Any),
+		m_iScanFile(0), m_iScanFiles(0)
 {
 	g_pPluginFactory = this;
 }
@@ -243,58 +246,32 @@ bool qtractorPluginFactory::startScan ( qtractorPluginType::Hint typeHint )
 	if (pOptions == NULL)
 		return false;
 
-	bool bDummyPluginScan = pOptions->bDummyPluginScan;
-	int  iDummyPluginHash = 0;
+	if (!pOptions->bDummyPluginScan)
+		return false;
 
-	switch (typeHint) {
-	case qtractorPluginType::Ladspa:
-		iDummyPluginHash = pOptions->iDummyLadspaHash;
-		break;
-	case qtractorPluginType::Dssi:
-		iDummyPluginHash = pOptions->iDummyDssiHash;
-		break;
-	case qtractorPluginType::Vst:
-		iDummyPluginHash = pOptions->iDummyVstHash;
-		break;
-	case qtractorPluginType::Lv2:
-		iDummyPluginHash = pOptions->iDummyLv2Hash;
-		break;
-	default:
-		break;
-	}
+	// How many concurrent scan jobs (processes)?
+	int iJobs = pOptions->iDummyPluginScanJobs;
+	if (iJobs < 1)
+		iJobs = QThread::idealThreadCount();
 
-	if (bDummyPluginScan) {
-		const int iNewDummyPluginHash
-			= m_files.value(typeHint).count();
-		Scanner *pScanner = new Scanner(typeHint, this);
-		if (pScanner->open(iDummyPluginHash != iNewDummyPluginHash)) {
-			m_scanners.insert(typeHint, pScanner);
-			switch (typeHint) {
-			case qtractorPluginType::Ladspa:
-				pOptions->iDummyLadspaHash = iNewDummyPluginHash;
-				break;
-			case qtractorPluginType::Dssi:
-				pOptions->iDummyDssiHash = iNewDummyPluginHash;
-				break;
-			case qtractorPluginType::Vst:
-				pOptions->iDummyVstHash = iNewDummyPluginHash;
-				break;
-			case qtractorPluginType::Lv2:
-				pOptions->iDummyLv2Hash = iNewDummyPluginHash;
-				break;
-			default:
-				break;
-			}
-			// Remember to cleanup cache later, when applicable...
-			const QString& sCacheFilePath = pScanner->cacheFilePath();
-			if (!m_cacheFilePaths.contains(sCacheFilePath))
-				m_cacheFilePaths.append(sCacheFilePath);
-			// Done.
-			return true;
-		}
+	Scanner *pScanner = new Scanner(typeHint, this);
+	if (!pScanner->open(iJobs)) {
+		delete pScanner;
+		return false;
 	}
 
-	return false;
+	m_scanners.insert(typeHint, pScanner);
+
+	// Remember to cleanup cache later, when applicable...
+	const QString& sCacheFilePath = pScanner->cacheFilePath();
+	if (!m_cacheFilePaths.contains(sCacheFilePath))
+		m_cacheFilePaths.append(sCacheFilePath);
+	const QString& sBlacklistFilePath = pScanner->blacklistFilePath();
+	if (!m_cacheFilePaths.contains(sBlacklistFilePath))
+		m_cacheFilePaths.append(sBlacklistFilePath);
+
+	// Done.
+	return true;
 }
 
 
@@ -363,17 +340,23 @@ void qtractorPluginFactory::scan (void)
 #endif
 
 	// Do the real scan...
-	int iFile = 0;
+	m_iScanFile = 0;
+	m_iScanFiles = iFileCount;
+
 	Paths::ConstIterator files_iter = m_files.constBegin();
 	const Paths::ConstIterator& files_end = m_files.constEnd();
 	for ( ; files_iter != files_end; ++files_iter) {
 		const qtractorPluginType::Hint typeHint = files_iter.key();
+		// Try first out-of-process (cached) scans, if any...
+		Scanner *pScanner = m_scanners.value(typeHint, NULL);
+		if (pScanner) {
+			pScanner->addFiles(files_iter.value());
+			continue;
+		}
 		QStringListIterator file_iter(files_iter.value());
 		while (file_iter.hasNext()) {
 			addTypes(typeHint, file_iter.next());
-			emit scanned((++iFile * 100) / iFileCount);
-			QApplication::processEvents(
-				QEventLoop::ExcludeUserInputEvents);
+			scanProgress();
 		}
 	}
 
@@ -382,6 +365,17 @@ void qtractorPluginFactory::scan (void)
 }
 
 
+// Scan progress feedback (per file).
+void qtractorPluginFactory::scanProgress (void)
+{
+	if (m_iScanFiles > 0)
+		emit scanned((++m_iScanFile * 100) / m_iScanFiles);
+
+	QApplication::processEvents(
+		QEventLoop::ExcludeUserInputEvents);
+}
+
+
 void qtractorPluginFactory::reset (void)
 {
 	// Check the proxy (out-of-process) client closure...
@@ -553,11 +547,6 @@ qtractorPlugin *qtractorPluginFactory::createPlugin (
 bool qtractorPluginFactory::addTypes (
 	qtractorPluginType::Hint typeHint, const QString& sFilename )
 {
-	// Try first out-of-process scans, if any...
-	Scanner *pScanner = m_scanners.value(typeHint, NULL);
-	if (pScanner)
-		return pScanner->addTypes(typeHint, sFilename);
-
 #ifdef CONFIG_LV2
 	// Try first URI-based plugin types (LV2...)
 	if (typeHint == qtractorPluginType::Lv2) {
@@ -645,255 +634,549 @@ bool qtractorPluginFactory::addTypes (
 // qtractorPluginFactory::Scanner -- Plugin path proxy (out-of-process client).
 //
 
+// Out-of-process scan protocol (end-of-file answer).
+static const char *c_sScanDone = "qtractor_plugin_scan: done.";
+
+// Out-of-process scan (per file) timeout (msecs);
+// slow plugins timing out are retried on next scan.
+static const int c_iScanTimeout = 10000;
+
+
+// Scan job descriptor.
+struct qtractorPluginFactory::Scanner::Job
+{
+	QProcess   *process;
+	QString     filename;
+	QString     stamp;
+	QStringList list;
+	QTime       time;
+};
+
+
 // Constructor.
 qtractorPluginFactory::Scanner::Scanner (
 	qtractorPluginType::Hint typeHint, QObject *pParent )
-	: QProcess(pParent), m_typeHint(typeHint), m_iExitStatus(-1)
+	: QObject(pParent), m_typeHint(typeHint), m_iJobs(0),
+		m_bCacheDirty(false), m_bBlacklistDirty(false)
 {
-	QObject::connect(this,
-		SIGNAL(readyReadStandardOutput()),
-		SLOT(stdout_slot()));
-	QObject::connect(this,
-		SIGNAL(readyReadStandardError()),
-		SLOT(stderr_slot()));
-	QObject::connect(this,
-		SIGNAL(finished(int, QProcess::ExitStatus)),
-		SLOT(exit_slot(int, QProcess::ExitStatus)));
 }
 
 
-// Open/start method.
-bool qtractorPluginFactory::Scanner::open ( bool bReset )
+// Destructor.
+qtractorPluginFactory::Scanner::~Scanner (void)
 {
-	// Cache file setup...
-	m_file.setFileName(cacheFilePath());
-	m_list.clear();
+	close();
+}
 
-	// Open and read cache file, whether applicable...
-	if (!bReset && m_file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-		// Read from cache...
-		QTextStream sin(&m_file);
-		while (!sin.atEnd()) {
-			const QString& sText = sin.readLine();
-			if (sText.isEmpty())
-				continue;
-			const QStringList& props = sText.split('|');
-			if (props.count() >= 6) // get filename...
-				m_list[props.at(6)].append(sText);
-		}
-		// May close the file.
-		m_file.close();
-		return true;
-	}
 
+// Open/start method.
+bool qtractorPluginFactory::Scanner::open ( int iJobs )
+{
 	// Make sure cache file location do exists...
-	const QFileInfo fi(m_file);
+	const QFileInfo fi(cacheFilePath());
 	if (!fi.dir().mkpath(fi.absolutePath()))
 		return false;
 
-	// Open cache file for writing...
-	if (!m_file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate))
-		return false;
+	m_iJobs = 0;
 
 	// LV2 plugins are dang special,
 	// need no out-of-process scanning whatsoever...
-	if (m_typeHint == qtractorPluginType::Lv2) {
-		m_iExitStatus = 0;
-		return true;
+	if (m_typeHint != qtractorPluginType::Lv2) {
+		// Get the main scanner executable...
+		const QString sName("qtractor_plugin_scan");
+		const QString sLibdir(CONFIG_LIBDIR);
+		QFileInfo fi1(sLibdir + QDir::separator() + PACKAGE_TARNAME, sName);
+		const QFileInfo fi2(QApplication::applicationDirPath(), sName);
+		if (!fi1.isExecutable()
+			|| (fi1.isExecutable() && fi2.isExecutable()
+				&& fi1.lastModified() < fi2.lastModified())) {
+			fi1 = fi2;
+		}
+		if (!fi1.isExecutable())
+			return false;
+		m_sScanner = fi1.filePath();
+		m_iJobs = (iJobs > 0 ? iJobs : 1);
 	}
 
-	// Go go go...
-	return start();
+	// Read previous results, whether applicable...
+	readCache();
+	readBlacklist();
+
+	return true;
 }
 
 
 // Close/stop method.
 void qtractorPluginFactory::Scanner::close (void)
 {
-	// We're we scanning hard?...
-	if (QProcess::state() != QProcess::NotRunning || m_iExitStatus < 0) {
-		QProcess::closeWriteChannel();
-		QProcess::waitForFinished(200);
+	// Stop all scan jobs...
+	QListIterator<Job *> iter(m_jobs);
+	while (iter.hasNext()) {
+		Job *pJob = iter.next();
+		QProcess *pProcess = pJob->process;
+		if (pProcess) {
+			if (pProcess->state() != QProcess::NotRunning) {
+				pProcess->closeWriteChannel();
+				if (!pProcess->waitForFinished(200))
+					pProcess->kill();
+			}
+			delete pProcess;
+		}
+		delete pJob;
 	}
+	m_jobs.clear();
 
-	// Done anyway.
-	QProcess::terminate();
-
-	// Close cache file...
-	if (m_file.isOpen())
-		m_file.close();
+	// Save results, if anything changed...
+	if (m_bCacheDirty || m_list.count() != m_cache.count())
+		writeCache();
+	if (m_bBlacklistDirty)
+		writeBlacklist();
 
 	// Cleanup cache...
+	m_cache.clear();
 	m_list.clear();
+	m_blacklist.clear();
+
+	m_bCacheDirty = false;
+	m_bBlacklistDirty = false;
 }
 
 
-// Scan start method.
-bool qtractorPluginFactory::Scanner::start (void)
+// Service methods.
+void qtractorPluginFactory::Scanner::addFiles ( const QStringList& files )
 {
-	// Maybe we're still running, doh!
-	if (QProcess::state() != QProcess::NotRunning)
-		return false;
+	qtractorPluginFactory *pPluginFactory
+		= static_cast<qtractorPluginFactory *> (QObject::parent());
+	if (pPluginFactory == NULL)
+		return;
 
-	// Start from scratch...
-	m_iExitStatus = -1;
+	// Sort out what's already cached in...
+	QStringList pending;
 
-	// Get the main scanner executable...
-	const QString sName("qtractor_plugin_scan");
-	const QString sLibdir(CONFIG_LIBDIR);
-	QFileInfo fi(sLibdir + QDir::separator() + PACKAGE_TARNAME, sName);
-	const QFileInfo fi2(QApplication::applicationDirPath(), sName);
-	if (!fi.isExecutable()
-		|| (fi.isExecutable() && fi2.isExecutable()
-			&& fi.lastModified() < fi2.lastModified())) {
-		fi = fi2;
+	QStringListIterator iter(files);
+	while (iter.hasNext()) {
+		const QString& sFilename = iter.next();
+		const QString& sStamp = fileStamp(sFilename);
+		// Blacklisted, unless it has been modified since...
+		if (m_blacklist.contains(sFilename)) {
+			if (m_blacklist.value(sFilename) == sStamp) {
+				pPluginFactory->scanProgress();
+				continue;
+			}
+			m_blacklist.remove(sFilename);
+			m_bBlacklistDirty = true;
+		}
+		// Cached, unless it has been modified since...
+		Entries::ConstIterator found = m_cache.constFind(sFilename);
+		if (found != m_cache.constEnd() && found.value().stamp == sStamp) {
+			addTypes(sFilename, sStamp, found.value().list);
+			pPluginFactory->scanProgress();
+			continue;
+		}
+		// Not cached, yet...
+		pending.append(sFilename);
 	}
 
-	if (!fi.isExecutable())
-		return false;
+	if (pending.isEmpty())
+		return;
 
-	// Go go go!
-	QProcess::start(fi.filePath());
-	return true;
+	m_bCacheDirty = true;
+
+#ifdef CONFIG_LV2
+	// LV2 plugins are dang special...
+	if (m_typeHint == qtractorPluginType::Lv2) {
+		QStringListIterator lv2_iter(pending);
+		while (lv2_iter.hasNext()) {
+			addLv2Types(lv2_iter.next());
+			pPluginFactory->scanProgress();
+		}
+		return;
+	}
+#endif
+
+	// Go go go...
+	runJobs(pending);
+
+	// Whatever is left (eg. no scan jobs could be started)
+	// may still be scanned in-process, as a last resort...
+	QStringListIterator left_iter(pending);
+	while (left_iter.hasNext()) {
+		pPluginFactory->addTypes(m_typeHint, left_iter.next());
+		pPluginFactory->scanProgress();
+	}
 }
 
 
-// Service slots.
-void qtractorPluginFactory::Scanner::stdout_slot (void)
+// Scan jobs dispatcher.
+void qtractorPluginFactory::Scanner::runJobs ( QStringList& files )
 {
 	qtractorPluginFactory *pPluginFactory
 		= static_cast<qtractorPluginFactory *> (QObject::parent());
 	if (pPluginFactory == NULL)
 		return;
 
-	const QString sData(QProcess::readAllStandardOutput());
-	addTypes(sData.split('\n'));
+	// Lazy start the scan jobs, no more than necessary...
+	const int iJobs = qMin(m_iJobs, files.count());
+	while (m_jobs.count() < iJobs) {
+		Job *pJob = new Job;
+		pJob->process = NULL;
+		if (!startJob(pJob)) {
+			delete pJob;
+			break;
+		}
+		m_jobs.append(pJob);
+	}
+
+	int iBusy = 0;
+	int iWait = 0;
+
+	while (!files.isEmpty() || iBusy > 0) {
+		// Bail out if no scan jobs are left...
+		const int iCount = m_jobs.count();
+		if (iCount < 1)
+			break;
+		Job *pWaitJob = NULL;
+		QListIterator<Job *> iter(m_jobs);
+		while (iter.hasNext()) {
+			Job *pJob = iter.next();
+			if (pJob->filename.isEmpty()) {
+				// Idle job, feed it with next file...
+				if (!files.isEmpty()) {
+					writeJob(pJob, files.takeFirst());
+					++iBusy;
+				}
+			}
+			else
+			if (readJob(pJob)) {
+				// Busy job, just finished...
+				pPluginFactory->scanProgress();
+				--iBusy;
+			}
+			else
+			if (pWaitJob == NULL || (iWait % iCount) == m_jobs.indexOf(pJob))
+				pWaitJob = pJob;
+		}
+		// Wait for one busy job answer, in turn...
+		if (pWaitJob) {
+			pWaitJob->process->waitForReadyRead(20);
+			++iWait;
+		}
+	}
 }
 
 
-void qtractorPluginFactory::Scanner::stderr_slot (void)
+// Scan job (re)start method.
+bool qtractorPluginFactory::Scanner::startJob ( Job *pJob )
 {
-	QTextStream(stderr) << QProcess::readAllStandardError();
+	if (pJob->process) {
+		pJob->process->kill();
+		pJob->process->waitForFinished(200);
+		delete pJob->process;
+	}
+
+	pJob->process = new QProcess();
+	pJob->process->start(m_sScanner);
+	if (!pJob->process->waitForStarted(3000)) {
+		delete pJob->process;
+		pJob->process = NULL;
+		return false;
+	}
+
+	pJob->filename.clear();
+	pJob->stamp.clear();
+	pJob->list.clear();
+
+	return true;
 }
 
 
-void qtractorPluginFactory::Scanner::exit_slot (
-	int exitCode, QProcess::ExitStatus exitStatus )
+// Scan job request (one file at a time).
+void qtractorPluginFactory::Scanner::writeJob (
+	Job *pJob, const QString& sFilename )
 {
-	if (m_iExitStatus < 0)
-		m_iExitStatus = 0;
+	pJob->filename = sFilename;
+	pJob->stamp = fileStamp(sFilename);
+	pJob->list.clear();
+	pJob->time.start();
 
-	if (exitCode || exitStatus != QProcess::NormalExit)
-		++m_iExitStatus;
+	const QString& sHint = qtractorPluginType::textFromHint(m_typeHint);
+	const QString& sLine = sHint + ':' + sFilename + '\n';
+	pJob->process->write(sLine.toUtf8());
 }
 
 
-// Service methods.
-bool qtractorPluginFactory::Scanner::addTypes (
-	qtractorPluginType::Hint typeHint, const QString& sFilename )
+// Scan job answer (true when done with current file).
+bool qtractorPluginFactory::Scanner::readJob ( Job *pJob )
 {
-	// See if it's already cached in...
-	if (!m_list.isEmpty()) {
-		const QStringList& list = m_list.value(sFilename);
-		if (list.isEmpty())
-			return false;
-		else
-			return addTypes(list);
-	}
+	QProcess *pProcess = pJob->process;
 
-#ifdef CONFIG_LV2
-	// LV2 plugins are dang special...
-	if (typeHint == qtractorPluginType::Lv2) {
-		qtractorPluginFactory *pPluginFactory
-			= static_cast<qtractorPluginFactory *> (QObject::parent());
-		if (pPluginFactory == NULL)
-			return false;
-		qtractorPluginType *pType
-			= qtractorLv2PluginType::createType(sFilename);
-		if (pType == NULL)
-			return false;
-		if (pType->open()) {
-			pPluginFactory->addType(pType);
-			pType->close();
-			// Cache out...
-			if (m_file.isOpen()) {
-				QTextStream sout(&m_file);
-				sout << "LV2|";
-				sout << pType->name() << '|';
-				sout << pType->audioIns()   << ':' << pType->audioOuts()   << '|';
-				sout << pType->midiIns()    << ':' << pType->midiOuts()    << '|';
-				sout << pType->controlIns() << ':' << pType->controlOuts() << '|';
-				QStringList flags;
-				if (pType->isEditor())
-					flags.append("GUI");
-				if (pType->isConfigure())
-					flags.append("EXT");
-				if (pType->isRealtime())
-					flags.append("RT");
-				sout << flags.join(",") << '|';
-				sout << sFilename << '|' << 0 << '|';
-				sout << "0x" << QString::number(pType->uniqueID(), 16) << '\n';
-			}
-			// Success.
+	const QByteArray& errs = pProcess->readAllStandardError();
+	if (!errs.isEmpty())
+		QTextStream(stderr) << errs;
+
+	while (pProcess->canReadLine()) {
+		const QString& sText
+			= QString::fromUtf8(pProcess->readLine()).simplified();
+		if (sText == c_sScanDone) {
+			doneJob(pJob, true);
 			return true;
-		} else {
-			// Fail.
-			delete pType;
-			return false;
 		}
+		if (!sText.isEmpty())
+			pJob->list.append(sText);
 	}
-#endif
 
-	// Not cached, yet...
-	const QString& sHint = qtractorPluginType::textFromHint(typeHint);
-	const QString& sLine = sHint + ':' + sFilename + '\n';
-	const QByteArray& data = sLine.toUtf8();
-	const bool bResult = (QProcess::write(data) == data.size());
-
-	// Check for hideous scan crashes...
-	if (!QProcess::waitForReadyRead(3000)) {
-		if (m_iExitStatus > 0) {
-			QProcess::waitForFinished(200);
-			start(); // Restart the crashed scan...
-			QProcess::waitForStarted(200);
+	// Check for hideous scan crashes or hangs
+	// (plain timeouts aren't blacklisted, though)...
+	const bool bCrashed = (pProcess->state() == QProcess::NotRunning);
+	if (bCrashed || pJob->time.elapsed() > c_iScanTimeout) {
+		doneJob(pJob, false, !bCrashed);
+		// Restart the crashed (or hung) scan...
+		if (!startJob(pJob)) {
+			m_jobs.removeAll(pJob);
+			delete pJob;
 		}
+		return true;
+	}
+
+	return false;
+}
+
+
+// Scan job completion.
+void qtractorPluginFactory::Scanner::doneJob (
+	Job *pJob, bool bResult, bool bRetry )
+{
+	if (bResult) {
+		addTypes(pJob->filename, pJob->stamp, pJob->list);
+	}
+	else
+	if (bRetry) {
+		QTextStream(stderr) << "qtractor_plugin_scan: "
+			<< pJob->filename << ": timed out (retry on next scan).\n";
+	} else {
+		QTextStream(stderr) << "qtractor_plugin_scan: "
+			<< pJob->filename << ": blacklisted.\n";
+		m_blacklist.insert(pJob->filename, pJob->stamp);
+		m_bBlacklistDirty = true;
 	}
 
-	return bResult;
+	pJob->filename.clear();
+	pJob->stamp.clear();
+	pJob->list.clear();
 }
 
 
-bool qtractorPluginFactory::Scanner::addTypes ( const QStringList& list )
+// Service methods (internal)
+void qtractorPluginFactory::Scanner::addTypes ( const QString& sFilename,
+	const QString& sStamp, const QStringList& list )
 {
 	qtractorPluginFactory *pPluginFactory
 		= static_cast<qtractorPluginFactory *> (QObject::parent());
 	if (pPluginFactory == NULL)
-		return false;
+		return;
+
+	Entry& entry = m_list[sFilename];
+	entry.stamp = sStamp;
+	entry.list.clear();
 
 	QStringListIterator iter(list);
 	while (iter.hasNext()) {
-		const QString& sText = iter.next().simplified();
-		if (sText.isEmpty())
-			continue;
+		const QString& sText = iter.next();
 		qtractorPluginType *pType = qtractorDummyPluginType::createType(sText);
 		if (pType) {
 			// Brand new type, add to inventory...
 			pPluginFactory->addType(pType);
 			// Cache in...
-			if (m_file.isOpen())
-				QTextStream(&m_file) << sText << "\n";
+			entry.list.append(sText);
 			// Done.
 		} else {
 			// Possibly some mistake occurred...
 			QTextStream(stderr) << sText + '\n';
 		}
 	}
+}
 
-	return true;
+
+#ifdef CONFIG_LV2
+
+void qtractorPluginFactory::Scanner::addLv2Types ( const QString& sFilename )
+{
+	qtractorPluginFactory *pPluginFactory
+		= static_cast<qtractorPluginFactory *> (QObject::parent());
+	if (pPluginFactory == NULL)
+		return;
+
+	qtractorPluginType *pType
+		= qtractorLv2PluginType::createType(sFilename);
+	if (pType == NULL)
+		return;
+
+	if (!pType->open()) {
+		delete pType;
+		return;
+	}
+
+	pPluginFactory->addType(pType);
+	pType->close();
+
+	// Cache out...
+	QString sText;
+	QTextStream sout(&sText);
+	sout << "LV2|";
+	sout << pType->name() << '|';
+	sout << pType->audioIns()   << ':' << pType->audioOuts()   << '|';
+	sout << pType->midiIns()    << ':' << pType->midiOuts()    << '|';
+	sout << pType->controlIns() << ':' << pType->controlOuts() << '|';
+	QStringList flags;
+	if (pType->isEditor())
+		flags.append("GUI");
+	if (pType->isConfigure())
+		flags.append("EXT");
+	if (pType->isRealtime())
+		flags.append("RT");
+	sout << flags.join(",") << '|';
+	sout << sFilename << '|' << 0 << '|';
+	sout << "0x" << QString::number(pType->uniqueID(), 16);
+	sout.flush();
+
+	Entry& entry = m_list[sFilename];
+	entry.stamp = fileStamp(sFilename);
+	entry.list.clear();
+	entry.list.append(sText);
 }
 
+#endif	// CONFIG_LV2
 
-// Absolute cache file path.
+
+// Cache file persistence, where each plugin file entry
+// is headed by a "#|filename|stamp" line...
+void qtractorPluginFactory::Scanner::readCache (void)
+{
+	m_cache.clear();
+	m_list.clear();
+
+	QFile file(cacheFilePath());
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+		return;
+
+	Entry *pEntry = NULL;
+
+	QTextStream sin(&file);
+	while (!sin.atEnd()) {
+		const QString& sText = sin.readLine();
+		if (sText.isEmpty())
+			continue;
+		const QStringList& props = sText.split('|');
+		if (props.at(0) == "#") {
+			pEntry = NULL;
+			if (props.count() > 2) {
+				pEntry = &m_cache[props.at(1)];
+				pEntry->stamp = props.at(2);
+			}
+		}
+		else
+		if (pEntry && props.count() > 6)
+			pEntry->list.append(sText);
+	}
+
+	file.close();
+}
+
+
+void qtractorPluginFactory::Scanner::writeCache (void)
+{
+	QFile file(cacheFilePath());
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate))
+		return;
+
+	QTextStream sout(&file);
+	Entries::ConstIterator iter = m_list.constBegin();
+	const Entries::ConstIterator& iter_end = m_list.constEnd();
+	for ( ; iter != iter_end; ++iter) {
+		const Entry& entry = iter.value();
+		sout << "#|" << iter.key() << '|' << entry.stamp << '\n';
+		QStringListIterator list_iter(entry.list);
+		while (list_iter.hasNext())
+			sout << list_iter.next() << '\n';
+	}
+	sout.flush();
+
+	file.close();
+}
+
+
+// Blacklist file persistence ("filename|stamp" lines).
+void qtractorPluginFactory::Scanner::readBlacklist (void)
+{
+	m_blacklist.clear();
+
+	QFile file(blacklistFilePath());
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+		return;
+
+	QTextStream sin(&file);
+	while (!sin.atEnd()) {
+		const QStringList& props = sin.readLine().split('|');
+		if (props.count() > 1)
+			m_blacklist.insert(props.at(0), props.at(1));
+	}
+
+	file.close();
+}
+
+
+void qtractorPluginFactory::Scanner::writeBlacklist (void)
+{
+	QFile file(blacklistFilePath());
+	if (m_blacklist.isEmpty()) {
+		file.remove();
+		return;
+	}
+
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate))
+		return;
+
+	QTextStream sout(&file);
+	QHash<QString, QString>::ConstIterator iter = m_blacklist.constBegin();
+	const QHash<QString, QString>::ConstIterator& iter_end = m_blacklist.constEnd();
+	for ( ; iter != iter_end; ++iter)
+		sout << iter.key() << '|' << iter.value() << '\n';
+	sout.flush();
+
+	file.close();
+}
+
+
+// Plugin file (modification) stamp (static).
+QString qtractorPluginFactory::Scanner::fileStamp ( const QString& sFilename )
+{
+	const QFileInfo info(sFilename);
+	if (!info.exists()) {
+	#ifdef CONFIG_LV2
+		// LV2 plugin URIs are not files: stamp their bundle instead,
+		// whichever changed last, the directory or its manifest...
+		const QString& sBundlePath
+			= qtractorLv2PluginType::lv2_bundle_path(sFilename);
+		if (!sBundlePath.isEmpty()) {
+			const QFileInfo bundle_info(sBundlePath);
+			const QFileInfo manifest_info(QDir(sBundlePath), "manifest.ttl");
+			QDateTime modified = bundle_info.lastModified();
+			if (manifest_info.exists()
+				&& modified < manifest_info.lastModified())
+				modified = manifest_info.lastModified();
+			if (modified.isValid())
+				return QString::number(modified.toMSecsSinceEpoch());
+		}
+	#endif
+		return QString();
+	}
+
+	return QString::number(info.size())
+		+ ':' + QString::number(info.lastModified().toMSecsSinceEpoch());
+}
+
+
+// Absolute cache file paths.
 QString qtractorPluginFactory::Scanner::cacheFilePath (void) const
 {
 	const QString& sCacheName = "qtractor_"
@@ -909,6 +1192,14 @@ QString qtractorPluginFactory::Scanner::cacheFilePath (void) const
 }
 
 
+QString qtractorPluginFactory::Scanner::blacklistFilePath (void) const
+{
+	const QFileInfo fi(cacheFilePath());
+	return QFileInfo(fi.dir(), fi.completeBaseName()
+		+ ".blacklist").absoluteFilePath();
+}
+
+
 //----------------------------------------------------------------------------
 // qtractorDummyPluginType -- Dummy plugin type instance.
 //
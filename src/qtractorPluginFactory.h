@@ -103,6 +103,9 @@ protected:
 	// Plugin scan reset method.
 	void reset();
 
+	// Scan progress feedback (per file).
+	void scanProgress();
+
 private:
 
 	// Instance variables.
@@ -127,6 +130,10 @@ private:
 	// List of active cache scan results.
 	QStringList m_cacheFilePaths;
 
+	// Scan progress counters.
+	int m_iScanFile;
+	int m_iScanFiles;
+
 	// Pseudo-singleton instance.
 	static qtractorPluginFactory *g_pPluginFactory;
 };
@@ -135,55 +142,96 @@ private:
 //----------------------------------------------------------------------------
 // qtractorPluginFactory::Scanner -- Plugin scan proxy (out-of-process client).
 //
+// Keeps a per-file stamped cache of scan results, so that only new or
+// modified plugin files get (re)scanned, by a pool of concurrent scan
+// processes; plugin files that crash or hang any of these are put on a
+// persistent blacklist, skipped until modified.
+//
 
-class qtractorPluginFactory::Scanner : public QProcess
+class qtractorPluginFactory::Scanner : public QObject
 {
-	Q_OBJECT
-
 public:
 
 	// ctor.
 	Scanner(qtractorPluginType::Hint typeHint, QObject *pParent = NULL);
 
+	// dtor.
+	~Scanner();
+
 	// Open/close method.
-	bool open(bool bReset = false);
+	bool open(int iJobs = 1);
 	void close();
 
 	// Service methods.
-	bool addTypes(qtractorPluginType::Hint typeHint, const QString& sFilename);
+	void addFiles(const QStringList& files);
 
-	// Absolute cache file path.
+	// Absolute cache file paths.
 	QString cacheFilePath() const;
+	QString blacklistFilePath() const;
 
-protected slots:
-
-	// Service slots.
-	void stdout_slot();
-	void stderr_slot();
+protected:
 
-	void exit_slot(int exitCode, QProcess::ExitStatus exitStatus);
+	// Scan job descriptor.
+	struct Job;
 
-protected:
+	// Scan job executives.
+	bool startJob(Job *pJob);
+	void writeJob(Job *pJob, const QString& sFilename);
+	bool readJob(Job *pJob);
+	void doneJob(Job *pJob, bool bResult, bool bRetry = false);
 
-	// Scan start method.
-	bool start();
+	// Scan jobs dispatcher.
+	void runJobs(QStringList& files);
 
 	// Service methods (internal)
-	bool addTypes(const QStringList& list);
+	void addTypes(const QString& sFilename,
+		const QString& sStamp, const QStringList& list);
+#ifdef CONFIG_LV2
+	void addLv2Types(const QString& sFilename);
+#endif
+
+	// Cache/blacklist file persistence.
+	void readCache();
+	void writeCache();
+
+	void readBlacklist();
+	void writeBlacklist();
+
+	// Plugin file (modification) stamp.
+	static QString fileStamp(const QString& sFilename);
 
 private:
 
 	// Instance scanner name.
 	qtractorPluginType::Hint m_typeHint;
 
-	// Instance state.
-	volatile int m_iExitStatus;
+	// Scanner executable path.
+	QString m_sScanner;
+
+	// Scan jobs pool.
+	int m_iJobs;
+
+	QList<Job *> m_jobs;
+
+	// Cache entry.
+	struct Entry
+	{
+		QString     stamp;
+		QStringList list;
+	};
+
+	typedef QHash<QString, Entry> Entries;
+
+	// Previous (on file) and current cache entries.
+	Entries m_cache;
+	Entries m_list;
+
+	bool m_bCacheDirty;
 
-	// Cache file object.
-	QFile m_file;
+	// Blacklisted files (and respective stamps).
+	QHash<QString, QString> m_blacklist;
 
-	// Cache hash list.
-	QHash<QString, QStringList> m_list;
+	bool m_bBlacklistDirty;
 };
 
 
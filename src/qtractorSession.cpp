@@ -29,6 +29,8 @@
 #include "qtractorAudioPeak.h"
 #include "qtractorAudioClip.h"
 #include "qtractorAudioBuffer.h"
+#include "qtractorAudioGraph.h"
+#include "qtractorAudioStretchCache.h"
 
 #include "qtractorMidiEngine.h"
 #include "qtractorMidiClip.h"
@@ -316,6 +318,9 @@ void qtractorSession::clear (void)
 
 	m_pAudioPeakFactory->cleanup();
 
+	qtractorAudioPageCache::getInstance()->clear();
+	qtractorAudioStretchCache::getInstance()->clear();
+
 	qtractorMidiControl *pMidiControl = qtractorMidiControl::getInstance();
 	if (pMidiControl)
 		pMidiControl->clearControlMap();
@@ -348,8 +353,11 @@ void qtractorSession::setSessionDir ( const QString& sSessionDir )
 {
 	QDir sdir(sSessionDir);
 
-	if (sdir.exists())
+	if (sdir.exists()) {
 		m_props.sessionDir = sdir.absolutePath();
+		// Take any time-stretch cache leftovers into account...
+		qtractorAudioStretchCache::getInstance()->scan(m_props.sessionDir);
+	}
 }
 
 const QString& qtractorSession::sessionDir (void) const
@@ -403,6 +411,8 @@ void qtractorSession::updateSession (
 	int i = 0;
 	for (qtractorTrack *pTrack = m_tracks.first();
 			pTrack; pTrack = pTrack->next()) {
+		// Keep clip interval indexes up-to-date...
+		pTrack->updateClipIndex();
 		for (qtractorClip *pClip = pTrack->clips().first();
 				pClip; pClip = pClip->next()) {
 			const unsigned long iClipStart = pClip->clipStart();
@@ -941,6 +951,7 @@ void qtractorSession::updateTrack ( qtractorTrack *pTrack )
 {
 //	lock();
 
+	pTrack->updateClipIndex();
 	pTrack->setLoop(m_iLoopStart, m_iLoopEnd);
 
 	qtractorSessionCursor *pSessionCursor = m_cursors.first();
@@ -1942,6 +1953,14 @@ void qtractorSession::process (
 {
 	const qtractorTrack::TrackType syncType = pSessionCursor->syncType();
 
+	// Parallel track processing, if applicable...
+	if (syncType == qtractorTrack::Audio) {
+		qtractorAudioGraph *pAudioGraph = m_pAudioEngine->audioGraph();
+		if (pAudioGraph
+			&& pAudioGraph->process(pSessionCursor, iFrameStart, iFrameEnd))
+			return;
+	}
+
 	// Now, for every track...
 	int iTrack = 0;
 	qtractorTrack *pTrack = m_tracks.first();
@@ -2426,6 +2445,7 @@ bool qtractorSession::saveElement (
 	pDocument->saveTextElement("edit-tail",
 		QString::number(qtractorSession::editTail()), &eView);
 	eTracks.appendChild(eView);
+	pElement->appendChild(eTracks);
 	// Save session tracks...
 	for (qtractorTrack *pTrack = qtractorSession::tracks().first();
 			pTrack; pTrack = pTrack->next()) {
@@ -2433,10 +2453,10 @@ bool qtractorSession::saveElement (
 		QDomElement eTrack = pDocument->document()->createElement("track");
 		if (!pTrack->saveElement(pDocument, &eTrack))
 			return false;
-		// Add this slot...
+		// Add this slot, and write it out right away...
 		eTracks.appendChild(eTrack);
+		pDocument->flushElement(&eTrack);
 	}
-	pElement->appendChild(eTracks);
 
 	return true;
 }
@@ -166,8 +166,9 @@ qtractorClip *qtractorSessionCursor::clip ( unsigned int iTrack ) const
 qtractorClip *qtractorSessionCursor::seekClip (
 	qtractorTrack *pTrack, qtractorClip *pClip, unsigned long iFrame ) const
 {
+	// Not seeking forward? Go for the track clip index...
 	if (pClip == NULL)
-		pClip = pTrack->clips().first();
+		return pTrack->seekClip(iFrame);
 
 	while (pClip && iFrame > pClip->clipStart() + pClip->clipLength()) {
 	//	if (pTrack->trackType() == m_syncType)
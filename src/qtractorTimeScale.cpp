@@ -27,6 +27,15 @@
 // class qtractorTimeScale -- Time scale conversion helper class.
 //
 
+// Destructor.
+qtractorTimeScale::~qtractorTimeScale (void)
+{
+	Snapshot *pSnapshot = qtractorEpoch::publish(m_pSnapshot, (Snapshot *) 0);
+	if (pSnapshot)
+		delete pSnapshot;
+}
+
+
 // Node list cleaner.
 void qtractorTimeScale::reset (void)
 {
@@ -467,6 +476,46 @@ void qtractorTimeScale::updateScale (void)
 
 	// Also update all marker/bar positions too...
 	updateMarkers(m_nodes.first());
+
+	// Publish the new tempo-map...
+	updateSnapshot();
+}
+
+
+// Publish a new tempo-map snapshot; the previous one is retired,
+// reclaimed only after the realtime readers have moved on.
+void qtractorTimeScale::updateSnapshot (void)
+{
+	qtractorEpoch::retire(qtractorEpoch::publish(m_pSnapshot,
+		new Snapshot(m_nodes, ++m_iSnapshotSerial)));
+}
+
+
+// Immutable tempo-map snapshot constructor.
+qtractorTimeScale::Snapshot::Snapshot (
+	const qtractorList<Node>& nodes, unsigned int iSerial )
+	: m_iSerial(iSerial), m_iCount(nodes.count()), m_pNodes(0)
+{
+	if (m_iCount > 0)
+		m_pNodes = new Node [m_iCount];
+
+	unsigned int i = 0;
+	Node *pNode = nodes.first();
+	while (pNode && i < m_iCount) {
+		Node *pNodeCopy = &m_pNodes[i++];
+		*pNodeCopy = *pNode;
+		pNodeCopy->setPrev(0);
+		pNodeCopy->setNext(0);
+		pNode = pNode->next();
+	}
+}
+
+
+// Immutable tempo-map snapshot destructor.
+qtractorTimeScale::Snapshot::~Snapshot (void)
+{
+	if (m_pNodes)
+		delete [] m_pNodes;
 }
 
 
@@ -704,10 +753,11 @@ QStringList qtractorTimeScale::snapItems ( int iSnap )
 unsigned long qtractorTimeScale::frameFromTickRange (
 	unsigned long iTickStart, unsigned long iTickEnd, bool bOffset )
 {
-	Node *pNode = m_cursor.seekTick(iTickStart);
+	SnapshotCursor cursor(this);
+	const Node *pNode = cursor.seekTick(iTickStart);
 	const unsigned long iFrameStart
 		= (pNode ? pNode->frameFromTick(iTickStart) : 0);
-	if (!bOffset) pNode = m_cursor.seekTick(iTickEnd);
+	if (!bOffset) pNode = cursor.seekTick(iTickEnd);
 	const unsigned long iFrameEnd
 		= (pNode ? pNode->frameFromTick(iTickEnd) : 0);
 	return (iFrameEnd > iFrameStart ? iFrameEnd - iFrameStart : 0);
@@ -717,10 +767,11 @@ unsigned long qtractorTimeScale::frameFromTickRange (
 unsigned long qtractorTimeScale::tickFromFrameRange (
 	unsigned long iFrameStart, unsigned long iFrameEnd, bool bOffset )
 {
-	Node *pNode = m_cursor.seekFrame(iFrameStart);
+	SnapshotCursor cursor(this);
+	const Node *pNode = cursor.seekFrame(iFrameStart);
 	const unsigned long iTickStart
 		= (pNode ? pNode->tickFromFrame(iFrameStart) : 0);
-	if (!bOffset) pNode = m_cursor.seekFrame(iFrameEnd);
+	if (!bOffset) pNode = cursor.seekFrame(iFrameEnd);
 	const unsigned long iTickEnd
 		= (pNode ? pNode->tickFromFrame(iFrameEnd) : 0);
 	return (iTickEnd > iTickStart ? iTickEnd - iTickStart : 0);
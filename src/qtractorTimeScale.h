@@ -23,6 +23,7 @@
 #define __qtractorTimeScale_h
 
 #include "qtractorList.h"
+#include "qtractorEpoch.h"
 
 #include <QStringList>
 #include <QColor>
@@ -41,11 +42,16 @@ public:
 
 	// Default constructor.
 	qtractorTimeScale() : m_displayFormat(Frames),
-		m_cursor(this), m_markerCursor(this) { clear(); }
+		m_cursor(this), m_pSnapshot(0),
+		m_iSnapshotSerial(0), m_markerCursor(this) { clear(); }
 
 	// Copy constructor.
 	qtractorTimeScale(const qtractorTimeScale& ts)
-		: m_cursor(this), m_markerCursor(this) { copy(ts); }
+		: m_cursor(this), m_pSnapshot(0),
+		m_iSnapshotSerial(0), m_markerCursor(this) { copy(ts); }
+
+	// Destructor.
+	~qtractorTimeScale();
 
 	// Assignment operator,
 	qtractorTimeScale& operator=(const qtractorTimeScale& ts)
@@ -110,7 +116,7 @@ public:
 	public:
 
 		// Constructor.
-		Node(qtractorTimeScale *pTimeScale,
+		Node(qtractorTimeScale *pTimeScale = 0,
 			unsigned long iFrame = 0,
 			float fTempo = 120.0f,
 			unsigned short iBeatType = 2,
@@ -280,7 +286,105 @@ public:
 	// Internal cursor accessor.
 	Cursor& cursor() { return m_cursor; }
 
-	// Node list specifics.
+	// Immutable (array-backed) tempo-map snapshot;
+	// a new one gets published on every updateScale().
+	class Snapshot : public qtractorEpoch::Item
+	{
+	public:
+
+		// Constructor.
+		Snapshot(const qtractorList<Node>& nodes, unsigned int iSerial);
+
+		// Destructor.
+		~Snapshot();
+
+		// Snapshot accessors.
+		unsigned int serial() const { return m_iSerial; }
+		unsigned int count() const { return m_iCount; }
+
+		const Node *node(unsigned int i) const { return &m_pNodes[i]; }
+
+		// Binary search node seekers (stateless).
+		const Node *seekFrame(unsigned long iFrame) const
+			{ return seek(&Node::frame, iFrame); }
+		const Node *seekTick(unsigned long iTick) const
+			{ return seek(&Node::tick, iTick); }
+
+		// Generic (last node at or before key) binary search;
+		// optional lower bound index must be already at or before.
+		template<typename T>
+		unsigned int indexOf(T Node::*key, T value,
+			unsigned int i = 0) const;
+
+		template<typename T>
+		const Node *seek(T Node::*key, T value) const
+			{ return (m_iCount > 0 ? &m_pNodes[indexOf(key, value)] : 0); }
+
+	private:
+
+		// Member variables.
+		unsigned int m_iSerial;
+		unsigned int m_iCount;
+		Node *m_pNodes;
+	};
+
+	// Current tempo-map snapshot (lock-free).
+	const Snapshot *snapshot() const
+		{ return qtractorEpoch::fetch(m_pSnapshot); }
+
+	// Realtime-safe (snapshot) cursor; each thread
+	// should own its own, as it keeps a position hint.
+	class SnapshotCursor
+	{
+	public:
+
+		// Constructor.
+		SnapshotCursor(qtractorTimeScale *pTimeScale)
+			: ts(pTimeScale), serial(0), index(0) {}
+
+		// Time scale accessor.
+		qtractorTimeScale *timeScale() const { return ts; }
+
+		// Reset method.
+		void reset() { serial = 0; index = 0; }
+
+		// Seek methods.
+		const Node *seekFrame(unsigned long iFrame)
+			{ return seek(&Node::frame, iFrame); }
+		const Node *seekBar(unsigned short iBar)
+			{ return seek(&Node::bar, iBar); }
+		const Node *seekBeat(unsigned int iBeat)
+			{ return seek(&Node::beat, iBeat); }
+		const Node *seekTick(unsigned long iTick)
+			{ return seek(&Node::tick, iTick); }
+
+		// Frame/tick convertors.
+		unsigned long tickFromFrame(unsigned long iFrame)
+		{
+			const Node *pNode = seekFrame(iFrame);
+			return (pNode ? pNode->tickFromFrame(iFrame) : 0);
+		}
+
+		unsigned long frameFromTick(unsigned long iTick)
+		{
+			const Node *pNode = seekTick(iTick);
+			return (pNode ? pNode->frameFromTick(iTick) : 0);
+		}
+
+	protected:
+
+		// Generic seeker.
+		template<typename T>
+		const Node *seek(T Node::*key, T value);
+
+		// Member variables.
+		qtractorTimeScale *ts;
+		unsigned int serial;
+		unsigned int index;
+	};
+
+	// Node list specifics (nb. changes only get
+	// published to realtime readers on updateScale).
 	Node *addNode(
 		unsigned long iFrame = 0,
 		float fTempo = 120.0f,
@@ -325,16 +429,18 @@ public:
 		return (pNode ? pNode->frameFromBeat(iBeat) : 0);
 	}
 
-	// Frame/tick general converters.
-	unsigned long tickFromFrame(unsigned long iFrame)
+	// Frame/tick general converters (realtime-safe).
+	unsigned long tickFromFrame(unsigned long iFrame) const
 	{
-		Node *pNode = m_cursor.seekFrame(iFrame);
+		const Snapshot *pSnapshot = snapshot();
+		const Node *pNode = (pSnapshot ? pSnapshot->seekFrame(iFrame) : 0);
 		return (pNode ? pNode->tickFromFrame(iFrame) : 0);
 	}
 
-	unsigned long frameFromTick(unsigned long iTick)
+	unsigned long frameFromTick(unsigned long iTick) const
 	{
-		Node *pNode = m_cursor.seekTick(iTick);
+		const Snapshot *pSnapshot = snapshot();
+		const Node *pNode = (pSnapshot ? pSnapshot->seekTick(iTick) : 0);
 		return (pNode ? pNode->frameFromTick(iTick) : 0);
 	}
 
@@ -557,6 +663,9 @@ public:
 
 protected:
 
+	// Publish a new tempo-map snapshot.
+	void updateSnapshot();
+
 	// Tempo-map independent coefficients.
 	float pixelRate() const { return m_fPixelRate; }
 	float frameRate() const { return m_fFrameRate; }
@@ -579,6 +688,11 @@ private:
 	// Internal node cursor.
 	Cursor m_cursor;
 
+	// Current tempo-map snapshot (previous ones get retired).
+	QAtomicPointer<Snapshot> m_pSnapshot;
+
+	unsigned int m_iSnapshotSerial;
+
 	// Tempo-map independent coefficients.
 	float m_fPixelRate;
 	float m_fFrameRate;
@@ -590,6 +704,50 @@ private:
 	MarkerCursor m_markerCursor;
 };
 
+
+// Generic (last node at or before key) binary search.
+template<typename T>
+inline unsigned int qtractorTimeScale::Snapshot::indexOf (
+	T qtractorTimeScale::Node::*key, T value, unsigned int i ) const
+{
+	unsigned int j = m_iCount;
+	while (i + 1 < j) {
+		const unsigned int k = ((i + j) >> 1);
+		if (m_pNodes[k].*key > value)
+			j = k;
+		else
+			i = k;
+	}
+	return i;
+}
+
+
+// Generic snapshot cursor seeker (hinted binary search).
+template<typename T>
+inline const qtractorTimeScale::Node *qtractorTimeScale::SnapshotCursor::seek (
+	T qtractorTimeScale::Node::*key, T value )
+{
+	const Snapshot *pSnapshot = ts->snapshot();
+	if (pSnapshot == 0 || pSnapshot->count() < 1)
+		return 0;
+
+	// Tempo-map has changed meanwhile?
+	if (serial != pSnapshot->serial() || index >= pSnapshot->count()) {
+		serial = pSnapshot->serial();
+		index = 0;
+	}
+
+	// Seek backward from start, or forward from current node...
+	if (pSnapshot->node(index)->*key > value)
+		index = pSnapshot->indexOf(key, value);
+	else
+	if (index + 1 < pSnapshot->count()
+		&& !(pSnapshot->node(index + 1)->*key > value))
+		index = pSnapshot->indexOf(key, value, index + 1);
+
+	return pSnapshot->node(index);
+}
+
 #endif	// __qtractorTimeScale_h
 
 
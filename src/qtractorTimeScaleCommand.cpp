@@ -97,6 +97,7 @@ bool qtractorTimeScaleNodeCommand::addNode (void)
 
 	pNode = m_pTimeScale->addNode(
 		m_iFrame, m_fTempo, m_iBeatType, m_iBeatsPerBar, m_iBeatDivisor);
+	m_pTimeScale->updateScale();
 
 	const bool bRedoCurveEditCommands = m_curveEditCommands.isEmpty();
 	if (bRedoCurveEditCommands) {
@@ -193,6 +194,7 @@ bool qtractorTimeScaleNodeCommand::updateNode (void)
 	pNode->beatDivisor = m_iBeatDivisor;
 
 	m_pTimeScale->updateNode(pNode);
+	m_pTimeScale->updateScale();
 
 	m_fTempo       = fTempo;
 	m_iBeatType    = iBeatType;
@@ -279,6 +281,7 @@ bool qtractorTimeScaleNodeCommand::removeNode (void)
 	m_iBeatDivisor = pNode->beatDivisor;
 
 	m_pTimeScale->removeNode(pNode);
+	m_pTimeScale->updateScale();
 
 	if (m_pClipCommand && bRedoClipCommand)
 		m_pClipCommand->redo();
@@ -521,6 +524,7 @@ bool qtractorTimeScaleMoveNodeCommand::redo (void)
 
 	pTimeScale->addNode(iNewFrame,
 		tempo(), beatType(), beatsPerBar(), beatDivisor());
+	pTimeScale->updateScale();
 
 	m_iNewFrame = iOldFrame;
 	m_iOldFrame = iNewFrame;
@@ -540,6 +544,7 @@ bool qtractorTimeScaleMoveNodeCommand::undo (void)
 	if (bResult && m_bOldNode) {
 		pTimeScale->addNode(m_iNewFrame, m_fOldTempo,
 			m_iOldBeatType, m_iOldBeatsPerBar, m_iOldBeatDivisor);
+		pTimeScale->updateScale();
 	}
 
 	return bResult;
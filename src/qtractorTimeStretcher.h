@@ -39,7 +39,8 @@ class qtractorTimeStretcher
 public:
 
 	// Constructor flags.
-	enum Flags { None = 0, WsolaTimeStretch = 1, WsolaQuickSeek = 2 };
+	enum Flags { None = 0, WsolaTimeStretch = 1, WsolaQuickSeek = 2,
+		WsolaFastSeek = 4 };
 
 	// Constructor.
 	qtractorTimeStretcher(
@@ -39,6 +39,7 @@
 #include "qtractorMixer.h"
 #include "qtractorMeter.h"
 #include "qtractorCurveFile.h"
+#include "qtractorEpoch.h"
 
 #include "qtractorTrackCommand.h"
 
@@ -328,6 +329,8 @@ qtractorTrack::qtractorTrack ( qtractorSession *pSession, TrackType trackType )
 
 	m_pSyncThread = NULL;
 
+	m_ppMixBuffer = NULL;
+
 	m_pMidiVolumeObserver  = NULL;
 	m_pMidiPanningObserver = NULL;
 
@@ -369,6 +372,8 @@ qtractorTrack::~qtractorTrack (void)
 	close();
 	clear();
 
+	setClipIndexDirty();
+
 	if (m_pSoloObserver)
 		delete m_pSoloObserver;
 	if (m_pMuteObserver)
@@ -406,6 +411,7 @@ void qtractorTrack::clear (void)
 
 	clearTakeInfo();
 	m_clips.clear();
+	setClipIndexDirty();
 
 	m_pPluginList->clear();
 	m_pCurveFile->clear();
@@ -422,12 +428,7 @@ void qtractorTrack::clear (void)
 	m_props.panning = 0.0f;
 
 	if (m_pSyncThread) {
-		if (m_pSyncThread->isRunning()) do {
-			m_pSyncThread->setRunState(false);
-		//	m_pSyncThread->terminate();
-			m_pSyncThread->sync();
-		} while (!m_pSyncThread->wait(100));
-		delete m_pSyncThread;
+		qtractorAudioBufferThread::releaseSyncThread(m_pSyncThread);
 		m_pSyncThread = NULL;
 	}
 }
@@ -1147,11 +1148,15 @@ void qtractorTrack::insertClip ( qtractorClip *pClip )
 		m_clips.insertBefore(pClip, pNextClip);
 	else
 		m_clips.append(pClip);
+
+	setClipIndexDirty();
 }
 
 
 void qtractorTrack::unlinkClip ( qtractorClip *pClip )
 {
+	setClipIndexDirty();
+
 	m_clips.unlink(pClip);
 }
 
@@ -1164,6 +1169,92 @@ void qtractorTrack::removeClip ( qtractorClip *pClip )
 }
 
 
+// Clip interval index snapshot.
+struct qtractorTrack::ClipIndex : public qtractorEpoch::Item
+{
+	ClipIndex(const qtractorList<qtractorClip>& list)
+	{
+		count = list.count();
+		clips = new qtractorClip * [count];
+		ends = new unsigned long [count];
+		unsigned long iMaxEnd = 0;
+		unsigned int i = 0;
+		qtractorClip *pClip = list.first();
+		for ( ; pClip && i < count; pClip = pClip->next(), ++i) {
+			const unsigned long iClipEnd
+				= pClip->clipStart() + pClip->clipLength();
+			if (iMaxEnd < iClipEnd)
+				iMaxEnd = iClipEnd;
+			clips[i] = pClip;
+			ends[i] = iMaxEnd;
+		}
+		count = i;
+	}
+
+	~ClipIndex()
+	{
+		delete [] ends;
+		delete [] clips;
+	}
+
+	unsigned int   count;
+	qtractorClip **clips;
+	unsigned long *ends;    // running maximum of clip ends.
+};
+
+
+// Clip interval index look-up (RT-safe).
+qtractorClip *qtractorTrack::seekClip ( unsigned long iFrame ) const
+{
+	const ClipIndex *pClipIndex = qtractorEpoch::fetch(m_pClipIndex);
+	if (pClipIndex) {
+		const unsigned int n = pClipIndex->count;
+		if (n < 1)
+			return NULL;
+		// Clips are sorted by start, so the running maximum of
+		// their ends is monotonic: just find the first one that
+		// ends at or after the target frame position...
+		unsigned int lo = 0, hi = n;
+		while (lo < hi) {
+			const unsigned int mid = (lo + hi) >> 1;
+			if (pClipIndex->ends[mid] < iFrame)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		return pClipIndex->clips[lo < n ? lo : n - 1];
+	}
+
+	// Index not up-to-date, do it the old linear way...
+	qtractorClip *pClip = m_clips.first();
+	while (pClip && iFrame > pClip->clipStart() + pClip->clipLength())
+		pClip = pClip->next();
+
+	if (pClip == NULL)
+		pClip = m_clips.last();
+
+	return pClip;
+}
+
+
+// Clip interval index maintenance (non RT-safe).
+void qtractorTrack::setClipIndexDirty (void)
+{
+	qtractorEpoch::retire(
+		qtractorEpoch::publish(m_pClipIndex, (ClipIndex *) NULL));
+}
+
+void qtractorTrack::updateClipIndex (void)
+{
+	if (qtractorEpoch::fetch(m_pClipIndex))
+		return;
+
+	// Publish the new one, retire the previous...
+	qtractorEpoch::retire(
+		qtractorEpoch::publish(m_pClipIndex, new ClipIndex(m_clips)));
+}
+
+
 // Current clip on record (capture).
 void qtractorTrack::setClipRecord ( qtractorClip *pClipRecord )
 {
@@ -1318,7 +1409,8 @@ void qtractorTrack::resetProperties (void)
 
 // Track special process cycle executive.
 void qtractorTrack::process ( qtractorClip *pClip,
-	unsigned long iFrameStart, unsigned long iFrameEnd )
+	unsigned long iFrameStart, unsigned long iFrameEnd,
+	float **ppXBuffer, float **ppYBuffer )
 {
 	// Audio-buffers needs some preparation...
 	const unsigned int nframes = iFrameEnd - iFrameStart;
@@ -1331,7 +1423,14 @@ void qtractorTrack::process ( qtractorClip *pClip,
 		if (pOutputBus) {
 			qtractorAudioBus *pInputBus = (m_pSession->isTrackMonitor(this)
 				? static_cast<qtractorAudioBus *> (m_pInputBus) : NULL);
-			pOutputBus->buffer_prepare(nframes, pInputBus);
+			if (ppXBuffer && ppYBuffer) {
+				pOutputBus->buffer_prepare(
+					ppXBuffer, ppYBuffer, nframes, pInputBus);
+				m_ppMixBuffer = ppYBuffer;
+			} else {
+				pOutputBus->buffer_prepare(nframes, pInputBus);
+				m_ppMixBuffer = pOutputBus->buffer();
+			}
 		}
 	}
 
@@ -1347,25 +1446,20 @@ void qtractorTrack::process ( qtractorClip *pClip,
 
 	// Audio buffers needs monitoring and commitment...
 	if (pAudioMonitor && pOutputBus) {
-		// Plugin chain post-processing...
-		m_pPluginList->process(pOutputBus->buffer(), nframes);
-		// Monitor passthru...
-		pAudioMonitor->process(pOutputBus->buffer(), nframes);
-		// Actually render it...
-		pOutputBus->buffer_commit(nframes);
+		// Plugin chain post-processing and monitor passthru...
+		process_post(pAudioMonitor, m_ppMixBuffer, iFrameStart, nframes);
+		// Actually render it (unless deferred)...
+		if (ppXBuffer == NULL)
+			pOutputBus->buffer_commit(nframes);
 	}
 }
 
 
 // Freewheeling process cycle executive (needed for export).
 void qtractorTrack::process_export ( qtractorClip *pClip,
-	unsigned long iFrameStart, unsigned long iFrameEnd )
+	unsigned long iFrameStart, unsigned long iFrameEnd,
+	float **ppXBuffer, float **ppYBuffer )
 {
-	// Track automation processing...
-	qtractorCurveList *pCurveList = curveList();
-	if (pCurveList && pCurveList->isProcess())
-		pCurveList->process(iFrameStart);
-
 	// Audio-buffers needs some preparation...
 	const unsigned int nframes = iFrameEnd - iFrameStart;
 	qtractorAudioMonitor *pAudioMonitor = NULL;
@@ -1373,8 +1467,15 @@ void qtractorTrack::process_export ( qtractorClip *pClip,
 	if (m_props.trackType == qtractorTrack::Audio) {
 		pAudioMonitor = static_cast<qtractorAudioMonitor *> (m_pMonitor);
 		pOutputBus = static_cast<qtractorAudioBus *> (m_pOutputBus);
-		if (pOutputBus)
-			pOutputBus->buffer_prepare(nframes);
+		if (pOutputBus) {
+			if (ppXBuffer && ppYBuffer) {
+				pOutputBus->buffer_prepare(ppXBuffer, ppYBuffer, nframes);
+				m_ppMixBuffer = ppYBuffer;
+			} else {
+				pOutputBus->buffer_prepare(nframes);
+				m_ppMixBuffer = pOutputBus->buffer();
+			}
+		}
 	}
 
 	// Playback...
@@ -1389,12 +1490,59 @@ void qtractorTrack::process_export ( qtractorClip *pClip,
 
 	// Audio buffers needs monitoring and commitment...
 	if (pAudioMonitor && pOutputBus) {
-		// Plugin chain post-processing...
-		m_pPluginList->process(pOutputBus->buffer(), nframes);
-		// Monitor passthru...
-		pAudioMonitor->process(pOutputBus->buffer(), nframes);
-		// Actually render it...
-		pOutputBus->buffer_commit(nframes);
+		// Plugin chain post-processing and monitor passthru...
+		process_post(pAudioMonitor, m_ppMixBuffer, iFrameStart, nframes);
+		// Actually render it (unless deferred)...
+		if (ppXBuffer == NULL)
+			pOutputBus->buffer_commit(nframes);
+	}
+}
+
+
+// Plugin chain post-processing and monitor passthru;
+// automation gets rendered in sub-blocks, when changing.
+void qtractorTrack::process_post ( qtractorAudioMonitor *pAudioMonitor,
+	float **ppBuffer, unsigned long iFrameStart, unsigned int nframes )
+{
+	const unsigned int iSubBlock = qtractorCurveList::subBlockSize();
+
+	qtractorCurveList *pCurveList = curveList();
+	if (iSubBlock == 0 || nframes <= iSubBlock
+		|| pCurveList == NULL || !pCurveList->isProcess()
+		|| m_pPluginList->midiManager() != NULL
+		|| !m_pPluginList->isSubBlockSafe()
+		|| pCurveList->updateActive(iFrameStart, iFrameStart + nframes) < 1) {
+		// Plain whole period processing...
+		m_pPluginList->process(ppBuffer, nframes);
+		pAudioMonitor->process(ppBuffer, nframes);
+		return;
+	}
+
+	// Monitor gain/panning gets no observer notification from
+	// here (realtime), so it must be updated explicitly...
+	qtractorCurve *pGainCurve = pAudioMonitor->gainSubject()->curve();
+	qtractorCurve *pPanningCurve = pAudioMonitor->panningSubject()->curve();
+	const bool bMonitorActive
+		= (pGainCurve && pGainCurve->isActive())
+		|| (pPanningCurve && pPanningCurve->isActive());
+
+	const unsigned short iChannels = m_pPluginList->channels();
+
+	unsigned int iOffset = 0;
+	while (iOffset < nframes) {
+		unsigned int n = nframes - iOffset;
+		if (n > iSubBlock)
+			n = iSubBlock;
+		// Current sub-block automation...
+		pCurveList->processActive(iFrameStart + iOffset);
+		if (bMonitorActive)
+			pAudioMonitor->update();
+		float **ppSubBuffer = m_pPluginList->subBuffer(ppBuffer, iOffset);
+		if (ppSubBuffer == NULL)
+			ppSubBuffer = ppBuffer; // Should never happen.
+		m_pPluginList->process(ppSubBuffer, n);
+		pAudioMonitor->process(ppSubBuffer, n, iChannels);
+		iOffset += n;
 	}
 }
 
@@ -1581,8 +1729,8 @@ void qtractorTrack::updateClipEditors (void)
 qtractorAudioBufferThread *qtractorTrack::syncThread (void)
 {
 	if (m_pSyncThread == NULL) {
-		m_pSyncThread = new qtractorAudioBufferThread();
-		m_pSyncThread->start(QThread::HighPriority);
+		m_pSyncThread = qtractorAudioBufferThread::acquireSyncThread();
+		m_pSyncThread->checkSyncSize(m_clips.count());
 	} else {
 		m_pSyncThread->checkSyncSize(m_clips.count());
 	}
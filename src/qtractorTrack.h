@@ -27,6 +27,7 @@
 #include "qtractorMidiControl.h"
 
 #include <QColor>
+#include <QAtomicPointer>
 
 
 // Forward declarations.
@@ -35,6 +36,7 @@ class qtractorDocument;
 class qtractorInstrumentList;
 class qtractorPluginList;
 class qtractorMonitor;
+class qtractorAudioMonitor;
 class qtractorClip;
 class qtractorBus;
 
@@ -190,6 +192,15 @@ public:
 	void unlinkClip(qtractorClip *pClip);
 	void removeClip(qtractorClip *pClip);
 
+	// Clip interval index: first clip not ending before the given
+	// frame (or the last one), binary searched (RT-safe) whenever
+	// the index is up-to-date, otherwise walked the linear way.
+	qtractorClip *seekClip(unsigned long iFrame) const;
+
+	// Clip interval index maintenance (non RT-safe).
+	void setClipIndexDirty();
+	void updateClipIndex();
+
 	// Current clip on record (capture).
 	void setClipRecord(qtractorClip *pClipRecord);
 	qtractorClip *clipRecord() const;
@@ -213,13 +224,21 @@ public:
 	// Generate a default track color.
 	static QColor trackColor(int iTrack);
 
-	// Track special process cycle executive.
+	// Track special process cycle executive;
+	// optional private mix-down (scratch) buffers
+	// are committed later by the caller, if given.
 	void process(qtractorClip *pClip,
-		unsigned long iFrameStart, unsigned long iFrameEnd);
+		unsigned long iFrameStart, unsigned long iFrameEnd,
+		float **ppXBuffer = NULL, float **ppYBuffer = NULL);
 
-	// Track freewheeling process cycle executive (needed for export).
+	// Current audio mix-down buffer (process cycle only).
+	float **mixBuffer() const { return m_ppMixBuffer; }
+
+	// Track freewheeling process cycle executive (needed for export);
+	// optional private mix-down buffers, as with process() above.
 	void process_export(qtractorClip *pClip,
-		unsigned long iFrameStart, unsigned long iFrameEnd);
+		unsigned long iFrameStart, unsigned long iFrameEnd,
+		float **ppXBuffer = NULL, float **ppYBuffer = NULL);
 
 	// Track special process record executive (audio recording only).
 	void process_record(
@@ -354,6 +373,13 @@ public:
 	void updateTrack();
 	void updateMidiTrack();
 
+protected:
+
+	// Plugin chain post-processing and monitor passthru
+	// (sub-block automation aware).
+	void process_post(qtractorAudioMonitor *pAudioMonitor,
+		float **ppBuffer, unsigned long iFrameStart, unsigned int nframes);
+
 private:
 
 	qtractorSession *m_pSession;    // Session reference.
@@ -375,6 +401,12 @@ private:
 
 	qtractorList<qtractorClip> m_clips; // List of clips.
 
+	// Clip interval index (array-backed, immutable snapshots;
+	// published atomically, null when dirty).
+	struct ClipIndex;
+
+	QAtomicPointer<ClipIndex> m_pClipIndex;
+
 	qtractorClip *m_pClipRecord;        // Current clip on record (capture).
 	unsigned long m_iClipRecordStart;   // Current clip on record start frame.
 
@@ -385,6 +417,9 @@ private:
 	// Audio buffer ring-cache (playlist).
 	qtractorAudioBufferThread *m_pSyncThread;
 
+	// Current audio mix-down buffer (process cycle only).
+	float **m_ppMixBuffer;
+
 	// MIDI track/channel (volume, panning) observers.
 	class MidiVolumeObserver;
 	class MidiPanningObserver;
@@ -313,9 +313,11 @@ void qtractorTrackForm::setTrack ( qtractorTrack *pTrack )
 	// Track properties cloning...
 	m_props = m_pTrack->properties();
 
-	// Get reference of the last acceptable command...
+	// Get reference of the last acceptable command
+	// (and make sure it stays there, for any backout)...
 	qtractorCommandList *pCommands = (m_pTrack->session())->commands();
 	m_pLastCommand = pCommands->lastCommand();
+	pCommands->pin(m_pLastCommand);
 
 	// Set plugin list...
 	m_ui.PluginListView->setPluginList(m_pTrack->pluginList());
@@ -454,6 +456,10 @@ void qtractorTrackForm::accept (void)
 		m_iDirtyCount = 0;
 	}
 
+	// Release the backout mark...
+	if (m_pTrack)
+		((m_pTrack->session())->commands())->unpin();
+
 	// Just go with dialog acceptance.
 	QDialog::accept();
 }
@@ -490,7 +496,9 @@ void qtractorTrackForm::reject (void)
 		// Bogus track? Unlikely, but...
 		if (m_pTrack) {
 			// Backout all commands made this far...
-			((m_pTrack->session())->commands())->backout(m_pLastCommand);
+			qtractorCommandList *pCommands = (m_pTrack->session())->commands();
+			pCommands->backout(m_pLastCommand);
+			pCommands->unpin();
 			// Restore old output bus...
 			if (!m_sOldOutputBusName.isEmpty()) {
 				m_pTrack->setOutputBusName(m_sOldOutputBusName);
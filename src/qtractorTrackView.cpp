@@ -81,6 +81,13 @@
 // Follow-playhead: maximum iterations on hold.
 #define QTRACTOR_SYNC_VIEW_HOLD 46
 
+// Track lane tile width and cache limit (in pixels).
+static const int c_iTileWidth = 256;
+static const int c_iTileCacheMax = (16 << 20);
+
+// Track lane tile overdraw margin (in pixels).
+static const int c_iTileMargin = 16;
+
 
 //----------------------------------------------------------------------------
 // qtractorTrackView::ClipBoard - Local clipaboard singleton.
@@ -104,6 +111,11 @@ qtractorTrackView::qtractorTrackView ( qtractorTracks *pTracks,
 	m_pSessionCursor = NULL;
 	m_pRubberBand    = NULL;
 
+	// Track lane tile cache limit (in pixels).
+	m_tiles.setMaxCost(c_iTileCacheMax);
+	m_iTileGeneration = 0;
+	m_bScrolling = false;
+
 	m_selectMode = SelectClip;
 
 	m_bDropSpan  = true;
@@ -236,6 +248,8 @@ void qtractorTrackView::clear (void)
 		delete m_pSessionCursor;
 	m_pSessionCursor = NULL;
 
+	m_tiles.clear();
+
 	if (m_pRubberBand)
 		delete m_pRubberBand;
 	m_pRubberBand = NULL;
@@ -358,6 +372,8 @@ void qtractorTrackView::updateContentsWidth ( int iContentsWidth )
 // Local rectangular contents update.
 void qtractorTrackView::updateContents ( const QRect& rect )
 {
+	invalidateTiles(rect);
+
 	updatePixmap(
 		qtractorScrollView::contentsX(), qtractorScrollView::contentsY());
 
@@ -368,6 +384,10 @@ void qtractorTrackView::updateContents ( const QRect& rect )
 // Overall contents update.
 void qtractorTrackView::updateContents (void)
 {
+	// Just scrolling around? keep the tiles...
+	if (!m_bScrolling)
+		invalidateTiles();
+
 	updatePixmap(
 		qtractorScrollView::contentsX(), qtractorScrollView::contentsY());
 
@@ -375,6 +395,15 @@ void qtractorTrackView::updateContents (void)
 }
 
 
+// Scroll area updater (override).
+void qtractorTrackView::scrollContentsBy ( int dx, int dy )
+{
+	m_bScrolling = true;
+	qtractorScrollView::scrollContentsBy(dx, dy);
+	m_bScrolling = false;
+}
+
+
 // Special recording visual feedback.
 void qtractorTrackView::updateContentsRecord (void)
 {
@@ -870,8 +899,9 @@ void qtractorTrackView::updatePixmap ( int cx, int cy )
 		return;
 
 	const QColor& rgbMid = pal.mid().color();
-	
-	m_pixmap = QPixmap(w, h);
+
+	if (m_pixmap.width() != w || m_pixmap.height() != h)
+		m_pixmap = QPixmap(w, h);
 	m_pixmap.fill(rgbMid);
 
 	qtractorSession *pSession = qtractorSession::getInstance();
@@ -888,7 +918,6 @@ void qtractorTrackView::updatePixmap ( int cx, int cy )
 	// Update view session cursor location,
 	// so that we'll start drawing clips from there...
 	const unsigned long iTrackStart = pTimeScale->frameFromPixel(cx);
-	const unsigned long iTrackEnd   = iTrackStart + pTimeScale->frameFromPixel(w);
 	// Create cursor now if applicable...
 	if (m_pSessionCursor == NULL) {
 		m_pSessionCursor = pSession->createSessionCursor(iTrackStart);
@@ -899,40 +928,9 @@ void qtractorTrackView::updatePixmap ( int cx, int cy )
 	const QColor& rgbLight = pal.midlight().color();
 	const QColor& rgbDark  = rgbMid.darker(120);
 
-	// Draw vertical grid lines...
-	if (m_bSnapGrid || m_bSnapZebra) {
-		const QBrush zebra(QColor(0, 0, 0, 20));
-		qtractorTimeScale::Cursor cursor(pTimeScale);
-		qtractorTimeScale::Node *pNode = cursor.seekPixel(cx);
-		unsigned short iPixelsPerBeat = pNode->pixelsPerBeat();
-		unsigned int iBeat = pNode->beatFromPixel(cx);
-		if (iBeat > 0) pNode = cursor.seekBeat(--iBeat);
-		unsigned short iBar = pNode->barFromBeat(iBeat);
-		int x = pNode->pixelFromBeat(iBeat) - cx;
-		int x2 = x;
-		while (x < w) {
-			bool bBeatIsBar = pNode->beatIsBar(iBeat);
-			if (bBeatIsBar) {
-				if (m_bSnapGrid) {
-					painter.setPen(rgbLight);
-					painter.drawLine(x, 0, x, h);
-				}
-				if (m_bSnapZebra && (x > x2) && (++iBar & 1))
-					painter.fillRect(QRect(x2, 0, x - x2 + 1, h), zebra);
-				x2 = x;
-				if (iBeat == pNode->beat)
-					iPixelsPerBeat = pNode->pixelsPerBeat();
-			}
-			if (m_bSnapGrid && (bBeatIsBar || iPixelsPerBeat > 16)) {
-				painter.setPen(rgbDark);
-				painter.drawLine(x - 1, 0, x - 1, h);
-			}
-			pNode = cursor.seekBeat(++iBeat);
-			x = pNode->pixelFromBeat(iBeat) - cx;
-		}
-		if (m_bSnapZebra && (x > x2) && (++iBar & 1))
-			painter.fillRect(QRect(x2, 0, x - x2 + 1, h), zebra);
-	}
+	// Visible tile columns...
+	const int iColumn1 = cx / c_iTileWidth;
+	const int iColumn2 = (cx + w) / c_iTileWidth;
 
 	// Draw track and horizontal lines...
 	int y1, y2;
@@ -943,15 +941,20 @@ void qtractorTrackView::updatePixmap ( int cx, int cy )
 		y1  = y2;
 		y2 += pTrack->zoomHeight();
 		if (y2 > cy) {
-			// Dispatch to paint this track...
+			// Dispatch to paint this track, tile by tile...
 			if (y1 > cy) {
 				painter.setPen(rgbLight);
 				painter.drawLine(0, y1 - cy, w, y1 - cy);
 			}
-			const QRect trackRect(0, y1 - cy + 1, w, y2 - y1 - 2);
-		//	painter.fillRect(trackRect, rgbMid);
-			pTrack->drawTrack(&painter, trackRect, iTrackStart, iTrackEnd,
-				m_pSessionCursor->clip(iTrack));
+			const int th = y2 - y1 - 2;
+			if (th > 0) {
+				qtractorClip *pClip = m_pSessionCursor->clip(iTrack);
+				for (int iColumn = iColumn1; iColumn <= iColumn2; ++iColumn) {
+					const int x = iColumn * c_iTileWidth - cx;
+					painter.drawPixmap(x, y1 - cy + 1,
+						trackTile(pTrack, (x < 0 ? NULL : pClip), iColumn, th));
+				}
+			}
 			painter.setPen(rgbDark);
 			painter.drawLine(0, y2 - cy - 1, w, y2 - cy - 1);
 		}
@@ -1023,6 +1026,159 @@ void qtractorTrackView::updatePixmap ( int cx, int cy )
 }
 
 
+// Draw vertical grid lines (from contents x position).
+void qtractorTrackView::drawGrid (
+	QPainter *pPainter, int cx, int w, int h ) const
+{
+	if (!m_bSnapGrid && !m_bSnapZebra)
+		return;
+
+	qtractorSession *pSession = qtractorSession::getInstance();
+	if (pSession == NULL)
+		return;
+
+	qtractorTimeScale *pTimeScale = pSession->timeScale();
+	if (pTimeScale == NULL)
+		return;
+
+	const QPalette& pal = qtractorScrollView::palette();
+	const QColor& rgbLight = pal.midlight().color();
+	const QColor& rgbDark  = pal.mid().color().darker(120);
+
+	const QBrush zebra(QColor(0, 0, 0, 20));
+	qtractorTimeScale::Cursor cursor(pTimeScale);
+	qtractorTimeScale::Node *pNode = cursor.seekPixel(cx);
+	unsigned short iPixelsPerBeat = pNode->pixelsPerBeat();
+	unsigned int iBeat = pNode->beatFromPixel(cx);
+	if (iBeat > 0) pNode = cursor.seekBeat(--iBeat);
+	unsigned short iBar = pNode->barFromBeat(iBeat);
+	int x = pNode->pixelFromBeat(iBeat) - cx;
+	int x2 = x;
+	while (x < w) {
+		bool bBeatIsBar = pNode->beatIsBar(iBeat);
+		if (bBeatIsBar) {
+			if (m_bSnapGrid) {
+				pPainter->setPen(rgbLight);
+				pPainter->drawLine(x, 0, x, h);
+			}
+			if (m_bSnapZebra && (x > x2) && (++iBar & 1))
+				pPainter->fillRect(QRect(x2, 0, x - x2 + 1, h), zebra);
+			x2 = x;
+			if (iBeat == pNode->beat)
+				iPixelsPerBeat = pNode->pixelsPerBeat();
+		}
+		if (m_bSnapGrid && (bBeatIsBar || iPixelsPerBeat > 16)) {
+			pPainter->setPen(rgbDark);
+			pPainter->drawLine(x - 1, 0, x - 1, h);
+		}
+		pNode = cursor.seekBeat(++iBeat);
+		x = pNode->pixelFromBeat(iBeat) - cx;
+	}
+	if (m_bSnapZebra && (x > x2) && (++iBar & 1))
+		pPainter->fillRect(QRect(x2, 0, x - x2 + 1, h), zebra);
+}
+
+
+// Track lane tile cache: get a (cached) track lane tile,
+// rendering it anew when missing or out-of-date.
+const QPixmap& qtractorTrackView::trackTile ( qtractorTrack *pTrack,
+	qtractorClip *pClip, int iColumn, int h )
+{
+	qtractorSession *pSession = pTrack->session();
+	qtractorTimeScale *pTimeScale = pSession->timeScale();
+
+	// Anything else that changes the lane looks...
+	const bool bShade = (pTrack->isMute()
+		|| (!pTrack->isSolo() && pSession->soloTracks()));
+	const unsigned int iFlags = (m_bSnapGrid ? 0x01 : 0)
+		| (m_bSnapZebra ? 0x02 : 0)
+		| (bShade ? 0x04 : 0)
+		| (pTrack->isClipRecordEx() ? 0x08 : 0);
+
+	const unsigned short iZoom = pTimeScale->horizontalZoom();
+	const unsigned short iPixelsPerBeat = pTimeScale->pixelsPerBeat();
+	const QRgb color = pTrack->background().rgba();
+
+	const TileKey key(pTrack, iColumn);
+	Tile *pTile = m_tiles.object(key);
+	if (pTile
+		&& pTile->generation == m_iTileGeneration
+		&& pTile->zoom   == iZoom
+		&& pTile->ppb    == iPixelsPerBeat
+		&& pTile->color  == color
+		&& pTile->height == h
+		&& pTile->flags  == iFlags)
+		return pTile->pixmap;
+
+	// Render it anew...
+	const int cx = iColumn * c_iTileWidth;
+	const int w = c_iTileWidth;
+
+	pTile = new Tile;
+	pTile->generation = m_iTileGeneration;
+	pTile->zoom   = iZoom;
+	pTile->ppb    = iPixelsPerBeat;
+	pTile->color  = color;
+	pTile->height = h;
+	pTile->flags  = iFlags;
+	pTile->pixmap = QPixmap(w, h);
+	pTile->pixmap.fill(qtractorScrollView::palette().mid().color());
+
+	QPainter painter(&pTile->pixmap);
+	painter.initFrom(this);
+	drawGrid(&painter, cx, w, h);
+
+	// Clips are drawn past the tile edges, clipped to the tile,
+	// so that their frames and contents show no seams in between.
+	const int x1 = (cx > c_iTileMargin ? cx - c_iTileMargin : 0);
+	const int x2 = cx + w + c_iTileMargin;
+	const unsigned long iTrackStart = pTimeScale->frameFromPixel(x1);
+	const unsigned long iTrackEnd   = pTimeScale->frameFromPixel(x2);
+	painter.setClipRect(0, 0, w, h);
+	painter.translate(x1 - cx, 0);
+	pTrack->drawTrack(&painter, QRect(0, 0, x2 - x1, h),
+		iTrackStart, iTrackEnd, pClip);
+
+	painter.end();
+
+	m_tiles.insert(key, pTile, w * h);
+
+	return pTile->pixmap;
+}
+
+
+// Track lane tile cache: discard tiles under contents rectangle.
+void qtractorTrackView::invalidateTiles ( const QRect& rect )
+{
+	qtractorSession *pSession = qtractorSession::getInstance();
+	if (pSession == NULL)
+		return;
+
+	const int iColumn1 = rect.left() / c_iTileWidth;
+	const int iColumn2 = rect.right() / c_iTileWidth;
+
+	int y1, y2;
+	y1 = y2 = 0;
+	qtractorTrack *pTrack = pSession->tracks().first();
+	while (pTrack && y2 <= rect.bottom()) {
+		y1  = y2;
+		y2 += pTrack->zoomHeight();
+		if (y2 > rect.top()) {
+			for (int iColumn = iColumn1; iColumn <= iColumn2; ++iColumn)
+				m_tiles.remove(TileKey(pTrack, iColumn));
+		}
+		pTrack = pTrack->next();
+	}
+}
+
+
+// Track lane tile cache: discard all tiles (lazily).
+void qtractorTrackView::invalidateTiles (void)
+{
+	++m_iTileGeneration;
+}
+
+
 // To have track view in v-sync with track list.
 void qtractorTrackView::contentsYMovingSlot ( int /*cx*/, int cy )
 {
@@ -30,6 +30,8 @@
 
 #include <QPixmap>
 #include <QBrush>
+#include <QCache>
+#include <QPair>
 
 
 // Forward declarations.
@@ -252,9 +254,22 @@ protected:
 	// Resize event handler.
 	void resizeEvent(QResizeEvent *pResizeEvent);
 
+	// Scroll area updater (override).
+	void scrollContentsBy(int dx, int dy);
+
 	// Draw the track view
 	void drawContents(QPainter *pPainter, const QRect& rect);
 
+	// Draw vertical grid lines (from contents x position).
+	void drawGrid(QPainter *pPainter, int cx, int w, int h) const;
+
+	// Track lane tile cache methods.
+	const QPixmap& trackTile(qtractorTrack *pTrack,
+		qtractorClip *pClip, int iColumn, int h);
+
+	void invalidateTiles(const QRect& rect);
+	void invalidateTiles();
+
 	// Track view state info.
 	struct TrackViewInfo
 	{
@@ -427,6 +442,26 @@ private:
 	// Local double-buffering pixmap.
 	QPixmap m_pixmap;
 
+	// Track lane tile cache, keyed by track and column,
+	// checked against the view/track state it was drawn with.
+	struct Tile
+	{
+		QPixmap        pixmap;
+		unsigned int   generation;
+		unsigned short zoom;
+		unsigned short ppb;
+		QRgb           color;
+		int            height;
+		unsigned int   flags;
+	};
+
+	typedef QPair<qtractorTrack *, int> TileKey;
+
+	QCache<TileKey, Tile> m_tiles;
+
+	unsigned int m_iTileGeneration;
+	bool m_bScrolling;
+
 	// To maintain the current track/clip positioning.
 	qtractorSessionCursor *m_pSessionCursor;
 
@@ -1679,8 +1679,8 @@ static VstIntPtr VSTCALLBACK qtractorVstPlugin_HostCallback ( AEffect *effect,
 		if (pSession) {
 			::memset(&s_vstTimeInfo, 0, sizeof(s_vstTimeInfo));
 			const unsigned long iPlayHead = pSession->playHead();
-			qtractorTimeScale::Cursor& cursor = pSession->timeScale()->cursor();
-			qtractorTimeScale::Node *pNode = cursor.seekFrame(iPlayHead);
+			qtractorTimeScale::SnapshotCursor cursor(pSession->timeScale());
+			const qtractorTimeScale::Node *pNode = cursor.seekFrame(iPlayHead);
 			s_vstTimeInfo.samplePos = double(iPlayHead);
 			s_vstTimeInfo.sampleRate = double(pSession->sampleRate());
 			s_vstTimeInfo.flags = 0;
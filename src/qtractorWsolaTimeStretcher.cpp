@@ -27,6 +27,10 @@
 #include <math.h>
 
 
+// Fast-seek normalization recompute period (in seek offsets).
+static const int c_iSeekNormPeriod = 256;
+
+
 // Cross-correlation value calculation over the overlap period.
 //
 
@@ -78,10 +82,6 @@ static inline float sse_cross_corr (
 	// No cheating allowed, use unaligned load & take the resulting
 	// performance hit. -- use _mm_loadu_ps() instead of _mm_load_ps();
 
-	// Ensure overlapLength is divisible by 8
-	// assert((m_iOverlapLength % 8) == 0);
-	iOverlapLength >>= 4;
-
 	// Calculates the cross-correlation value between 'pV1' and 'pV2' vectors
 	// Note: pV2 _must_ be aligned to 16-bit boundary, pV1 need not.
 	pVec2 = (__m128 *) pV2;
@@ -89,7 +89,8 @@ static inline float sse_cross_corr (
 	vNorm = _mm_setzero_ps();
 
 	// Unroll the loop by factor of 4 * 4 operations
-	for (unsigned int i = 0; i < iOverlapLength; ++i) {
+	unsigned int i = (iOverlapLength >> 4);
+	for (; i > 0; --i) {
 		// vCorr += pV1[0..3] * pV2[0..3]
 		vTemp = _mm_loadu_ps(pV1);
 		vCorr = _mm_add_ps(vCorr, _mm_mul_ps(vTemp, pVec2[0]));
@@ -113,15 +114,104 @@ static inline float sse_cross_corr (
 	float *pvNorm = (float *) &vNorm;
 	float fNorm = (pvNorm[0] + pvNorm[1] + pvNorm[2] + pvNorm[3]);
 
+	float *pvCorr = (float *) &vCorr;
+	float fCorr = (pvCorr[0] + pvCorr[1] + pvCorr[2] + pvCorr[3]);
+
+	// Remainder, if any (as in sse_dot_prod)...
+	pV2 = (const float *) pVec2;
+	for (i = (iOverlapLength & 15); i > 0; --i) {
+		fCorr += *pV1 * *pV2++;
+		fNorm += *pV1 * *pV1;
+		++pV1;
+	}
+
 	if (fNorm < 1e-9f) fNorm = 1.0f; // avoid div by zero
 
-	float *pvCorr = (float *) &vCorr;
-	return (pvCorr[0] + pvCorr[1] + pvCorr[2] + pvCorr[3]) / ::sqrtf(fNorm);
+	return fCorr / ::sqrtf(fNorm);
+}
+
+
+// SSE enabled dot-product version (correlation only).
+static inline float sse_dot_prod (
+	const float *pV1, const float *pV2, unsigned int iOverlapLength )
+{
+	__m128 vCorr0 = _mm_setzero_ps();
+	__m128 vCorr1 = _mm_setzero_ps();
+
+	// Note: pV2 _must_ be aligned to 16-bit boundary, pV1 need not.
+	const __m128 *pVec2 = (const __m128 *) pV2;
+
+	unsigned int i = (iOverlapLength >> 3);
+	for (; i > 0; --i) {
+		vCorr0 = _mm_add_ps(vCorr0, _mm_mul_ps(_mm_loadu_ps(pV1), pVec2[0]));
+		vCorr1 = _mm_add_ps(vCorr1, _mm_mul_ps(_mm_loadu_ps(pV1 + 4), pVec2[1]));
+		pV1 += 8;
+		pVec2 += 2;
+	}
+
+	vCorr0 = _mm_add_ps(vCorr0, vCorr1);
+
+	float *pvCorr = (float *) &vCorr0;
+	float fCorr = (pvCorr[0] + pvCorr[1] + pvCorr[2] + pvCorr[3]);
+
+	// Remainder, if any...
+	pV2 = (const float *) pVec2;
+	for (i = (iOverlapLength & 7); i > 0; --i)
+		fCorr += *pV1++ * *pV2++;
+
+	return fCorr;
+}
+
+#endif
+
+
+#if defined(__ARM_NEON__)
+
+#include "arm_neon.h"
+
+// NEON enabled dot-product version (correlation only).
+static inline float neon_dot_prod (
+	const float *pV1, const float *pV2, unsigned int iOverlapLength )
+{
+	float32x4_t vCorr0 = vdupq_n_f32(0.0f);
+	float32x4_t vCorr1 = vdupq_n_f32(0.0f);
+
+	unsigned int i = (iOverlapLength >> 3);
+	for (; i > 0; --i) {
+		vCorr0 = vmlaq_f32(vCorr0, vld1q_f32(pV1), vld1q_f32(pV2));
+		vCorr1 = vmlaq_f32(vCorr1, vld1q_f32(pV1 + 4), vld1q_f32(pV2 + 4));
+		pV1 += 8;
+		pV2 += 8;
+	}
+
+	vCorr0 = vaddq_f32(vCorr0, vCorr1);
+
+	float fCorr = vgetq_lane_f32(vCorr0, 0) + vgetq_lane_f32(vCorr0, 1)
+		+ vgetq_lane_f32(vCorr0, 2) + vgetq_lane_f32(vCorr0, 3);
+
+	// Remainder, if any...
+	for (i = (iOverlapLength & 7); i > 0; --i)
+		fCorr += *pV1++ * *pV2++;
+
+	return fCorr;
 }
 
 #endif
 
 
+// Sliding window energy (normalization term).
+static inline double seek_norm (
+	const float *pV1, unsigned int iOverlapLength )
+{
+	double fNorm = 0.0;
+
+	for (unsigned int i = 0; i < iOverlapLength; ++i)
+		fNorm += double(pV1[i]) * double(pV1[i]);
+
+	return fNorm;
+}
+
+
 // Standard (slow) version.
 static inline float std_cross_corr (
 	const float *pV1, const float *pV2, unsigned int iOverlapLength )
@@ -140,6 +230,19 @@ static inline float std_cross_corr (
 }
 
 
+// Standard dot-product version (correlation only).
+static inline float std_dot_prod (
+	const float *pV1, const float *pV2, unsigned int iOverlapLength )
+{
+	float fCorr = 0.0f;
+
+	for (unsigned int i = 0; i < iOverlapLength; ++i)
+		fCorr += pV1[i] * pV2[i];
+
+	return fCorr;
+}
+
+
 //---------------------------------------------------------------------------
 // qtractorWsolaTimeStretcher - Time-stretch (tempo change) effect for processed sound.
 //
@@ -153,21 +256,33 @@ qtractorWsolaTimeStretcher::qtractorWsolaTimeStretcher (
 
 	m_fTempo = 1.0f;
 	m_bQuickSeek = false;
+	m_bFastSeek = false;
 
 	m_bMidBufferDirty = false;
 	m_ppMidBuffer = NULL;
 	m_ppRefMidBuffer = NULL;
 	m_ppRefMidBufferUnaligned = NULL;
 	m_ppFrames = NULL;
+	m_pfSeekNorms = NULL;
 
 	m_iOverlapLength = 0;
 
 #if defined(__SSE__)
-	if (sse_enabled())
+	if (sse_enabled()) {
 		m_pfnCrossCorr = sse_cross_corr;
+		m_pfnDotProd = sse_dot_prod;
+	}
 	else
 #endif
+#if defined(__ARM_NEON__)
 	m_pfnCrossCorr = std_cross_corr;
+	m_pfnDotProd = neon_dot_prod;
+	if (false)
+#endif
+	{
+		m_pfnCrossCorr = std_cross_corr;
+		m_pfnDotProd = std_dot_prod;
+	}
 
 	setParameters(iSampleRate);
 }
@@ -185,6 +300,7 @@ qtractorWsolaTimeStretcher::~qtractorWsolaTimeStretcher (void)
 		delete [] m_ppRefMidBufferUnaligned;
 		delete [] m_ppRefMidBuffer;
 		delete [] m_ppFrames;
+		delete [] m_pfSeekNorms;
 	}
 }
 
@@ -258,6 +374,20 @@ bool qtractorWsolaTimeStretcher::isQuickSeek (void) const
 }
 
 
+// Set fast-seek mode (linear search with sliding-window
+// normalization and vectorized correlation only).
+void qtractorWsolaTimeStretcher::setFastSeek ( bool bFastSeek )
+{
+	m_bFastSeek = bFastSeek;
+}
+
+// Get fast-seek mode.
+bool qtractorWsolaTimeStretcher::isFastSeek (void) const
+{
+	return m_bFastSeek;
+}
+
+
 // Sets routine control parameters.
 // These control are certain time constants defining
 // how the sound is stretched to the desired duration.
@@ -387,6 +517,40 @@ unsigned int qtractorWsolaTimeStretcher::seekBestOverlapPosition (void)
 			}
 			iPrevBestOffs = iBestOffs;
 		}
+	} else if (m_bFastSeek) {
+		// Linear search, fast version: the normalization term is
+		// a sliding window energy, updated incrementally, so that
+		// only the correlation (dot-product) is computed in full...
+		for (i = 0; i < m_iChannels; ++i) {
+			m_pfSeekNorms[i] = seek_norm(
+				m_inputBuffer.ptrBegin(i), m_iOverlapLength);
+		}
+		iBestOffs = 0;
+		for (iOffs = 0; iOffs < (int) m_iSeekLength; ++iOffs) {
+			for (i = 0; i < m_iChannels; ++i) {
+				const float *pV1 = m_inputBuffer.ptrBegin(i) + iOffs;
+				float fNorm = float(m_pfSeekNorms[i]);
+				if (fNorm < 1e-9f) fNorm = 1.0f; // avoid div by zero
+				fCorr = (*m_pfnDotProd)(pV1,
+					m_ppRefMidBuffer[i], m_iOverlapLength) / ::sqrtf(fNorm);
+				// Checks for the highest correlation value.
+				if (fCorr > fBestCorr) {
+					fBestCorr = fCorr;
+					iBestOffs = iOffs;
+				}
+				// Slide the normalization window, recomputing
+				// it every so often, lest rounding errors drift...
+				if (((iOffs + 1) % c_iSeekNormPeriod) == 0) {
+					m_pfSeekNorms[i] = seek_norm(pV1 + 1, m_iOverlapLength);
+				} else {
+					const double fOld = pV1[0];
+					const double fNew = pV1[m_iOverlapLength];
+					m_pfSeekNorms[i] += fNew * fNew - fOld * fOld;
+					if (m_pfSeekNorms[i] < 0.0)
+						m_pfSeekNorms[i] = 0.0;
+				}
+			}
+		}
 	} else {
 		// Linear search...
 		iBestOffs = 0;
@@ -578,8 +742,10 @@ void qtractorWsolaTimeStretcher::calcOverlapLength (void)
 			delete [] m_ppRefMidBufferUnaligned;
 			delete [] m_ppRefMidBuffer;
 			delete [] m_ppFrames;
+			delete [] m_pfSeekNorms;
 		}
 		m_ppFrames = new float * [m_iChannels];
+		m_pfSeekNorms = new double [m_iChannels];
 		m_ppMidBuffer = new float * [m_iChannels];
 		m_ppRefMidBufferUnaligned = new float * [m_iChannels];
 		m_ppRefMidBuffer = new float * [m_iChannels];
@@ -63,6 +63,12 @@ public:
 	// Get quick-seek mode.
 	bool isQuickSeek() const;
 
+	// Set fast-seek mode (sliding normalization, vectorized).
+	void setFastSeek(bool bFastSeek);
+
+	// Get fast-seek mode.
+	bool isFastSeek() const;
+
 	// Default values for sound processing parameters.
 	enum {
 
@@ -183,6 +189,7 @@ private:
 
 	float m_fTempo;
 	bool  m_bQuickSeek;
+	bool  m_bFastSeek;
 
 	unsigned int m_iSampleRate;
 	unsigned int m_iSequenceMs;
@@ -197,6 +204,7 @@ private:
 	float **m_ppRefMidBuffer;
 	float **m_ppRefMidBufferUnaligned;
 	float **m_ppFrames;
+	double *m_pfSeekNorms;
 	unsigned int m_iOverlapLength;
 	unsigned int m_iSeekLength;
 	unsigned int m_iSeekWindowLength;
@@ -208,6 +216,9 @@ private:
 
 	// Calculates the cross-correlation value over the overlap period.
 	float (*m_pfnCrossCorr)(const float *, const float *, unsigned int);
+
+	// Calculates the correlation only (dot-product) over the overlap period.
+	float (*m_pfnDotProd)(const float *, const float *, unsigned int);
 };
 
 
@@ -43,6 +43,10 @@
 #include <QDir>
 #include <QHash>
 
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+
 #include <zlib.h>
 
 #include <sys/stat.h>
@@ -74,6 +78,10 @@
 
 #define BUFF_SIZE 16384
 
+// Parallel deflate block and (primed) dictionary sizes.
+#define BLOCK_SIZE (256 << 10)
+#define DICT_SIZE  32768
+
 
 static inline unsigned int read_uint ( const unsigned char *data )
 {
@@ -287,6 +295,197 @@ static void copy_header ( LocalFileHeader& lfh, const CentralFileHeader& h )
 }
 
 
+// Compression level by file type: already compressed media
+// is just stored (-1), plain PCM audio gets the fastest level.
+static int deflate_level ( const QString& sFilename )
+{
+	static const char *s_store[] = {
+		"flac", "ogg", "oga", "opus", "mp3", "mp4", "m4a", "aac",
+		"wv", "zip", "qtz", "gz", "bz2", "xz", "7z",
+		"png", "jpg", "jpeg", NULL };
+	static const char *s_fast[] = {
+		"wav", "wave", "w64", "rf64", "aif", "aiff", "aifc",
+		"caf", "au", "snd", "raw", NULL };
+
+	const QString& sSuffix = QFileInfo(sFilename).suffix().toLower();
+	int i;
+	for (i = 0; s_store[i]; ++i) {
+		if (sSuffix == s_store[i])
+			return -1;
+	}
+	for (i = 0; s_fast[i]; ++i) {
+		if (sSuffix == s_fast[i])
+			return Z_BEST_SPEED;
+	}
+
+	return Z_DEFAULT_COMPRESSION;
+}
+
+
+//----------------------------------------------------------------------------
+// qtractorZipDeflater -- Parallel block deflate thread pool.
+//
+// Entries are split in fixed size blocks, each one deflated on its own,
+// primed with the previous input tail as dictionary and flushed to a byte
+// boundary (Z_SYNC_FLUSH), so that they concatenate in one single raw
+// deflate stream, in the very same order they were read in.
+//
+
+struct qtractorZipBlock
+{
+	QByteArray data;
+	QByteArray dict;
+	QByteArray zdata;
+	unsigned int crc_32;
+	int  level;
+	bool last;
+	bool done;
+};
+
+
+static void deflate_block ( qtractorZipBlock *pBlock )
+{
+	z_stream zstream;
+	::memset(&zstream, 0, sizeof(zstream));
+	::deflateInit2(&zstream, pBlock->level,
+		Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+
+	if (!pBlock->dict.isEmpty()) {
+		::deflateSetDictionary(&zstream,
+			(const Bytef *) pBlock->dict.constData(),
+			(uInt) pBlock->dict.size());
+	}
+
+	const int zflush = (pBlock->last ? Z_FINISH : Z_SYNC_FLUSH);
+
+	zstream.next_in  = (Bytef *) pBlock->data.data();
+	zstream.avail_in = (uInt) pBlock->data.size();
+
+	pBlock->zdata.resize(::deflateBound(&zstream, pBlock->data.size()) + 16);
+	do {
+		if (zstream.total_out >= (uLong) pBlock->zdata.size())
+			pBlock->zdata.resize(pBlock->zdata.size() + BUFF_SIZE);
+		zstream.next_out  = (Bytef *) pBlock->zdata.data() + zstream.total_out;
+		zstream.avail_out = (uInt) (pBlock->zdata.size() - zstream.total_out);
+		if (::deflate(&zstream, zflush) == Z_STREAM_ERROR)
+			break;
+	}
+	while (zstream.avail_out == 0);
+
+	pBlock->zdata.resize(zstream.total_out);
+	::deflateEnd(&zstream);
+
+	pBlock->crc_32 = ::crc32(0,
+		(const Bytef *) pBlock->data.constData(),
+		(uInt) pBlock->data.size());
+}
+
+
+class qtractorZipDeflater;
+
+class qtractorZipDeflateThread : public QThread
+{
+public:
+
+	qtractorZipDeflateThread(qtractorZipDeflater *pDeflater)
+		: QThread(), m_pDeflater(pDeflater) {}
+
+protected:
+
+	void run();
+
+private:
+
+	qtractorZipDeflater *m_pDeflater;
+};
+
+
+class qtractorZipDeflater
+{
+public:
+
+	qtractorZipDeflater(int iThreads) : m_bRunState(true)
+	{
+		for (int i = 0; i < iThreads; ++i) {
+			qtractorZipDeflateThread *pThread
+				= new qtractorZipDeflateThread(this);
+			m_threads.append(pThread);
+			pThread->start();
+		}
+	}
+
+	~qtractorZipDeflater()
+	{
+		m_mutex.lock();
+		m_bRunState = false;
+		m_cond.wakeAll();
+		m_mutex.unlock();
+		QListIterator<qtractorZipDeflateThread *> iter(m_threads);
+		while (iter.hasNext()) {
+			qtractorZipDeflateThread *pThread = iter.next();
+			pThread->wait();
+			delete pThread;
+		}
+		m_threads.clear();
+	}
+
+	int threads() const { return m_threads.count(); }
+
+	// Block queue executives (caller side).
+	void enqueue(qtractorZipBlock *pBlock)
+	{
+		QMutexLocker locker(&m_mutex);
+		pBlock->done = false;
+		m_queue.append(pBlock);
+		m_cond.wakeOne();
+	}
+
+	void wait(qtractorZipBlock *pBlock)
+	{
+		QMutexLocker locker(&m_mutex);
+		while (!pBlock->done)
+			m_done.wait(&m_mutex);
+	}
+
+	// Block queue executives (thread side).
+	qtractorZipBlock *take()
+	{
+		QMutexLocker locker(&m_mutex);
+		while (m_bRunState && m_queue.isEmpty())
+			m_cond.wait(&m_mutex);
+		return (m_queue.isEmpty() ? NULL : m_queue.takeFirst());
+	}
+
+	void done(qtractorZipBlock *pBlock)
+	{
+		QMutexLocker locker(&m_mutex);
+		pBlock->done = true;
+		m_done.wakeAll();
+	}
+
+private:
+
+	QMutex m_mutex;
+	QWaitCondition m_cond;
+	QWaitCondition m_done;
+
+	QList<qtractorZipBlock *> m_queue;
+	QList<qtractorZipDeflateThread *> m_threads;
+
+	bool m_bRunState;
+};
+
+
+void qtractorZipDeflateThread::run (void)
+{
+	qtractorZipBlock *pBlock;
+	while ((pBlock = m_pDeflater->take()) != NULL) {
+		deflate_block(pBlock);
+		m_pDeflater->done(pBlock);
+	}
+}
+
+
 //----------------------------------------------------------------------------
 // qtractorZipDevice  -- Common ZIP I/O device class.
 //
@@ -304,7 +503,8 @@ public:
 			total_processed(0),
 			buff_read(new unsigned char [BUFF_SIZE]),
 			buff_write(new unsigned char [BUFF_SIZE]),
-			write_offset(0)
+			write_offset(0),
+			deflater(NULL)
 	{
 	#ifdef QTRACTOR_PROGRESS_BAR
 		qtractorMainForm *pMainForm = qtractorMainForm::getInstance();
@@ -351,6 +551,7 @@ public:
 	unsigned char *buff_read;
 	unsigned char *buff_write;
 	unsigned int write_offset;
+	qtractorZipDeflater *deflater;
 #ifdef QTRACTOR_PROGRESS_BAR
 	QProgressBar *progress_bar;
 #endif
@@ -561,10 +762,31 @@ bool qtractorZipDevice::extractEntry (
 		if (crc_32 != read_uint(lfh.crc_32))
 			qWarning("qtractorZipDevice::extractEntry: bad CRC32!");
 	} else {
-		// No compression...
-		QByteArray data = device->read(compressed_size);
-		data.truncate(uncompressed_size);
-		pFile->write(data);
+		// No compression, stream it as is...
+		unsigned int nread = 0;
+		unsigned int crc_32 = ::crc32(0, 0, 0);
+		const unsigned int nsize = qMin(compressed_size, uncompressed_size);
+		while (nread < nsize) {
+			unsigned int nbuff = BUFF_SIZE;
+			if (nread + BUFF_SIZE > nsize)
+				nbuff = nsize - nread;
+			const int nbuff2 = device->read((char *) buff_read, nbuff);
+			if (nbuff2 < 1)
+				break;
+			nbuff = nbuff2;
+			pFile->write((const char *) buff_read, nbuff);
+			crc_32 = ::crc32(crc_32,
+				(const uchar *) buff_read,
+				(ulong) nbuff);
+			nread += nbuff;
+			total_processed += nbuff;
+		#ifdef QTRACTOR_PROGRESS_BAR
+			if (progress_bar) progress_bar->setValue(
+				(100.0f * float(total_processed)) / float(total_uncompressed));
+		#endif
+		}
+		if (crc_32 != read_uint(lfh.crc_32))
+			qWarning("qtractorZipDevice::extractEntry: bad CRC32!");
 	}
 
 	pFile->setPermissions(permissions_from_mode(S_IRUSR | S_IWUSR | mode));
@@ -779,50 +1001,86 @@ bool qtractorZipDevice::processEntry ( const QString& sFilename, FileHeader& fh
 
 	unsigned int crc_32 = ::crc32(0, 0, 0);
 
-	if (pFile) {
-		write_ushort(fh.h.compression_method, 8); /* DEFERRED */
-		unsigned int nread  = 0;
-		unsigned int nwrite = 0;
-		z_stream zstream;
-		::memset(&zstream, 0, sizeof(zstream));
-		int zrc = ::deflateInit2(&zstream,
-			Z_DEFAULT_COMPRESSION,
-			Z_DEFLATED, -MAX_WBITS, 8,
-			Z_DEFAULT_STRATEGY);
-		while (zrc != Z_STREAM_END) {
+	const int level = (pFile ? deflate_level(sFilename) : -1);
+
+	if (pFile && level < 0) {
+		// No compression, stream it as is...
+		unsigned int nread = 0;
+		while (nread < uncompressed_size) {
 			unsigned int nbuff = BUFF_SIZE;
 			if (nread + BUFF_SIZE > uncompressed_size)
 				nbuff = uncompressed_size - nread;
-			const int zflush = (nbuff < BUFF_SIZE ? Z_FINISH : Z_NO_FLUSH);
-			pFile->read((char *) buff_read, nbuff);
+			const int nbuff2 = pFile->read((char *) buff_read, nbuff);
+			if (nbuff2 < 1)
+				break;
+			nbuff = nbuff2;
 			crc_32 = ::crc32(crc_32,
 				(const uchar *) buff_read,
 				(ulong) nbuff);
+			device->write((const char *) buff_read, nbuff);
 			nread += nbuff;
 			total_processed += nbuff;
-			zstream.next_in  = (uchar *) buff_read;
-			zstream.avail_in = (uint) nbuff;
-			do {
-				nbuff = BUFF_SIZE;
-				zstream.next_out  = (uchar *) buff_write;
-				zstream.avail_out = (uint) nbuff;
-				zrc = ::deflate(&zstream, zflush);
-				if (zrc != Z_STREAM_ERROR) {
-					nbuff -= zstream.avail_out;
-					if (nbuff > 0) {
-						device->write((const char *) buff_write, nbuff);
-						nwrite += nbuff;
-					}
+		#ifdef QTRACTOR_PROGRESS_BAR
+			if (progress_bar) progress_bar->setValue(
+				(100.0f * float(total_processed)) / float(total_uncompressed));
+		#endif
+		}
+		compressed_size = nread;
+		pFile->close();
+		delete pFile;
+	}
+	else
+	if (pFile) {
+		write_ushort(fh.h.compression_method, 8); /* DEFERRED */
+		// Keep a bounded number of blocks in flight...
+		const int iMaxBlocks = (deflater ? 2 * deflater->threads() : 1);
+		QList<qtractorZipBlock *> blocks;
+		QByteArray dict;
+		unsigned int nread  = 0;
+		unsigned int nwrite = 0;
+		bool last = false;
+		while (!last || !blocks.isEmpty()) {
+			// Read ahead and queue next blocks...
+			while (!last && blocks.count() < iMaxBlocks) {
+				unsigned int nbuff = BLOCK_SIZE;
+				if (nread + BLOCK_SIZE > uncompressed_size)
+					nbuff = uncompressed_size - nread;
+				qtractorZipBlock *pBlock = new qtractorZipBlock;
+				pBlock->data  = pFile->read(nbuff);
+				pBlock->dict  = dict;
+				pBlock->level = level;
+				nread += pBlock->data.size();
+				last = (nread >= uncompressed_size
+					|| (unsigned int) pBlock->data.size() < nbuff);
+				pBlock->last  = last;
+				if (!last) {
+					dict.append(pBlock->data);
+					dict = dict.right(DICT_SIZE);
+				}
+				if (deflater) {
+					deflater->enqueue(pBlock);
+				} else {
+					deflate_block(pBlock);
+					pBlock->done = true;
 				}
+				blocks.append(pBlock);
 			}
-			while (zstream.avail_out == 0);
+			// Write out the oldest block, in order...
+			qtractorZipBlock *pBlock = blocks.takeFirst();
+			if (deflater)
+				deflater->wait(pBlock);
+			device->write(pBlock->zdata);
+			nwrite += pBlock->zdata.size();
+			crc_32 = ::crc32_combine(crc_32,
+				pBlock->crc_32, pBlock->data.size());
+			total_processed += pBlock->data.size();
+			delete pBlock;
 		#ifdef QTRACTOR_PROGRESS_BAR
 			if (progress_bar) progress_bar->setValue(
 				(100.0f * float(total_processed)) / float(total_uncompressed));
 		#endif
 		}
 		compressed_size = nwrite;
-		::deflateEnd(&zstream);
 		pFile->close();
 		delete pFile;
 	}
@@ -866,6 +1124,16 @@ bool qtractorZipDevice::processAll (void)
 
 	int iProcessed = 0;
 
+	// Deflate across all available cores...
+	const int iThreads = QThread::idealThreadCount();
+	if (iThreads > 1)
+		deflater = new qtractorZipDeflater(iThreads);
+
+#ifdef CONFIG_DEBUG
+	QTime time;
+	time.start();
+#endif
+
 	QHash<QString, FileHeader>::Iterator iter = file_headers.begin();
 	const QHash<QString, FileHeader>::Iterator& iter_end = file_headers.end();
 	for ( ; iter != iter_end; ++iter) {
@@ -874,6 +1142,18 @@ bool qtractorZipDevice::processAll (void)
 		++iProcessed;
 	}
 
+#ifdef CONFIG_DEBUG
+	const int msecs = time.elapsed();
+	qDebug("qtractorZipDevice::processAll: %u bytes in %d msecs (%g MB/s).",
+		total_processed, msecs, (msecs > 0
+			? float(total_processed) / (1048.576f * float(msecs)) : 0.0f));
+#endif
+
+	if (deflater) {
+		delete deflater;
+		deflater = NULL;
+	}
+
 #ifdef QTRACTOR_PROGRESS_BAR
 	if (progress_bar)
 		progress_bar->hide();
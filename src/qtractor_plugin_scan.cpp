@@ -942,7 +942,12 @@ int main ( int argc, char **argv )
 				qtractor_vst_scan_file(sFilename);
 			else
 		#endif
-			break;
+			{
+				// Unknown plugin type: bail out...
+				break;
+			}
+			// Must always tell when done with each file...
+			QTextStream(stdout) << "qtractor_plugin_scan: done.\n";
 		}
 	}
 #ifdef CONFIG_DEBUG
@@ -18,12 +18,15 @@ HEADERS += config.h \
 	qtractorAudioConnect.h \
 	qtractorAudioEngine.h \
 	qtractorAudioFile.h \
+	qtractorAudioGraph.h \
 	qtractorAudioListView.h \
 	qtractorAudioMadFile.h \
 	qtractorAudioMeter.h \
 	qtractorAudioMonitor.h \
+	qtractorAudioPageCache.h \
 	qtractorAudioPeak.h \
 	qtractorAudioSndFile.h \
+	qtractorAudioStretchCache.h \
 	qtractorAudioVorbisFile.h \
 	qtractorClip.h \
 	qtractorClipCommand.h \
@@ -41,6 +44,7 @@ HEADERS += config.h \
 	qtractorDssiPlugin.h \
 	qtractorEngine.h \
 	qtractorEngineCommand.h \
+	qtractorEpoch.h \
 	qtractorFifoBuffer.h \
 	qtractorFileList.h \
 	qtractorFileListView.h \
@@ -151,12 +155,15 @@ SOURCES += \
 	qtractorAudioConnect.cpp \
 	qtractorAudioEngine.cpp \
 	qtractorAudioFile.cpp \
+	qtractorAudioGraph.cpp \
 	qtractorAudioListView.cpp \
 	qtractorAudioMadFile.cpp \
 	qtractorAudioMeter.cpp \
 	qtractorAudioMonitor.cpp \
+	qtractorAudioPageCache.cpp \
 	qtractorAudioPeak.cpp \
 	qtractorAudioSndFile.cpp \
+	qtractorAudioStretchCache.cpp \
 	qtractorAudioVorbisFile.cpp \
 	qtractorClip.cpp \
 	qtractorClipCommand.cpp \
@@ -173,6 +180,7 @@ SOURCES += \
 	qtractorDssiPlugin.cpp \
 	qtractorEngine.cpp \
 	qtractorEngineCommand.cpp \
+	qtractorEpoch.cpp \
 	qtractorFileList.cpp \
 	qtractorFileListView.cpp \
 	qtractorFiles.cpp \